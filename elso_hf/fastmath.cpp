@@ -0,0 +1,223 @@
+#include "fastmath.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "../harmadik-hf/simd_kernels.h"
+
+namespace {
+
+constexpr int max_terms = 20;
+
+// Taylor coefficients of exp, cos (in r^2) and sin / r (in r^2)
+struct Series {
+    std::array<double, max_terms> exp{}, cos{}, sin{};
+};
+
+constexpr Series make_series() {
+    Series s;
+    double fact = 1.0;  // n!, exact up to 22!
+    for (int n = 0; n < max_terms; ++n) {
+        if (n > 0) fact *= n;
+        s.exp[n] = 1.0 / fact;
+    }
+    fact = 1.0;
+    for (int n = 0; n < max_terms; ++n) {
+        if (n > 0) fact *= (2.0 * n - 1.0) * (2.0 * n);
+        double sign = n % 2 ? -1.0 : 1.0;
+        s.cos[n] = sign / fact;
+        s.sin[n] = sign / (fact * (2.0 * n + 1.0));
+    }
+    return s;
+}
+
+constexpr Series series = make_series();
+
+// c[N] + c[N+1] r + ... + c[D] r^(D-N), unrolled at compile time
+template<int D, int N = 0>
+inline double horner(std::array<double, max_terms> const& c, double r) {
+    if constexpr (N == D)
+        return c[D];
+    else
+        return c[N] + r * horner<D, N + 1>(c, r);
+}
+
+// Polynomial degrees per tier (truncation error below math_accuracy_bound on the reduced range)
+template<MathAccuracy A> struct Degrees;
+template<> struct Degrees<MathAccuracy::low> { static constexpr int exp = 4, cos = 3, sin = 2; };
+template<> struct Degrees<MathAccuracy::medium> { static constexpr int exp = 7, cos = 5, sin = 4; };
+template<> struct Degrees<MathAccuracy::full> { static constexpr int exp = 13, cos = 8, sin = 8; };
+
+inline std::uint64_t to_bits(double v) {
+    std::uint64_t b;
+    std::memcpy(&b, &v, sizeof b);
+    return b;
+}
+
+inline double from_bits(std::uint64_t b) {
+    double v;
+    std::memcpy(&v, &b, sizeof v);
+    return v;
+}
+
+/*
+ Adding 1.5 * 2^52 rounds to an integer k that ends up in the low mantissa
+ bits, so k is available both as a double and as an integer without a
+ (non-vectorizable on AVX2) double -> int64 conversion
+*/
+constexpr double round_shifter = 6755399441055744.0;
+
+// ln2 split so that k * ln2_hi is exact for |k| < 2^11
+constexpr double ln2_hi = 6.93147180369123816490e-01;
+constexpr double ln2_lo = 1.90821492927058770002e-10;
+constexpr double log2e = 1.44269504088896338700e+00;
+
+template<MathAccuracy A>
+inline double exp_kernel(double x) {
+    // Beyond these exp is inf / 0; the clamp keeps k in range, NaN passes through
+    x = x < -746.0 ? -746.0 : x;
+    x = x > 710.0 ? 710.0 : x;
+    double t = x * log2e + round_shifter;
+    double k = t - round_shifter;
+    double r = (x - k * ln2_hi) - k * ln2_lo;
+    // 1 + r added last, so the leading terms are rounded once
+    double p = 1.0 + (r + r * r * horner<Degrees<A>::exp, 2>(series.exp, r));
+    // 2^k as two factors, so that subnormal results and k = 1024 need no special case
+    auto ki = static_cast<std::int64_t>(to_bits(t) - to_bits(round_shifter));
+    std::int64_t k1 = ki >> 1, k2 = ki - k1;
+    double s1 = from_bits(static_cast<std::uint64_t>(k1 + 1023) << 52);
+    double s2 = from_bits(static_cast<std::uint64_t>(k2 + 1023) << 52);
+    return p * s1 * s2;
+}
+
+// pi/2 in three 33-bit parts and a tail (fdlibm); k * pio2_n is exact for |k| < 2^20
+constexpr double pio2_1 = 1.57079632673412561417e+00;
+constexpr double pio2_2 = 6.07710050630396597660e-11;
+constexpr double pio2_3 = 2.02226624871116645580e-21;
+constexpr double pio2_3t = 8.47842766036889956997e-32;
+constexpr double two_over_pi = 6.36619772367581382433e-01;
+
+// Valid for |x| <= cos_reduction_limit; larger arguments are patched by the callers
+template<MathAccuracy A>
+inline double cos_kernel(double x) {
+    double t = x * two_over_pi + round_shifter;
+    double k = t - round_shifter;
+    double r = x - k * pio2_1;
+    r -= k * pio2_2;
+    r -= k * pio2_3;
+    r -= k * pio2_3t;
+    double s = r * r;
+    // 1 - s/2 and r are the exact leading terms, the rest is a small correction (fdlibm's trick)
+    double hs = 0.5 * s, w = 1.0 - hs;
+    double c = w + (((1.0 - w) - hs) + s * s * horner<Degrees<A>::cos, 2>(series.cos, s));
+    double sn = r + r * s * horner<Degrees<A>::sin, 1>(series.sin, s);
+    // cos(k pi/2 + r) by quadrant: cos r, -sin r, -cos r, sin r
+    std::uint64_t q = to_bits(t);
+    double v = (q & 1) ? sn : c;
+    return ((q + 1) & 2) ? -v : v;
+}
+
+template<MathAccuracy A>
+inline double cos_scalar(double x) {
+    return std::abs(x) > cos_reduction_limit ? std::cos(x) : cos_kernel<A>(x);
+}
+
+/*
+ exp(-x^2): rounding x^2 alone costs up to x^2 / 2 ulp in the result, so
+ the full tier splits x^2 = hi + lo exactly (Dekker's product) and uses
+ exp(-hi - lo) = exp(-hi) (1 - lo). Valid for |x| <= cos_reduction_limit.
+*/
+template<MathAccuracy A>
+inline double gauss_kernel(double x) {
+    if constexpr (A == MathAccuracy::full) {
+        constexpr double split = 134217729.0;  // 2^27 + 1
+        double hi = x * x;
+        double c = split * x;
+        double xh = c - (c - x), xl = x - xh;
+        double lo = ((xh * xh - hi) + 2.0 * xh * xl) + xl * xl;
+        return exp_kernel<A>(-hi) * (1.0 - lo);
+    } else {
+        return exp_kernel<A>(-x * x);
+    }
+}
+
+template<MathAccuracy A>
+inline double gauss_cos_scalar(double x) {
+    if (std::abs(x) > cos_reduction_limit) return exp_kernel<A>(-x * x) * std::cos(x);
+    return gauss_kernel<A>(x) * cos_kernel<A>(x);
+}
+
+/*
+ y[i] = kernel(x[i]) in blocks: the loop is vectorized for the selected
+ instruction set, then the arguments outside the reduction range of cos
+ are recomputed by fix() (nullptr: no fix-up). The block result is kept
+ locally until then, so x and y may alias.
+*/
+template<typename K, typename Fix>
+void apply(const double* x, double* y, std::size_t n, K kernel, Fix fix) {
+    constexpr std::size_t block = 256;
+    matrix_kernels::simd_dispatch([&] {
+        alignas(64) double out[block];
+        for (std::size_t i0 = 0; i0 < n; i0 += block) {
+            std::size_t m = std::min(block, n - i0);
+            const double* xb = x + i0;
+            for (std::size_t i = 0; i < m; ++i) out[i] = kernel(xb[i]);
+            if constexpr (!std::is_null_pointer_v<Fix>) {
+                bool large = false;
+                for (std::size_t i = 0; i < m; ++i) large |= std::abs(xb[i]) > cos_reduction_limit;
+                if (large)
+                    for (std::size_t i = 0; i < m; ++i)
+                        if (std::abs(xb[i]) > cos_reduction_limit) out[i] = fix(xb[i]);
+            }
+            std::memcpy(y + i0, out, m * sizeof(double));
+        }
+    });
+}
+
+template<typename F>
+decltype(auto) by_tier(MathAccuracy a, F&& f) {
+    switch (a) {
+    case MathAccuracy::low: return f(std::integral_constant<MathAccuracy, MathAccuracy::low>{});
+    case MathAccuracy::medium: return f(std::integral_constant<MathAccuracy, MathAccuracy::medium>{});
+    default: return f(std::integral_constant<MathAccuracy, MathAccuracy::full>{});
+    }
+}
+
+} // namespace
+
+double fast_exp(double x, MathAccuracy a) {
+    return by_tier(a, [x](auto tier) { return exp_kernel<decltype(tier)::value>(x); });
+}
+
+double fast_cos(double x, MathAccuracy a) {
+    return by_tier(a, [x](auto tier) { return cos_scalar<decltype(tier)::value>(x); });
+}
+
+double fast_gauss_cos(double x, MathAccuracy a) {
+    return by_tier(a, [x](auto tier) { return gauss_cos_scalar<decltype(tier)::value>(x); });
+}
+
+void fast_exp(const double* x, double* y, std::size_t n, MathAccuracy a) {
+    by_tier(a, [&](auto tier) {
+        constexpr MathAccuracy A = decltype(tier)::value;
+        apply(x, y, n, [](double v) { return exp_kernel<A>(v); }, nullptr);
+    });
+}
+
+void fast_cos(const double* x, double* y, std::size_t n, MathAccuracy a) {
+    by_tier(a, [&](auto tier) {
+        constexpr MathAccuracy A = decltype(tier)::value;
+        apply(x, y, n, [](double v) { return cos_kernel<A>(v); }, [](double v) { return std::cos(v); });
+    });
+}
+
+void fast_gauss_cos(const double* x, double* y, std::size_t n, MathAccuracy a) {
+    by_tier(a, [&](auto tier) {
+        constexpr MathAccuracy A = decltype(tier)::value;
+        apply(x, y, n, [](double v) { return gauss_kernel<A>(v) * cos_kernel<A>(v); },
+              [](double v) { return gauss_cos_scalar<A>(v); });
+    });
+}
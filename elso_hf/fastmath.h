@@ -0,0 +1,143 @@
+#ifndef fastmath_own
+#define fastmath_own
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include "math_hw.h"
+
+/*
+ Range-reduced exp and cos with selectable accuracy
+
+   fast_exp(x, MathAccuracy::medium);
+   fast_gauss_cos(x, y, n, MathAccuracy::full);   // y[i] = exp(-x[i]^2) cos(x[i])
+
+ Unlike the Padé approximants of math_hw.h, these are accurate on the
+ whole double range:
+   exp: x = k ln2 + r, |r| <= ln2/2 (Cody-Waite), exp(x) = 2^k p(r)
+   cos: x = k pi/2 + r, |r| <= pi/4 (three-part pi/2), then cos or sin of r
+        with the sign of quadrant k mod 4
+ The tiers only differ in the degree of the Taylor polynomials in r, so a
+ lower tier is simply fewer multiply-adds. Relative error bounds:
+   low ~1e-4, medium ~1e-8, full ~1 ulp (math_accuracy_bound() allows 2).
+ fast_gauss_cos takes the exact x^2 in the full tier, so the error of the
+ product stays a few ulp also where x^2 is large.
+ exp returns inf / 0 past the overflow / underflow limits and propagates
+ NaN; cos falls back to std::cos for |x| > cos_reduction_limit, where the
+ three-part reduction is no longer exact.
+
+ The array versions are vectorized like math_hw.h (AVX2 / AVX-512 chosen
+ at run time); x and y may be the same array.
+*/
+
+enum class MathAccuracy { low, medium, full };
+
+constexpr double math_accuracy_bound(MathAccuracy a) {
+    return a == MathAccuracy::low ? 1e-4 : a == MathAccuracy::medium ? 1e-8 : 4e-16;
+}
+
+// |x| above which fast_cos calls std::cos
+constexpr double cos_reduction_limit = 1e6;
+
+double fast_exp(double x, MathAccuracy a = MathAccuracy::full);
+double fast_cos(double x, MathAccuracy a = MathAccuracy::full);
+double fast_gauss_cos(double x, MathAccuracy a = MathAccuracy::full);
+
+void fast_exp(const double* x, double* y, std::size_t n, MathAccuracy a = MathAccuracy::full);
+void fast_cos(const double* x, double* y, std::size_t n, MathAccuracy a = MathAccuracy::full);
+void fast_gauss_cos(const double* x, double* y, std::size_t n, MathAccuracy a = MathAccuracy::full);
+
+/*
+ Error measurement
+
+   MathErrorStats s = measure_error(
+       [](const double* x, double* y, std::size_t n) { fast_exp(x, y, n); },
+       [](long double x) { return std::exp(x); }, -700.0, 700.0, 1000000, 1000000);
+
+ f (scalar or batched, as for integrate()) is compared with reference on
+ grid_points equally spaced points of [lo, hi] (both ends included) and on
+ random_points uniformly random ones. The reference is evaluated in long
+ double, so with an accurate long double libm the ulp errors are measured
+ against (nearly) exact values rather than against std::exp/std::cos.
+ Points where the reference is not finite are compared for equality only.
+*/
+struct MathErrorStats {
+    double max_rel_error = 0.0;
+    double max_ulp_error = 0.0;
+    double mean_ulp_error = 0.0;
+    double worst_x = 0.0;      // argument of max_ulp_error
+    long long samples = 0;
+    long long mismatches = 0;  // non-finite reference not reproduced
+};
+
+namespace fastmath_detail {
+
+inline double ulp_of(double v) {
+    v = std::abs(v);
+    if (v == 0.0) return std::numeric_limits<double>::denorm_min();
+    return std::nextafter(v, std::numeric_limits<double>::infinity()) - v;
+}
+
+template<typename F, typename R>
+void accumulate(F& f, R& reference, std::vector<double> const& x, MathErrorStats& s, long double& ulp_sum,
+                long long& finite) {
+    std::vector<double> y(x.size());
+    if constexpr (std::is_invocable_v<F&, const double*, double*, std::size_t>)
+        f(x.data(), y.data(), x.size());
+    else
+        for (std::size_t i = 0; i < x.size(); ++i) y[i] = f(x[i]);
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        long double ref = reference(static_cast<long double>(x[i]));
+        double rd = static_cast<double>(ref);
+        ++s.samples;
+        if (!std::isfinite(rd)) {
+            if (!(y[i] == rd || (std::isnan(y[i]) && std::isnan(rd)))) ++s.mismatches;
+            continue;
+        }
+        long double diff = std::abs(static_cast<long double>(y[i]) - ref);
+        double ulp = static_cast<double>(diff / ulp_of(rd));
+        if (std::abs(rd) >= std::numeric_limits<double>::min())  // subnormals have no relative accuracy
+            s.max_rel_error = std::max(s.max_rel_error, static_cast<double>(diff / std::abs(ref)));
+        if (!(ulp <= s.max_ulp_error)) {  // also catches NaN results
+            s.max_ulp_error = std::isnan(ulp) ? std::numeric_limits<double>::infinity() : ulp;
+            s.worst_x = x[i];
+        }
+        ulp_sum += ulp;
+        ++finite;
+    }
+}
+
+} // namespace fastmath_detail
+
+template<typename F, typename R>
+MathErrorStats measure_error(F&& f, R&& reference, double lo, double hi, long long grid_points,
+                             long long random_points, unsigned seed = 1) {
+    constexpr long long block = 1 << 16;
+    MathErrorStats s;
+    long double ulp_sum = 0.0L;
+    long long finite = 0;
+    std::vector<double> x;
+    for (long long i0 = 0; i0 < grid_points; i0 += block) {
+        long long i1 = std::min(grid_points, i0 + block);
+        x.resize(static_cast<std::size_t>(i1 - i0));
+        for (long long i = i0; i < i1; ++i)
+            x[i - i0] = grid_points > 1 ? lo + (hi - lo) * static_cast<double>(i) / static_cast<double>(grid_points - 1) : lo;
+        fastmath_detail::accumulate(f, reference, x, s, ulp_sum, finite);
+    }
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> dist(lo, hi);
+    for (long long i0 = 0; i0 < random_points; i0 += block) {
+        x.resize(static_cast<std::size_t>(std::min(random_points - i0, block)));
+        for (double& v : x) v = dist(rng);
+        fastmath_detail::accumulate(f, reference, x, s, ulp_sum, finite);
+    }
+    if (finite > 0) s.mean_ulp_error = static_cast<double>(ulp_sum / finite);
+    return s;
+}
+
+#endif
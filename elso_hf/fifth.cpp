@@ -1,5 +1,9 @@
 #include <iostream>
 #include <cmath>
+#include <vector>
+#include "simpson.h"
+#include "integrate_batch.h"
+#include "../harmadik-hf/numerics_c.h"  // exported from libnumerics
 
 extern "C" {
     // Function
@@ -7,24 +11,17 @@ extern "C" {
         return exp(-x_f * x_f) * cos(x_f);
     }
 
-    // Simpson's rule
+    // Simpson's rule (parallel, compensated; see simpson.h)
     double integrate(int n, double x0, double x1) {
-        if (n % 2 != 0) {  // Simpson's rule requires an even number of intervals
-            ++n;
-        }
-
-        double dx = (x1 - x0) / n;
-        double int_value = func(x0) + func(x1);
-
-        for (int i = 1; i < n; i += 2) {
-            int_value += 4 * func(x0 + i * dx);
-        }
-
-        for (int i = 2; i < n - 1; i += 2) {
-            int_value += 2 * func(x0 + i * dx);
-        }
+        return integrate([](double x) { return func(x); }, x0, x1, static_cast<long long>(n));
+    }
 
-        int_value *= dx / 3.0;
-        return int_value;
+    // Simpson's rule on [x0[k], x1[k]] into out[k], k < count, with n[k] intervals, or n_all for every one if n is NULL (see integrate_batch.h)
+    void integrate_batch(int count, const double* x0, const double* x1, const int* n, int n_all, double* out) {
+        if (count <= 0) return;
+        std::vector<long long> nodes(static_cast<std::size_t>(count), static_cast<long long>(n_all));
+        if (n)
+            for (int k = 0; k < count; ++k) nodes[k] = n[k];
+        integrate_batch([](double x) { return func(x); }, x0, x1, nodes.data(), out, static_cast<std::size_t>(count));
     }
-}
\ No newline at end of file
+}
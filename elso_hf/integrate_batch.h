@@ -0,0 +1,119 @@
+#ifndef integrate_batch_own
+#define integrate_batch_own
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "simpson.h"
+
+/*
+ Simpson's rule on many intervals in one pass
+
+   std::vector<double> r(count);
+   integrate_batch(f, x0.data(), x1.data(), n.data(), r.data(), count);   // n intervals each
+   integrate_batch(f, x0.data(), x1.data(), 1000, r.data(), count);       // same n for all
+
+ The same integrand is integrated over count intervals [x0[k], x1[k]],
+ the results are written to out[k]. Calling integrate() once per interval
+ evaluates the integrand a handful of nodes at a time and pays the
+ dispatch and thread pool cost for every interval; here the intervals are
+ processed side by side instead:
+   - Intervals are sorted by n and taken in groups of simpson_block.
+     Node i of every interval in a group is evaluated in one block (one
+     call of a batched integrand), so the loops vectorize across
+     intervals; lanes that are already done get weight 0.
+   - The groups run on the shared thread pool.
+   - Intervals with at least policy.chunk_nodes nodes go to integrate()
+     one by one, that one parallelizes over their nodes.
+ Every interval is summed with compensated summation in its own lane, the
+ result agrees with integrate() to rounding and does not depend on the
+ thread count. Odd n is rounded up, n < 2 becomes 2, as for integrate().
+*/
+
+namespace simpson_detail {
+
+// Intervals idx[0..count) side by side, node by node
+template<typename F>
+void integrate_lanes(F& f, const double* a, const double* b, const long long* n, const std::size_t* idx,
+                     int count, double* out) {
+    matrix_kernels::simd_dispatch([&] {
+        alignas(64) double lo[simpson_block], hi[simpson_block], h[simpson_block];
+        alignas(64) double last[simpson_block];   // n as double
+        alignas(64) double x[simpson_block], y[simpson_block];
+        alignas(64) double sum[simpson_block], comp[simpson_block];
+        long long max_n = 0;
+        for (int k = 0; k < count; ++k) {
+            std::size_t j = idx[k];
+            lo[k] = a[j];
+            hi[k] = b[j];
+            h[k] = (b[j] - a[j]) / static_cast<double>(n[j]);
+            last[k] = static_cast<double>(n[j]);
+            sum[k] = comp[k] = 0.0;
+            max_n = std::max(max_n, n[j]);
+        }
+        for (long long i = 0; i <= max_n; ++i) {
+            double di = static_cast<double>(i);
+            double inner = (i & 1) ? 4.0 : 2.0;
+            // Endpoints exactly as in integrate(); finished lanes evaluate at b with weight 0
+            for (int k = 0; k < count; ++k) x[k] = di < last[k] ? lo[k] + di * h[k] : hi[k];
+            evaluate(f, x, y, static_cast<std::size_t>(count));
+            for (int k = 0; k < count; ++k) {
+                double w = (i == 0 || di == last[k]) ? 1.0 : di < last[k] ? inner : 0.0;
+                double v = w * y[k];
+                double s = sum[k], t = s + v;
+                comp[k] += ((s < 0 ? -s : s) >= (v < 0 ? -v : v)) ? (s - t) + v : (v - t) + s;
+                sum[k] = t;
+            }
+        }
+        for (int k = 0; k < count; ++k) out[idx[k]] = (sum[k] + comp[k]) * h[k] / 3.0;
+    });
+}
+
+} // namespace simpson_detail
+
+// Simpson's rule on [a[k], b[k]] with n[k] intervals into out[k], k < count
+template<typename F>
+void integrate_batch(F&& f, const double* a, const double* b, const long long* n, double* out,
+                     std::size_t count, IntegrationPolicy policy = {}) {
+    std::vector<long long> nodes(count);
+    for (std::size_t k = 0; k < count; ++k) {
+        long long m = n[k] % 2 != 0 ? n[k] + 1 : n[k];
+        nodes[k] = std::max(m, 2LL);
+    }
+
+    // Long intervals: integrate() parallelizes over their nodes
+    std::vector<std::size_t> idx;
+    idx.reserve(count);
+    for (std::size_t k = 0; k < count; ++k) {
+        if (nodes[k] >= policy.chunk_nodes)
+            out[k] = integrate(f, a[k], b[k], nodes[k], policy);
+        else
+            idx.push_back(k);
+    }
+    // Similar n in one group, so few lanes idle
+    std::stable_sort(idx.begin(), idx.end(), [&](std::size_t i, std::size_t j) { return nodes[i] < nodes[j]; });
+
+    int groups = static_cast<int>((idx.size() + simpson_block - 1) / simpson_block);
+    auto run = [&](int g0, int g1) {
+        for (int g = g0; g < g1; ++g) {
+            std::size_t first = static_cast<std::size_t>(g) * simpson_block;
+            int size = static_cast<int>(std::min<std::size_t>(simpson_block, idx.size() - first));
+            simpson_detail::integrate_lanes(f, a, b, nodes.data(), idx.data() + first, size, out);
+        }
+    };
+    if (policy.parallel && groups > 1)
+        parallel_for(0, groups, 1, run);
+    else
+        run(0, groups);
+}
+
+// The same n for every interval
+template<typename F>
+void integrate_batch(F&& f, const double* a, const double* b, long long n, double* out,
+                     std::size_t count, IntegrationPolicy policy = {}) {
+    std::vector<long long> all(count, n);
+    integrate_batch(f, a, b, all.data(), out, count, policy);
+}
+
+#endif
@@ -1,11 +1,82 @@
 #include "math_hw.h"
+#include "../harmadik-hf/simd_kernels.h"
+
+namespace {
+
+/*
+ exp: P(z) / P(-z) with P(z) = 1 + z/2 + z^2/10 + z^3/120. Splitting P into
+ its even part E = 1 + z^2/10 and odd part O = z (1/2 + z^2/120) gives both
+ numerator (E + O) and denominator (E - O) from one z^2.
+*/
+struct ExpTerms {
+    double num, den;
+};
+
+inline ExpTerms exp_terms(double z) {
+    double z2 = z * z;
+    double e = 1.0 + 0.1 * z2;
+    double o = z * (0.5 + z2 * (1.0 / 120.0));
+    return {e + o, e - o};
+}
+
+// cos: numerator and denominator are quadratic in w^2 (Horner form)
+struct CosTerms {
+    double num, den;
+};
+
+inline CosTerms cos_terms(double w) {
+    double w2 = w * w;
+    return {1.0 + w2 * (-115.0 / 252.0 + w2 * (313.0 / 15120.0)),
+            1.0 + w2 * (11.0 / 252.0 + w2 * (13.0 / 15120.0))};
+}
+
+inline double exp_pade(double x) {
+    ExpTerms e = exp_terms(x);
+    return e.num / e.den;
+}
+
+inline double cos_pade(double x) {
+    CosTerms c = cos_terms(x);
+    return c.num / c.den;
+}
+
+// The two quotients are merged, so one division per value instead of two
+inline double gauss_cos_pade(double x) {
+    ExpTerms e = exp_terms(-x * x);
+    CosTerms c = cos_terms(x);
+    return (e.num * c.num) / (e.den * c.den);
+}
+
+// y[i] = kernel(x[i]); the plain loop is vectorized for the selected instruction set
+template<typename K>
+void apply(const double* x, double* y, std::size_t n, K kernel) {
+    matrix_kernels::simd_dispatch([&] {
+        for (std::size_t i = 0; i < n; ++i) y[i] = kernel(x[i]);
+    });
+}
+
+} // namespace
 
 double my_exp(double x_e) {
-    double z = x_e;
-    return (1.0+0.5*z+0.1*z*z+(1.0/120.0)*z*z*z)/(1.0-0.5*z+0.1*z*z-(1.0/120.0)*z*z*z);
+    return exp_pade(x_e);
 }
 
 double my_cos(double x_c) {
-    double w = x_c;
-    return (1.0-w*w*(115.0/252.0)+w*w*w*w*(313.0/15120.0))/(1+w*w*(11.0/252.0)+w*w*w*w*(13.0/15120.0));
-}
\ No newline at end of file
+    return cos_pade(x_c);
+}
+
+double my_gauss_cos(double x) {
+    return gauss_cos_pade(x);
+}
+
+void my_exp(const double* x, double* y, std::size_t n) {
+    apply(x, y, n, [](double v) { return exp_pade(v); });
+}
+
+void my_cos(const double* x, double* y, std::size_t n) {
+    apply(x, y, n, [](double v) { return cos_pade(v); });
+}
+
+void my_gauss_cos(const double* x, double* y, std::size_t n) {
+    apply(x, y, n, [](double v) { return gauss_cos_pade(v); });
+}
@@ -1,10 +1,36 @@
 #ifndef math_own
 #define math_own
 
-// Function to compute the sum of two numbers
+#include <cstddef>
+
+/*
+ Rational (Padé) approximations of exp and cos
+
+   exp: [3/3] Padé approximant around 0, accurate for small |x| only
+   cos: [4/4] Padé approximant around 0
+
+ The array versions compute the same approximants for n values at once
+ (x and y may be the same array); the loops are compiled for AVX2 or
+ AVX-512 and chosen at run time (harmadik-hf/simd_kernels.h). Results
+ may differ from the scalar versions in the last bits (FMA contraction).
+*/
+
+// Padé approximation of exp(x)
 double my_exp(double x_e);
 
-// Function to integrate using Simpson's rule
+// Padé approximation of cos(x)
 double my_cos(double x_c);
 
-#endif 
+// Integrand of third.cpp: my_exp(-x*x) * my_cos(x), with a single division
+double my_gauss_cos(double x);
+
+// y[i] = my_exp(x[i]), i < n
+void my_exp(const double* x, double* y, std::size_t n);
+
+// y[i] = my_cos(x[i]), i < n
+void my_cos(const double* x, double* y, std::size_t n);
+
+// y[i] = my_gauss_cos(x[i]), i < n; usable as a batched integrand of integrate()
+void my_gauss_cos(const double* x, double* y, std::size_t n);
+
+#endif
@@ -0,0 +1,117 @@
+#ifndef romberg_own
+#define romberg_own
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "quadrature.h"
+#include "simpson.h"
+
+/*
+ Resumable Romberg integration
+
+   Romberg r([](double x) { return std::exp(-x * x) * std::cos(x); }, -1.0, 3.0);
+   QuadratureResult coarse = r.integrate_to(opt_1e6);
+   QuadratureResult fine = r.integrate_to(opt_1e12);   // continues, nothing recomputed
+
+ Level k is the trapezoidal rule on 2^k intervals. Going to level k + 1
+ only evaluates the 2^k new midpoints; the sum of all interior values is
+ kept (compensated), so every sample is used once. The trapezoidal values
+ are combined by Richardson extrapolation into the Romberg tableau
+     R(k, j) = R(k, j-1) + (R(k, j-1) - R(k-1, j-1)) / (4^j - 1),
+ of which only the last row is stored. R(k, 1) equals Simpson's rule on
+ 2^k intervals, higher columns cancel further powers of h^2.
+
+ The error estimate is |R(k, k) - R(k-1, k-1)|. Convergence is accepted
+ from level 3 on, so that a lucky early agreement (e.g. symmetric
+ integrands on a coarse grid) does not stop the refinement. The midpoint
+ sums run like integrate(): in blocks, in fixed chunks on the thread pool.
+*/
+template<typename F>
+class Romberg {
+    F f_;
+    double a_, b_;
+    IntegrationPolicy policy_;
+    int level_ = 0;
+    long long evaluations_ = 0;
+    double ends_ = 0.0;         // (f(a) + f(b)) / 2
+    CompensatedSum interior_;   // sum of f at all interior nodes so far
+    std::vector<double> row_;   // R(level, 0..level)
+    double previous_diagonal_ = 0.0;
+
+    static constexpr int min_converged_level = 3;
+
+public:
+    // Deepest level (2^max_level intervals)
+    static constexpr int max_level = 40;
+
+    Romberg(F f, double a, double b, IntegrationPolicy policy = {})
+        : f_(std::move(f)), a_(a), b_(b), policy_(policy) {
+        double x[2] = {a, b}, y[2];
+        simpson_detail::evaluate(f_, x, y, 2);
+        evaluations_ = 2;
+        ends_ = 0.5 * (y[0] + y[1]);
+        row_.push_back((b - a) * ends_);
+        previous_diagonal_ = row_[0];
+    }
+
+    int level() const { return level_; }
+    long long intervals() const { return 1LL << level_; }
+    long long evaluations() const { return evaluations_; }
+
+    // Best estimate so far: the diagonal element R(level, level)
+    double value() const { return row_.back(); }
+
+    double error() const { return std::abs(row_.back() - previous_diagonal_); }
+
+    // Halve h: evaluate the new midpoints only, then extend the tableau by one row
+    void refine() {
+        if (level_ >= max_level) return;
+        long long n_old = intervals();
+        double h = (b_ - a_) / static_cast<double>(2 * n_old);
+        // New nodes: a + (2i + 1) h, i < n_old
+        CompensatedSum mid = simpson_detail::chunked_sum(
+            f_, a_ + h, 2.0 * h, 0, n_old, [](long long) { return 1.0; }, policy_);
+        interior_.add(mid.sum);
+        interior_.add(mid.comp);
+        evaluations_ += n_old;
+        ++level_;
+
+        CompensatedSum trap = interior_;
+        trap.add(ends_);
+        std::vector<double> next(level_ + 1);
+        next[0] = trap.value() * h;
+        double factor = 1.0;
+        for (int j = 1; j <= level_; ++j) {
+            factor *= 4.0;
+            next[j] = next[j - 1] + (next[j - 1] - row_[j - 1]) / (factor - 1.0);
+        }
+        previous_diagonal_ = row_.back();
+        row_.swap(next);
+    }
+
+    /*
+     Refine until the error estimate meets max(abs_tol, rel_tol * |value|),
+     the evaluation budget (counted from the first evaluation) or max_level
+     is reached. Can be called again with a tighter tolerance later.
+    */
+    QuadratureResult integrate_to(QuadratureOptions const& opt) {
+        auto done = [&] {
+            return level_ >= min_converged_level &&
+                   error() <= std::max(opt.abs_tol, opt.rel_tol * std::abs(value()));
+        };
+        while (!done() && level_ < max_level && evaluations_ + intervals() <= opt.max_evaluations)
+            refine();
+        QuadratureResult r;
+        r.value = value();
+        r.error = error();
+        r.evaluations = evaluations_;
+        r.intervals = static_cast<int>(std::min<long long>(intervals(), 1LL << 30));
+        r.converged = done();
+        return r;
+    }
+};
+
+#endif
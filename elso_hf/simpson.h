@@ -0,0 +1,150 @@
+#ifndef simpson_own
+#define simpson_own
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "../harmadik-hf/simd_kernels.h"
+#include "../harmadik-hf/thread_pool.h"
+
+/*
+ Composite Simpson's rule with a pluggable integrand
+
+   double r = integrate([](double x) { return std::exp(-x * x) * std::cos(x); }, -1.0, 3.0, 1000000);
+
+ The integrand is a template parameter, so it is inlined into the node loop.
+ It may be either
+   - scalar: double f(double x), or
+   - batched: void f(const double* x, double* y, std::size_t count),
+     which lets a caller plug in an array (SIMD) implementation.
+ Nodes are evaluated in blocks of simpson_block, the block loops are
+ compiled for the selected instruction set (simd_dispatch), so vectorizable
+ integrands run on vector registers.
+
+ The interior nodes are split into fixed chunks of policy.chunk_nodes that
+ run on the shared thread pool (harmadik-hf/thread_pool.h). Each chunk is
+ summed with compensated (Neumaier) summation and the chunk sums are
+ combined in index order, so the result depends only on n and chunk_nodes:
+ it is bit-identical for any thread count and with parallel = false.
+ With parallel = true, f is called concurrently from several threads.
+*/
+
+struct IntegrationPolicy {
+    bool parallel = true;                // run chunks on the thread pool
+    long long chunk_nodes = 1LL << 16;   // nodes per chunk (fixes the summation order)
+};
+
+// Nodes evaluated together
+constexpr int simpson_block = 64;
+
+// Neumaier's compensated sum
+struct CompensatedSum {
+    double sum = 0.0;
+    double comp = 0.0;
+
+    void add(double v) {
+        double t = sum + v;
+        if ((sum < 0 ? -sum : sum) >= (v < 0 ? -v : v))
+            comp += (sum - t) + v;
+        else
+            comp += (v - t) + sum;
+        sum = t;
+    }
+
+    double value() const { return sum + comp; }
+};
+
+namespace simpson_detail {
+
+template<typename F>
+constexpr bool is_batched() {
+    return std::is_invocable_v<F&, const double*, double*, std::size_t>;
+}
+
+// y[k] = f(x[k]), k < count
+template<typename F>
+inline void evaluate(F& f, const double* x, double* y, std::size_t count) {
+    if constexpr (is_batched<F>())
+        f(x, y, count);
+    else
+        for (std::size_t k = 0; k < count; ++k) y[k] = f(x[k]);
+}
+
+// sum of weight(i) * f(x0 + i * dx), i0 <= i < i1 (compensated over blocks)
+template<typename F, typename W>
+CompensatedSum strided_sum(F& f, double x0, double dx, long long i0, long long i1, W const& weight) {
+    constexpr int lanes = 8;
+    CompensatedSum s;
+    matrix_kernels::simd_dispatch([&] {
+        alignas(64) double x[simpson_block];
+        alignas(64) double y[simpson_block];
+        for (long long i = i0; i < i1; i += simpson_block) {
+            int count = static_cast<int>(std::min<long long>(simpson_block, i1 - i));
+            for (int k = 0; k < count; ++k) x[k] = x0 + static_cast<double>(i + k) * dx;
+            evaluate(f, x, y, static_cast<std::size_t>(count));
+            // Fixed lane order, so vectorization does not change the result
+            double acc[lanes] = {};
+            for (int k = 0; k < count; ++k)
+                acc[k % lanes] += weight(i + k) * y[k];
+            double block = 0.0;
+            for (int l = 0; l < lanes; ++l) block += acc[l];
+            s.add(block);
+        }
+    });
+    return s;
+}
+
+/*
+ strided_sum over i0 <= i < i1 in fixed chunks of policy.chunk_nodes,
+ on the thread pool if allowed; chunks are combined in index order, so
+ the result does not depend on the thread count
+*/
+template<typename F, typename W>
+CompensatedSum chunked_sum(F& f, double x0, double dx, long long i0, long long i1, W const& weight,
+                           IntegrationPolicy const& policy) {
+    long long chunk = std::max<long long>(simpson_block, policy.chunk_nodes);
+    int chunks = static_cast<int>((std::max(i1 - i0, 0LL) + chunk - 1) / chunk);
+    std::vector<CompensatedSum> parts(chunks);
+    auto run = [&](int c0, int c1) {
+        for (int c = c0; c < c1; ++c) {
+            long long lo = i0 + c * chunk;
+            parts[c] = strided_sum(f, x0, dx, lo, std::min(i1, lo + chunk), weight);
+        }
+    };
+    if (policy.parallel && chunks > 1)
+        parallel_for(0, chunks, 1, run);
+    else
+        run(0, chunks);
+    CompensatedSum total;
+    for (CompensatedSum const& p : parts) {
+        total.add(p.sum);
+        total.add(p.comp);
+    }
+    return total;
+}
+
+} // namespace simpson_detail
+
+// Simpson's rule on [a, b] with n intervals (odd n is rounded up, at least 2)
+template<typename F>
+double integrate(F&& f, double a, double b, long long n, IntegrationPolicy policy = {}) {
+    if (n % 2 != 0) ++n;  // Simpson's rule requires an even number of intervals
+    n = std::max(n, 2LL);
+    double h = (b - a) / static_cast<double>(n);
+    // Interior nodes: weight 4 for odd, 2 for even i
+    CompensatedSum interior = simpson_detail::chunked_sum(
+        f, a, h, 1, n, [](long long i) { return (i & 1) ? 4.0 : 2.0; }, policy);
+
+    double ends[2] = {a, b}, fe[2];
+    simpson_detail::evaluate(f, ends, fe, 2);
+    CompensatedSum total;
+    total.add(fe[0]);
+    total.add(fe[1]);
+    total.add(interior.sum);
+    total.add(interior.comp);
+    return total.value() * h / 3.0;
+}
+
+#endif
@@ -0,0 +1,1018 @@
+#include "matrix.h"
+#include "bench_suite.h"
+#include "small_matrix.h"
+#include "matrix_batch.h"
+#include "sparse_matrix.h"
+#include "krylov.h"
+#include "cholesky.h"
+#include "structured_matrix.h"
+#include "../masodik-hf/vector2_array.h"
+#include "../elso_hf/quadrature.h"
+#include "../elso_hf/romberg.h"
+#include "../elso_hf/integrate_batch.h"
+#include "../elso_hf/fastmath.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <atomic>
+#include <new>
+#include <utility>
+
+// Simpson-integrálás az első házi feladatból (../elso_hf/fifth.cpp)
+extern "C" double integrate(int n, double x0, double x1);
+
+// Dinamikus foglalások számlálása a kifejezéssablonok méréséhez
+// (a GCC a malloc/free-re épülő cserét tévesen keveredésnek látja)
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+static std::atomic<long long> g_allocations{0};
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+// Minden tárolófoglalás: a fenti számláló, plusz a Matrix készletének
+// (pool_allocator.h) heap- és szabadlistás kiszolgálásai
+long long allocation_count() {
+    AllocationStats st = allocation_stats();
+    return g_allocations.load() + st.heap_allocations + st.pool_hits;
+}
+
+// A korábbi i-j-k ciklus, összehasonlítási alapnak
+Matrix<double> naive_multiply(const Matrix<double>& a, const Matrix<double>& b) {
+    int n = a.size();
+    Matrix<double> result(n);
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < n; ++j)
+            for (int k = 0; k < n; ++k)
+                result(i, j) += a(i, k) * b(k, j);
+    return result;
+}
+
+Matrix<double> random_matrix(int n, std::mt19937& rng) {
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    Matrix<double> m(n);
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < n; ++j)
+            m(i, j) = dist(rng);
+    return m;
+}
+
+// Legjobb idő másodpercben, legalább min_reps futásból
+template<typename F>
+double best_time(F&& f, int min_reps = 3) {
+    double best = 1e300;
+    for (int r = 0; r < min_reps; ++r) {
+        auto t0 = std::chrono::steady_clock::now();
+        f();
+        auto t1 = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(t1 - t0).count());
+    }
+    return best;
+}
+
+void bench_gemm(int max_n) {
+    std::mt19937 rng(42);
+    std::cout << "==== operator*(Matrix, Matrix) ====\n";
+    std::cout << std::setw(6) << "n" << std::setw(14) << "naive GF/s"
+              << std::setw(14) << "blocked GF/s" << std::setw(10) << "speedup"
+              << std::setw(12) << "max |diff|" << "\n";
+    for (int n = 64; n <= max_n; n *= 2) {
+        Matrix<double> a = random_matrix(n, rng);
+        Matrix<double> b = random_matrix(n, rng);
+        double flops = 2.0 * n * n * n;
+
+        Matrix<double> c_naive(1), c_fast(1);
+        int reps = n <= 256 ? 5 : 1;
+        double t_naive = best_time([&] { c_naive = naive_multiply(a, b); }, reps);
+        double t_fast = best_time([&] { c_fast = a * b; }, reps);
+
+        double max_diff = 0;
+        for (int i = 0; i < n; ++i)
+            for (int j = 0; j < n; ++j)
+                max_diff = std::max(max_diff, std::abs(c_naive(i, j) - c_fast(i, j)));
+
+        std::cout << std::setw(6) << n
+                  << std::setw(14) << std::fixed << std::setprecision(2) << flops / t_naive * 1e-9
+                  << std::setw(14) << flops / t_fast * 1e-9
+                  << std::setw(9) << t_naive / t_fast << "x"
+                  << std::setw(12) << std::scientific << std::setprecision(1) << max_diff
+                  << std::defaultfloat << "\n";
+    }
+}
+
+// Szálszám szerinti skálázódás rögzített n mellett (szorzás, mat-vec, tenzor)
+void bench_threads(int n, unsigned max_threads) {
+    std::mt19937 rng(7);
+    Matrix<double> a = random_matrix(n, rng);
+    Matrix<double> b = random_matrix(n, rng);
+    Matrix<double> small = random_matrix(32, rng);
+    std::vector<double> v(n, 1.0);
+    int kn = std::max(1, n / 32);
+    Matrix<double> kron_a = random_matrix(kn, rng);
+
+    std::cout << "==== Skálázódás szálszám szerint, n = " << n << " ====\n";
+    std::cout << std::setw(8) << "threads" << std::setw(14) << "gemm GF/s"
+              << std::setw(14) << "matvec GB/s" << std::setw(14) << "tensor GB/s" << "\n";
+    for (unsigned t = 1; t <= max_threads; t *= 2) {
+        set_num_threads(t);
+        Matrix<double> c(1);
+        std::vector<double> r;
+        double t_mm = best_time([&] { c = a * b; }, 2);
+        double t_mv = best_time([&] { r = a * v; }, 5);
+        double t_kr = best_time([&] { c = tensor(kron_a, small); }, 3);
+        double n2 = static_cast<double>(n) * n;
+        double kron_elems = static_cast<double>(kn) * kn * 32 * 32;
+        std::cout << std::setw(8) << t << std::fixed << std::setprecision(2)
+                  << std::setw(14) << 2.0 * n2 * n / t_mm * 1e-9
+                  << std::setw(14) << n2 * sizeof(double) / t_mv * 1e-9
+                  << std::setw(14) << kron_elems * sizeof(double) / t_kr * 1e-9
+                  << std::defaultfloat << "\n";
+    }
+}
+
+// Ismételt megoldás: jobb oldalanként inv() + szorzás vs. egyszeri LU + solve
+void bench_repeated_solve(int n, int rhs_count) {
+    std::mt19937 rng(11);
+    Matrix<double> a = random_matrix(n, rng);
+    std::vector<std::vector<double>> rhs(rhs_count, std::vector<double>(n, 1.0));
+    for (auto& b : rhs) for (auto& x : b) x = std::uniform_real_distribution<double>(-1, 1)(rng);
+
+    double t_inv = best_time([&] {
+        for (auto const& b : rhs) { auto x = a.inv() * b; (void)x; }
+    }, 1);
+    double t_lu = best_time([&] {
+        LU<double> lu(a);
+        for (auto const& b : rhs) { auto x = lu.solve(b); (void)x; }
+    }, 1);
+    std::cout << "==== " << rhs_count << " jobb oldal, n = " << n << " ====\n"
+              << "inv() jobb oldalanként: " << t_inv * 1e3 << " ms\n"
+              << "LU egyszer + solve:     " << t_lu * 1e3 << " ms ("
+              << t_inv / t_lu << "x)\n";
+}
+
+/*
+ A korábbi, érték szerinti operátorok mása: minden részeredmény új mátrix
+ (a bal operandus másolata, és a "return a += b" is másol)
+*/
+namespace eager {
+Matrix<double> add(Matrix<double> a, Matrix<double> const& b) { return a += b; }
+Matrix<double> sub(Matrix<double> a, Matrix<double> const& b) { return a -= b; }
+Matrix<double> mul(Matrix<double> a, double s) { return a *= s; }
+Matrix<double> div(Matrix<double> a, double s) { return a /= s; }
+}
+
+// Ötös frissítés: D = A + B - C * 2 + E / 4 - F, mohó vs. kifejezéssablon
+void bench_expression(int n) {
+    std::mt19937 rng(3);
+    Matrix<double> a = random_matrix(n, rng), b = random_matrix(n, rng), c = random_matrix(n, rng);
+    Matrix<double> e = random_matrix(n, rng), f = random_matrix(n, rng);
+    Matrix<double> d(n);
+
+    long long alloc0 = allocation_count();
+    double t_eager = best_time([&] {
+        d = eager::sub(eager::add(eager::sub(eager::add(a, b), eager::mul(c, 2.0)), eager::div(e, 4.0)), f);
+    }, 5);
+    long long alloc_eager = (allocation_count() - alloc0) / 5;
+
+    alloc0 = allocation_count();
+    double t_expr = best_time([&] { d = a + b - c * 2.0 + e / 4.0 - f; }, 5);
+    long long alloc_expr = (allocation_count() - alloc0) / 5;
+
+    // Minimális forgalom: 5 bemenet olvasása + 1 kimenet írása
+    double bytes = 6.0 * n * n * sizeof(double);
+    std::cout << "==== D = A + B - C * 2 + E / 4 - F, n = " << n << " ====\n"
+              << std::fixed << std::setprecision(2)
+              << "mohó:            " << std::setw(8) << bytes / t_eager * 1e-9 << " GB/s, "
+              << alloc_eager << " foglalás/kiértékelés\n"
+              << "kifejezéssablon: " << std::setw(8) << bytes / t_expr * 1e-9 << " GB/s, "
+              << alloc_expr << " foglalás/kiértékelés\n" << std::defaultfloat;
+}
+
+/*
+ Strassen–Winograd a klasszikus szorzáshoz képest: idő a levágási határ
+ függvényében (ebből állítottuk be a strassen_cutoff() alapértékét) és
+ az eltérés a klasszikus szorzattól. GFLOP/s: effektív, 2n^3 / idő.
+*/
+void bench_strassen(int n) {
+    std::mt19937 rng(5);
+    Matrix<double> a = random_matrix(n, rng), b = random_matrix(n, rng), c(n);
+    double t_classic = best_time([&] { c = a * b; }, 3);
+    double flops = 2.0 * n * n * n;
+    std::cout << "==== Strassen–Winograd, n = " << n << " ====\n"
+              << std::fixed << std::setprecision(2)
+              << "klasszikus:        " << std::setw(8) << t_classic * 1e3 << " ms, "
+              << std::setw(6) << flops / t_classic * 1e-9 << " GFLOP/s\n";
+    for (int cutoff = 128; 2 * cutoff <= n; cutoff *= 2) {
+        double t = best_time([&] { c = strassen_multiply(a, b, cutoff); }, 3);
+        StrassenError<double> e = strassen_error(a, b, cutoff);
+        std::cout << "cutoff " << std::setw(5) << cutoff << " (" << e.levels << " szint): "
+                  << std::setw(8) << t * 1e3 << " ms, " << std::setw(6) << flops / t * 1e-9 << " GFLOP/s, "
+                  << std::scientific << std::setprecision(1) << "max eltérés " << e.max_abs
+                  << ", relatív " << e.relative << ", normwise " << e.normwise
+                  << std::fixed << std::setprecision(2) << "\n";
+    }
+    std::cout << std::defaultfloat;
+}
+
+/*
+ Ismétlődő, sok ideiglenes mátrixot létrehozó ciklus készlettel és std::allocator-ral:
+ a bemelegítés utáni iterációk heapfoglalásai és ideje
+*/
+template<typename Alloc>
+void bench_allocator_loop(const char* name, int n, int iterations) {
+    using M = Matrix<double, Alloc>;
+    M a(n, 0.5), b(n, 0.25), x(n, 1.0);
+    auto step = [&] {
+        M t = a * x;
+        M u = t.transpose();
+        u += b;
+        x = u / static_cast<double>(n);
+    };
+    step();
+    reset_allocation_stats();
+    long long alloc0 = g_allocations.load();
+    auto t0 = std::chrono::steady_clock::now();
+    for (int it = 0; it < iterations; ++it) step();
+    double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    AllocationStats st = allocation_stats();
+    std::cout << std::setw(16) << name << std::setw(12) << std::fixed << std::setprecision(1)
+              << t / iterations * 1e6 << " us/iter" << std::setw(10)
+              << st.heap_allocations + (g_allocations.load() - alloc0) << " heap"
+              << std::setw(10) << st.pool_hits << " készletből\n" << std::defaultfloat;
+}
+
+void bench_allocator(int n, int iterations) {
+    std::cout << "==== Tárolófoglalás ismétlődő ciklusban, n = " << n
+              << ", " << iterations << " iteráció ====\n";
+    bench_allocator_loop<PoolAllocator<double>>("PoolAllocator", n, iterations);
+    bench_allocator_loop<std::allocator<double>>("std::allocator", n, iterations);
+}
+
+// A korábbi Matrix::transpose ciklusa: result(j, i) = (i, j), oszloponkénti írás
+void naive_transpose(const Matrix<double>& a, Matrix<double>& result) {
+    for (int i = 0; i < a.rows(); ++i)
+        for (int j = 0; j < a.cols(); ++j)
+            result(j, i) = a(i, j);
+}
+
+// Transzponálás sávszélessége (olvasás + írás) n = 64 ... max_n, négyszeres lépéssel
+void bench_transpose(int max_n) {
+    std::cout << "==== Transzponálás (GB/s, double) ====\n";
+    std::cout << std::setw(8) << "n" << std::setw(12) << "naiv" << std::setw(12) << "blokkos"
+              << std::setw(12) << "helyben" << "\n";
+    for (int n = 64; n <= max_n; n *= 4) {
+        Matrix<double> a(n, 0.0), at(n, 0.0);
+        for (int i = 0; i < n; ++i)
+            for (int j = 0; j < n; ++j)
+                a(i, j) = i + 1e-4 * j;
+        int reps = n <= 1024 ? 10 : 2;
+        double bytes = 2.0 * n * n * sizeof(double);
+        // Előre lefoglalt célba, hogy csak a bejárást mérjük
+        double t_naive = best_time([&] { naive_transpose(a, at); }, reps);
+        double t_blocked = best_time([&] { transpose(a.view(), at.view()); }, reps);
+        double t_inplace = best_time([&] { a.transpose_inplace(); }, reps);
+        std::cout << std::setw(8) << n << std::fixed << std::setprecision(2)
+                  << std::setw(12) << bytes / t_naive * 1e-9
+                  << std::setw(12) << bytes / t_blocked * 1e-9
+                  << std::setw(12) << bytes / t_inplace * 1e-9 << "\n" << std::defaultfloat;
+    }
+}
+
+// Összetett értékadások sávszélessége SIMD-szintenként (egy szálon)
+void bench_elementwise(int n) {
+    Matrix<double> a(n, 1.0), b(n, 0.5);
+    double n2 = static_cast<double>(n) * n;
+    SimdLevel detected = detect_simd_level();
+    const char* names[] = {"skalár", "SSE2", "AVX2", "AVX-512"};
+
+    std::cout << "==== Elemenkénti műveletek, n = " << n << " (GB/s) ====\n";
+    std::cout << std::setw(10) << "szint" << std::setw(10) << "A += B"
+              << std::setw(10) << "A *= s" << std::setw(14) << "A += s * B" << "\n";
+    for (int l = 0; l <= static_cast<int>(detected); ++l) {
+        set_simd_level(static_cast<SimdLevel>(l));
+        double t_add = best_time([&] { a += b; }, 10);
+        double t_scale = best_time([&] { a *= 1.0000001; }, 10);
+        double t_axpy = best_time([&] { a += 1e-3 * b; }, 10);
+        std::cout << std::setw(10) << names[l] << std::fixed << std::setprecision(2)
+                  << std::setw(10) << 3 * n2 * sizeof(double) / t_add * 1e-9
+                  << std::setw(10) << 2 * n2 * sizeof(double) / t_scale * 1e-9
+                  << std::setw(14) << 3 * n2 * sizeof(double) / t_axpy * 1e-9
+                  << std::defaultfloat << "\n";
+    }
+    set_simd_level(detected);
+}
+
+/*
+ Ritka mátrixok generált mintákon: sávos (félsávszélesség 4, mint egy
+ 1D-s véges differencia) és véletlen (soronként 10 nemnulla), n x n;
+ SpMV, transzponált SpMV és ritka * sűrű (8 oszlop). Az idő és a
+ memória a nemnullák számával nő, a sűrű mat-vec n^2-tel.
+*/
+void register_sparse(BenchSuite& suite) {
+    auto make = [](int n, bool banded, SparseFormat format) {
+        std::mt19937 rng(n);
+        std::uniform_int_distribution<int> col(0, n - 1);
+        std::uniform_real_distribution<double> val(-1.0, 1.0);
+        std::vector<Triplet<double>> t;
+        for (int i = 0; i < n; ++i) {
+            if (banded)
+                for (int j = std::max(0, i - 4); j <= std::min(n - 1, i + 4); ++j) t.push_back({i, j, val(rng)});
+            else
+                for (int k = 0; k < 10; ++k) t.push_back({i, col(rng), val(rng)});
+        }
+        return SparseMatrix<double>(n, n, t, format);
+    };
+    auto bytes = [](SparseMatrix<double> const& a) {
+        return static_cast<double>(a.memory_bytes() + 2 * sizeof(double) * a.rows());
+    };
+    std::vector<int> sizes = {10000, 100000, 1000000};
+    for (bool banded : {true, false}) {
+        std::string tag = banded ? "sparse_band" : "sparse_rand";
+        suite.add(tag + "_spmv", sizes, [make, bytes, banded](BenchState& st, int n) {
+            SparseMatrix<double> a = make(n, banded, SparseFormat::csr);
+            std::vector<double> x(n, 1.0), y(n);
+            while (st.keep_running()) {
+                a.multiply(x.data(), y.data());
+                do_not_optimize(y[0]);
+            }
+            st.set_flops(2.0 * a.nnz());
+            st.set_bytes(bytes(a));
+        });
+        suite.add(tag + "_spmv_t", sizes, [make, bytes, banded](BenchState& st, int n) {
+            SparseMatrix<double> a = make(n, banded, SparseFormat::csr);
+            std::vector<double> x(n, 1.0), y(n);
+            while (st.keep_running()) {
+                a.transpose_multiply(x.data(), y.data());
+                do_not_optimize(y[0]);
+            }
+            st.set_flops(2.0 * a.nnz());
+            st.set_bytes(bytes(a));
+        });
+        suite.add(tag + "_csc_spmv", sizes, [make, bytes, banded](BenchState& st, int n) {
+            SparseMatrix<double> a = make(n, banded, SparseFormat::csc);
+            std::vector<double> x(n, 1.0), y(n);
+            while (st.keep_running()) {
+                a.multiply(x.data(), y.data());
+                do_not_optimize(y[0]);
+            }
+            st.set_flops(2.0 * a.nnz());
+            st.set_bytes(bytes(a));
+        });
+        suite.add(tag + "_spmm8", {10000, 100000}, [make, banded](BenchState& st, int n) {
+            SparseMatrix<double> a = make(n, banded, SparseFormat::csr);
+            Matrix<double> b(n, 8, 1.0);
+            while (st.keep_running()) {
+                Matrix<double> c = a * b;
+                do_not_optimize(c.data()[0]);
+            }
+            st.set_flops(2.0 * 8 * a.nnz());
+        });
+    }
+}
+
+/*
+ Krylov-módszerek m x m-es 2D rácson (n = m^2, 5 pontos Poisson, illetve
+ konvekcióval nem szimmetrikus), rel. 1e-8 pontosságig; items = lépésszám
+*/
+void register_krylov(BenchSuite& suite) {
+    auto grid = [](int m, double convection) {
+        std::vector<Triplet<double>> t;
+        for (int i = 0; i < m; ++i)
+            for (int j = 0; j < m; ++j) {
+                int k = i * m + j;
+                t.push_back({k, k, 4.0});
+                if (i > 0) t.push_back({k, k - m, -1.0 - convection});
+                if (i + 1 < m) t.push_back({k, k + m, -1.0 + convection});
+                if (j > 0) t.push_back({k, k - 1, -1.0});
+                if (j + 1 < m) t.push_back({k, k + 1, -1.0});
+            }
+        return SparseMatrix<double>(m * m, m * m, t);
+    };
+    enum class Method { cg, cg_jacobi, cg_ilu0, bicgstab_ilu0, gmres_ilu0 };
+    auto solver = [grid](Method method) {
+        return [grid, method](BenchState& st, int m) {
+            bool symmetric = method == Method::cg || method == Method::cg_jacobi || method == Method::cg_ilu0;
+            SparseMatrix<double> a = grid(m, symmetric ? 0.0 : 0.4);
+            std::vector<double> b(a.rows(), 1.0);
+            KrylovOptions<double> opt;
+            opt.rel_tol = 1e-8;
+            opt.max_iterations = 10000;
+            KrylovResult<double> r;
+            while (st.keep_running()) {
+                std::vector<double> x(a.rows(), 0.0);
+                switch (method) {
+                case Method::cg: r = cg(a, b, x, opt); break;
+                case Method::cg_jacobi: r = cg(a, b, x, opt, JacobiPreconditioner<double>(a)); break;
+                case Method::cg_ilu0: r = cg(a, b, x, opt, ILU0Preconditioner<double>(a)); break;
+                case Method::bicgstab_ilu0: r = bicgstab(a, b, x, opt, ILU0Preconditioner<double>(a)); break;
+                case Method::gmres_ilu0: r = gmres(a, b, x, opt, ILU0Preconditioner<double>(a)); break;
+                }
+                do_not_optimize(x[0]);
+            }
+            st.set_items(r.iterations);
+        };
+    };
+    std::vector<int> sides = {64, 256};
+    suite.add("krylov_cg", sides, solver(Method::cg));
+    suite.add("krylov_cg_jacobi", sides, solver(Method::cg_jacobi));
+    suite.add("krylov_cg_ilu0", sides, solver(Method::cg_ilu0));
+    suite.add("krylov_bicgstab_ilu0", sides, solver(Method::bicgstab_ilu0));
+    suite.add("krylov_gmres_ilu0", sides, solver(Method::gmres_ilu0));
+}
+
+/*
+ Szerkezetes mátrixok: tömörített szimmetrikus mat-vec a sűrűhöz képest
+ (fele annyi bájt), valamint sávos LU (kl = ku = 4) és Thomas-algoritmus
+ n nagyságú rendszerekre, ahol a sűrű LU már el sem férne
+*/
+void register_structured(BenchSuite& suite) {
+    std::vector<int> dense_sizes = {1024, 2048, 4096};
+    suite.add("packed_sym_matvec", dense_sizes, [](BenchState& st, int n) {
+        PackedSymmetricMatrix<double> a(n);
+        for (int i = 0; i < n; ++i)
+            for (int j = 0; j <= i; ++j) a(i, j) = 1.0 / (1 + i + j);
+        std::vector<double> x(n, 1.0), y(n);
+        while (st.keep_running()) {
+            a.multiply(x.data(), y.data());
+            do_not_optimize(y[0]);
+        }
+        st.set_flops(2.0 * n * n);
+        st.set_bytes(static_cast<double>(a.memory_bytes()));
+    });
+    suite.add("dense_sym_matvec", dense_sizes, [](BenchState& st, int n) {
+        Matrix<double> a(n);
+        for (int i = 0; i < n; ++i)
+            for (int j = 0; j < n; ++j) a(i, j) = 1.0 / (1 + i + j);
+        std::vector<double> x(n, 1.0), y(n);
+        while (st.keep_running()) {
+            y = a * x;
+            do_not_optimize(y[0]);
+        }
+        st.set_flops(2.0 * n * n);
+        st.set_bytes(sizeof(double) * static_cast<double>(n) * n);
+    });
+    std::vector<int> sizes = {10000, 100000, 1000000};
+    suite.add("band_lu_solve", sizes, [](BenchState& st, int n) {
+        const int kl = 4, ku = 4;
+        BandMatrix<double> a(n, kl, ku);
+        for (int i = 0; i < n; ++i)
+            for (int j = std::max(0, i - kl); j <= std::min(n - 1, i + ku); ++j) a.at(i, j) = i == j ? 10.0 : std::sin(i + 2.0 * j);
+        std::vector<double> b(n, 1.0);
+        while (st.keep_running()) {
+            std::vector<double> x = BandLU<double>(a).solve(b);
+            do_not_optimize(x[0]);
+        }
+        st.set_flops(2.0 * n * kl * (kl + ku + 1));
+    });
+    suite.add("tridiagonal_thomas", sizes, [](BenchState& st, int n) {
+        TridiagonalMatrix<double> a(n, -1.0);
+        for (int i = 0; i < n; ++i) a.diagonal()[i] = 4.0;
+        std::vector<double> b(n, 1.0);
+        while (st.keep_running()) {
+            std::vector<double> x = a.solve(b);
+            do_not_optimize(x[0]);
+        }
+        st.set_flops(8.0 * n);
+    });
+}
+
+// Méretsor: first, 2*first, ... <= last
+std::vector<int> sweep(int first, int last, int factor = 2) {
+    std::vector<int> sizes;
+    for (int n = first; n <= last; n *= factor) sizes.push_back(n);
+    return sizes;
+}
+
+/*
+ Sok kis mátrix: count darab N x N-es szorzat / inverz egymás után,
+ SmallMatrix<double, N>-nel és összehasonlításként Matrix<double>-lel
+*/
+template<int N>
+void register_small(BenchSuite& suite) {
+    std::string tag = "small" + std::to_string(N);
+    auto make = [](int count) {
+        std::mt19937 rng(N);
+        std::uniform_real_distribution<double> dist(-1.0, 1.0);
+        std::vector<SmallMatrix<double, N>> ms(count);
+        for (auto& m : ms) {
+            for (int i = 0; i < N; ++i)
+                for (int j = 0; j < N; ++j)
+                    m(i, j) = dist(rng) + (i == j ? 2.0 : 0.0);
+        }
+        return ms;
+    };
+    suite.add(tag + "_multiply", {4096}, [make](BenchState& st, int count) {
+        auto ms = make(count);
+        SmallMatrix<double, N> acc = SmallMatrix<double, N>::identity();
+        while (st.keep_running()) {
+            for (auto const& m : ms) acc = m * acc * 0.5;
+            do_not_optimize(acc);
+        }
+        st.set_flops(2.0 * N * N * N * count);
+        st.set_items(count);
+    });
+    suite.add(tag + "_inverse", {4096}, [make](BenchState& st, int count) {
+        auto ms = make(count);
+        while (st.keep_running())
+            for (auto const& m : ms) do_not_optimize(m.inv());
+        st.set_items(count);
+    });
+    suite.add(tag + "_dynamic_multiply", {4096}, [make](BenchState& st, int count) {
+        auto ms = make(count);
+        std::vector<Matrix<double>> dyn;
+        for (auto const& m : ms) {
+            Matrix<double> d(N);
+            for (int i = 0; i < N; ++i)
+                for (int j = 0; j < N; ++j)
+                    d(i, j) = m(i, j);
+            dyn.push_back(d);
+        }
+        Matrix<double> acc = Matrix<double>::identity(N);
+        while (st.keep_running()) {
+            for (auto const& m : dyn) acc = m * acc * 0.5;
+            do_not_optimize(acc.data()[0]);
+        }
+        st.set_flops(2.0 * N * N * N * count);
+        st.set_items(count);
+    });
+}
+
+/*
+ Kötegelt (SoA) kis mátrixok: count darab 4x4-es szorzás, LU-megoldás és inverz,
+ összehasonlításként a Matrix<double>::inv() ciklusban
+*/
+void register_batch(BenchSuite& suite) {
+    constexpr int N = 4;
+    auto make = [](int count) {
+        std::mt19937 rng(9);
+        std::uniform_real_distribution<double> dist(-1.0, 1.0);
+        MatrixBatch<double> a(count, N, N);
+        for (int k = 0; k < count; ++k)
+            for (int i = 0; i < N; ++i)
+                for (int j = 0; j < N; ++j)
+                    a(k, i, j) = dist(rng) + (i == j ? 2.0 : 0.0);
+        return a;
+    };
+    std::vector<int> counts = {1024, 65536};
+    suite.add("batch4_multiply", counts, [make](BenchState& st, int count) {
+        MatrixBatch<double> a = make(count), b = make(count);
+        while (st.keep_running()) {
+            MatrixBatch<double> c = a * b;
+            do_not_optimize(c.data()[0]);
+        }
+        st.set_flops(2.0 * N * N * N * count);
+        st.set_items(count);
+    });
+    suite.add("batch4_solve", counts, [make](BenchState& st, int count) {
+        MatrixBatch<double> a = make(count), b(count, N, 1, 1.0);
+        while (st.keep_running()) {
+            MatrixBatch<double> x = BatchLU<double>(a).solve(b);
+            do_not_optimize(x.data()[0]);
+        }
+        st.set_items(count);
+    });
+    suite.add("batch4_inverse", counts, [make](BenchState& st, int count) {
+        MatrixBatch<double> a = make(count);
+        while (st.keep_running()) {
+            MatrixBatch<double> ai = inverse(a);
+            do_not_optimize(ai.data()[0]);
+        }
+        st.set_items(count);
+    });
+    suite.add("batch4_loop_inv", counts, [make](BenchState& st, int count) {
+        MatrixBatch<double> a = make(count);
+        std::vector<Matrix<double>> ms;
+        for (int k = 0; k < count; ++k) ms.push_back(a.get(k));
+        while (st.keep_running())
+            for (auto const& m : ms) {
+                Matrix<double> mi = m.inv();
+                do_not_optimize(mi.data()[0]);
+            }
+        st.set_items(count);
+    });
+}
+
+// Padé és tartományszűkítéses exp/cos (első házi) a libm-hez képest
+void register_pade(BenchSuite& suite) {
+    auto make = [](int n) {
+        std::vector<double> x(n);
+        for (int i = 0; i < n; ++i) x[i] = -1.0 + 4.0 * i / n;
+        return x;
+    };
+    using Kernel = void (*)(const double*, double*, std::size_t);
+    auto array = [make](Kernel kernel) {
+        return [make, kernel](BenchState& st, int n) {
+            std::vector<double> x = make(n), y(n);
+            while (st.keep_running()) {
+                kernel(x.data(), y.data(), n);
+                do_not_optimize(y[0]);
+            }
+            st.set_items(n);
+        };
+    };
+    auto loop = [make](double (*f)(double)) {
+        return [make, f](BenchState& st, int n) {
+            std::vector<double> x = make(n), y(n);
+            while (st.keep_running()) {
+                for (int i = 0; i < n; ++i) y[i] = f(x[i]);
+                do_not_optimize(y[0]);
+            }
+            st.set_items(n);
+        };
+    };
+    std::vector<int> sizes = {1024, 1 << 18};
+    suite.add("exp_libm", sizes, loop([](double x) { return std::exp(x); }));
+    suite.add("exp_pade_scalar", sizes, loop([](double x) { return my_exp(x); }));
+    suite.add("exp_pade_array", sizes, array(my_exp));
+    suite.add("cos_libm", sizes, loop([](double x) { return std::cos(x); }));
+    suite.add("cos_pade_scalar", sizes, loop([](double x) { return my_cos(x); }));
+    suite.add("cos_pade_array", sizes, array(my_cos));
+    suite.add("gauss_cos_libm", sizes, loop([](double x) { return std::exp(-x * x) * std::cos(x); }));
+    suite.add("gauss_cos_pade_scalar", sizes, loop([](double x) { return my_exp(-x * x) * my_cos(x); }));
+    suite.add("gauss_cos_pade_array", sizes, array(my_gauss_cos));
+
+    // Tartományszűkítéses változatok szintenként (elso_hf/fastmath.h)
+    const std::pair<const char*, MathAccuracy> tiers[] = {
+        {"low", MathAccuracy::low}, {"medium", MathAccuracy::medium}, {"full", MathAccuracy::full}};
+    using TierKernel = void (*)(const double*, double*, std::size_t, MathAccuracy);
+    const std::pair<const char*, TierKernel> kernels[] = {
+        {"exp_fast_", fast_exp}, {"cos_fast_", fast_cos}, {"gauss_cos_fast_", fast_gauss_cos}};
+    for (auto const& [prefix, kernel] : kernels)
+        for (auto const& [tier, a] : tiers)
+            suite.add(std::string(prefix) + tier, sizes, [make, kernel = kernel, a = a](BenchState& st, int n) {
+                std::vector<double> x = make(n), y(n);
+                while (st.keep_running()) {
+                    kernel(x.data(), y.data(), n, a);
+                    do_not_optimize(y[0]);
+                }
+                st.set_items(n);
+            });
+}
+
+/*
+ Vector2 tömbök: normalizálás (pontos és gyors, Precision::fast) és
+ befoglaló téglalap SoA-ban (Vector2Array) és AoS-ban másolás nélkül
+ (Vector2Span), összehasonlításként a skalár normalize() ciklus egy
+ Vector2 tömbön
+*/
+void register_vector2(BenchSuite& suite) {
+    auto make = [](int n) {
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<double> dist(-10.0, 10.0);
+        std::vector<Vector2<double>> v(n);
+        for (auto& p : v) p = Vector2<double>(dist(rng), dist(rng));
+        return v;
+    };
+    std::vector<int> sizes = {4096, 1 << 20};
+    suite.add("vec2_soa_normalize", sizes, [make](BenchState& st, int n) {
+        Vector2Array<double> a(make(n).data(), n), out(n);
+        while (st.keep_running()) {
+            out = normalize(a);
+            do_not_optimize(out.x_data()[0]);
+        }
+        st.set_bytes(4.0 * n * sizeof(double));
+        st.set_items(n);
+    });
+    suite.add("vec2_soa_normalize_fast", sizes, [make](BenchState& st, int n) {
+        Vector2Array<double> a(make(n).data(), n), out(n);
+        while (st.keep_running()) {
+            out = normalize(a, Precision::fast);
+            do_not_optimize(out.x_data()[0]);
+        }
+        st.set_bytes(4.0 * n * sizeof(double));
+        st.set_items(n);
+    });
+    suite.add("vec2_soa_normalize_fast_f", sizes, [make](BenchState& st, int n) {
+        Vector2Array<float> a(n), out(n);
+        std::vector<Vector2<double>> v = make(n);
+        for (int i = 0; i < n; ++i) a.set(i, Vector2<float>(float(v[i].x), float(v[i].y)));
+        while (st.keep_running()) {
+            out = normalize(a, Precision::fast);
+            do_not_optimize(out.x_data()[0]);
+        }
+        st.set_bytes(4.0 * n * sizeof(float));
+        st.set_items(n);
+    });
+    suite.add("vec2_aos_normalize", sizes, [make](BenchState& st, int n) {
+        std::vector<Vector2<double>> v = make(n);
+        Vector2Array<double> out(n);
+        while (st.keep_running()) {
+            out = normalize(Vector2Span<double const>(v.data(), n));
+            do_not_optimize(out.x_data()[0]);
+        }
+        st.set_bytes(4.0 * n * sizeof(double));
+        st.set_items(n);
+    });
+    suite.add("vec2_loop_normalize", sizes, [make](BenchState& st, int n) {
+        std::vector<Vector2<double>> v = make(n), out(n);
+        while (st.keep_running()) {
+            for (int i = 0; i < n; ++i) out[i] = normalize(v[i]);
+            do_not_optimize(out[0]);
+        }
+        st.set_bytes(4.0 * n * sizeof(double));
+        st.set_items(n);
+    });
+    suite.add("vec2_soa_bounds", sizes, [make](BenchState& st, int n) {
+        Vector2Array<double> a(make(n).data(), n);
+        while (st.keep_running()) {
+            Vector2Bounds<double> b = bounds(a);
+            do_not_optimize(b);
+        }
+        st.set_bytes(2.0 * n * sizeof(double));
+        st.set_items(n);
+    });
+}
+
+/*
+ Regressziófigyeléshez használt mérések, méretsorokkal
+ A munkamennyiség (flop, bájt) a szokásos becslés: szorzás 2n^3,
+ LU 2/3 n^3, inverz 8/3 n^3 (LU + n jobb oldal), mat-vec 2n^2 flop és n^2
+ elem olvasása, transzponálás n^2 olvasás + n^2 írás, tenzor m^4 írás.
+*/
+void register_suite(BenchSuite& suite, int max_n) {
+    suite.add("multiply", sweep(32, max_n), [](BenchState& st, int n) {
+        std::mt19937 rng(1);
+        Matrix<double> a = random_matrix(n, rng), b = random_matrix(n, rng), c(n);
+        while (st.keep_running()) {
+            c = a * b;
+            do_not_optimize(c.data()[0]);
+        }
+        st.set_flops(2.0 * n * n * n);
+        st.set_bytes(3.0 * n * n * sizeof(double));
+    });
+
+    // Strassen-mód (strassen.h): 2 * strassen_cutoff() alatt a klasszikus kernel fut
+    suite.add("multiply_strassen", sweep(1024, std::max(1024, 2 * max_n)), [](BenchState& st, int n) {
+        std::mt19937 rng(1);
+        Matrix<double> a = random_matrix(n, rng), b = random_matrix(n, rng), c(n);
+        set_multiply_algorithm(MultiplyAlgorithm::strassen);
+        while (st.keep_running()) {
+            c = a * b;
+            do_not_optimize(c.data()[0]);
+        }
+        set_multiply_algorithm(MultiplyAlgorithm::classical);
+        st.set_flops(2.0 * n * n * n);
+    });
+
+    suite.add("inv", sweep(32, std::min(max_n, 1024)), [](BenchState& st, int n) {
+        std::mt19937 rng(2);
+        Matrix<double> a = random_matrix(n, rng), c(n);
+        while (st.keep_running()) {
+            c = a.inv();
+            do_not_optimize(c.data()[0]);
+        }
+        st.set_flops(8.0 / 3.0 * n * n * n);
+    });
+
+    // SPD mátrix felbontása: LU (2/3 n^3) és Cholesky / LDL^T (1/3 n^3), ugyanarra a mátrixra
+    auto spd = [](int n) {
+        std::mt19937 rng(4);
+        Matrix<double> b = random_matrix(n, rng);
+        Matrix<double> a = b * b.transpose();
+        for (int i = 0; i < n; ++i) a(i, i) += n;
+        return a;
+    };
+    suite.add("spd_lu", sweep(64, std::min(max_n, 2048)), [spd](BenchState& st, int n) {
+        Matrix<double> a = spd(n);
+        while (st.keep_running()) {
+            LU<double> f(a);
+            do_not_optimize(f.factors().data()[0]);
+        }
+        st.set_flops(2.0 / 3.0 * n * n * n);
+    });
+    suite.add("spd_cholesky", sweep(64, std::min(max_n, 2048)), [spd](BenchState& st, int n) {
+        Matrix<double> a = spd(n);
+        while (st.keep_running()) {
+            Cholesky<double> f(a);
+            do_not_optimize(f.factors().data()[0]);
+        }
+        st.set_flops(1.0 / 3.0 * n * n * n);
+    });
+    suite.add("spd_ldlt", sweep(64, std::min(max_n, 2048)), [spd](BenchState& st, int n) {
+        Matrix<double> a = spd(n);
+        while (st.keep_running()) {
+            LDLT<double> f(a);
+            do_not_optimize(f.factors().data()[0]);
+        }
+        st.set_flops(1.0 / 3.0 * n * n * n);
+    });
+
+    suite.add("determinant", sweep(32, std::min(max_n, 1024)), [](BenchState& st, int n) {
+        std::mt19937 rng(3);
+        Matrix<double> a = random_matrix(n, rng);
+        while (st.keep_running()) {
+            double d = a.determinant();
+            do_not_optimize(d);
+        }
+        st.set_flops(2.0 / 3.0 * n * n * n);
+    });
+
+    suite.add("transpose", sweep(64, 4 * max_n), [](BenchState& st, int n) {
+        std::mt19937 rng(4);
+        Matrix<double> a = random_matrix(n, rng), at(n);
+        while (st.keep_running()) {
+            transpose(a.view(), at.view());
+            do_not_optimize(at.data()[0]);
+        }
+        st.set_bytes(2.0 * n * n * sizeof(double));
+    });
+
+    // m x m-es tényezők, az eredmény m^2 x m^2
+    suite.add("tensor", sweep(8, 32), [](BenchState& st, int m) {
+        std::mt19937 rng(5);
+        Matrix<double> a = random_matrix(m, rng), b = random_matrix(m, rng), c(1);
+        while (st.keep_running()) {
+            c = tensor(a, b);
+            do_not_optimize(c.data()[0]);
+        }
+        double elems = static_cast<double>(m) * m * m * m;
+        st.set_flops(elems);
+        st.set_bytes(elems * sizeof(double));
+    });
+
+    suite.add("matvec", sweep(64, 4 * max_n), [](BenchState& st, int n) {
+        std::mt19937 rng(6);
+        Matrix<double> a = random_matrix(n, rng);
+        std::vector<double> v(n, 1.0), r;
+        while (st.keep_running()) {
+            r = a * v;
+            do_not_optimize(r[0]);
+        }
+        st.set_flops(2.0 * n * n);
+        st.set_bytes(static_cast<double>(n) * n * sizeof(double));
+    });
+
+    // n részintervallum, n + 1 kiértékelés (exp + cos)
+    suite.add("integrate", sweep(1000, 10000000, 10), [](BenchState& st, int n) {
+        while (st.keep_running()) {
+            double r = integrate(n, -1.0, 3.0);
+            do_not_optimize(r);
+        }
+        st.set_items(n + 1.0);
+    });
+
+    // Ugyanaz a sablonos integrate()-tel egy szálon, illetve vektorizálható (polinom) integrandussal
+    suite.add("integrate_serial", sweep(1000, 10000000, 10), [](BenchState& st, int n) {
+        IntegrationPolicy serial;
+        serial.parallel = false;
+        while (st.keep_running()) {
+            double r = integrate([](double x) { return std::exp(-x * x) * std::cos(x); }, -1.0, 3.0, n, serial);
+            do_not_optimize(r);
+        }
+        st.set_items(n + 1.0);
+    });
+    suite.add("integrate_poly", sweep(1000, 10000000, 10), [](BenchState& st, int n) {
+        while (st.keep_running()) {
+            double r = integrate([](double x) { return ((0.5 * x - 1.0) * x + 2.0) * x - 3.0; }, -1.0, 3.0, n);
+            do_not_optimize(r);
+        }
+        st.set_items(n + 1.0);
+    });
+
+    // Sok rövid intervallum (n = 100) egyenként, illetve egy kötegben; a "méret" az intervallumok száma
+    auto intervals = [](int count, std::vector<double>& a, std::vector<double>& b) {
+        a.resize(count);
+        b.resize(count);
+        for (int k = 0; k < count; ++k) {
+            a[k] = -3.0 + 4.0 * k / count;
+            b[k] = a[k] + 0.5;
+        }
+    };
+    suite.add("integrate_loop", sweep(100, 100000, 10), [intervals](BenchState& st, int count) {
+        std::vector<double> a, b, r(count);
+        intervals(count, a, b);
+        auto f = [](double x) { return std::exp(-x * x) * std::cos(x); };
+        while (st.keep_running()) {
+            for (int k = 0; k < count; ++k) r[k] = integrate(f, a[k], b[k], 100);
+            do_not_optimize(r[0]);
+        }
+        st.set_items(101.0 * count);
+    });
+    suite.add("integrate_batch", sweep(100, 100000, 10), [intervals](BenchState& st, int count) {
+        std::vector<double> a, b, r(count);
+        intervals(count, a, b);
+        auto f = [](double x) { return std::exp(-x * x) * std::cos(x); };
+        while (st.keep_running()) {
+            integrate_batch(f, a.data(), b.data(), 100, r.data(), count);
+            do_not_optimize(r[0]);
+        }
+        st.set_items(101.0 * count);
+    });
+
+    // Adaptív kvadratúra ugyanarra az integrandusra; a "méret" a kért relatív pontosság: 10^-k
+    auto adaptive = [](bool kronrod) {
+        return [kronrod](BenchState& st, int k) {
+            QuadratureOptions opt;
+            opt.abs_tol = 0.0;
+            opt.rel_tol = std::pow(10.0, -k);
+            auto f = [](double x) { return std::exp(-x * x) * std::cos(x); };
+            QuadratureResult r;
+            while (st.keep_running()) {
+                r = kronrod ? gauss_kronrod(f, -1.0, 3.0, opt) : adaptive_simpson(f, -1.0, 3.0, opt);
+                do_not_optimize(r.value);
+            }
+            st.set_items(static_cast<double>(r.evaluations));
+        };
+    };
+    suite.add("adaptive_simpson", {6, 9, 12}, adaptive(false));
+    suite.add("gauss_kronrod", {6, 9, 12}, adaptive(true));
+    // Romberg a 10^-6 pontosságról folytatva 10^-k-ig (az első lépés is benne van)
+    suite.add("romberg_resume", {9, 12}, [](BenchState& st, int k) {
+        QuadratureOptions coarse, fine;
+        coarse.abs_tol = fine.abs_tol = 0.0;
+        coarse.rel_tol = 1e-6;
+        fine.rel_tol = std::pow(10.0, -k);
+        QuadratureResult r;
+        while (st.keep_running()) {
+            Romberg rb([](double x) { return std::exp(-x * x) * std::cos(x); }, -1.0, 3.0);
+            rb.integrate_to(coarse);
+            r = rb.integrate_to(fine);
+            do_not_optimize(r.value);
+        }
+        st.set_items(static_cast<double>(r.evaluations));
+    });
+
+    register_small<2>(suite);
+    register_small<3>(suite);
+    register_small<4>(suite);
+    register_batch(suite);
+    register_vector2(suite);
+    register_pade(suite);
+    register_sparse(suite);
+    register_krylov(suite);
+    register_structured(suite);
+}
+
+void print_usage(const char* prog) {
+    std::cout << "Használat: " << prog << " [max_n [max_szál [max_transzponálás]]] [kapcsolók]\n"
+              << "  --filter=SZÖVEG    csak a nevükben SZÖVEG-et tartalmazó mérések\n"
+              << "  --min-time=MP      mérésenkénti minimális idő (alap: 0.2 s)\n"
+              << "  --json=FÁJL        eredmények JSON-ba\n"
+              << "  --baseline=FÁJL    összevetés egy korábbi JSON-nal\n"
+              << "  --suite-only       csak a méréssorozat, a részletes összevetések nélkül\n";
+}
+
+int main(int argc, char** argv) {
+    std::vector<int> positional;
+    std::string filter, json_path, baseline_path;
+    double min_time = 0.2;
+    bool reports = true;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&](const char* key) { return arg.substr(std::strlen(key)); };
+        if (arg.rfind("--filter=", 0) == 0) filter = value("--filter=");
+        else if (arg.rfind("--min-time=", 0) == 0) min_time = std::atof(value("--min-time=").c_str());
+        else if (arg.rfind("--json=", 0) == 0) json_path = value("--json=");
+        else if (arg.rfind("--baseline=", 0) == 0) baseline_path = value("--baseline=");
+        else if (arg == "--suite-only") reports = false;
+        else if (arg == "--help" || arg == "-h") { print_usage(argv[0]); return 0; }
+        else if (!arg.empty() && arg[0] != '-') positional.push_back(std::atoi(arg.c_str()));
+        else { print_usage(argv[0]); return 1; }
+    }
+
+    int max_n = positional.size() > 0 ? positional[0] : 1024;
+    unsigned max_threads = positional.size() > 1 ? static_cast<unsigned>(positional[1])
+                                                 : ThreadPool::default_threads();
+    // 16384-hez két 2 GiB-os mátrix kell, ezért alapból csak 4096-ig
+    int max_transpose = positional.size() > 2 ? positional[2] : 4096;
+
+    BenchSuite suite;
+    register_suite(suite, max_n);
+    std::map<std::string, double> baseline;
+    if (!baseline_path.empty()) baseline = BenchSuite::read_baseline(baseline_path);
+    std::cout << "==== Méréssorozat (" << get_num_threads() << " szál) ====\n";
+    suite.run(filter, min_time, baseline);
+
+    if (!json_path.empty()) {
+        const char* levels[] = {"scalar", "sse2", "avx2", "avx512"};
+        std::ofstream out(json_path);
+        suite.write_json(out, {{"threads", std::to_string(get_num_threads())},
+                               {"simd_level", levels[static_cast<int>(simd_level())]},
+                               {"max_n", std::to_string(max_n)}});
+        std::cout << "JSON: " << json_path << "\n";
+    }
+    if (!reports) return 0;
+
+    set_num_threads(1);
+    bench_gemm(max_n);
+    bench_threads(max_n, max_threads);
+    bench_repeated_solve(std::min(max_n, 512), 20);
+    bench_expression(max_n);
+    bench_strassen(std::max(1024, 2 * max_n));
+    bench_allocator(64, 2000);
+    bench_transpose(max_transpose);
+    set_num_threads(1);
+    bench_elementwise(512);
+    bench_elementwise(max_n);
+    return 0;
+}
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/*
+ Kis, Google Benchmark-szerű mérőkeret (külső függőség nélkül)
+
+ Egy mérés egy függvény, ami a beállítás után a
+     while (st.keep_running()) { ... }
+ ciklusban futtatja a mért kódot, és megadja az iterációnkénti munkát
+ (set_flops, set_bytes, set_items). A keret az iterációszámot addig
+ növeli, amíg a mérés el nem éri a min_time-ot, majd ebből számol
+ időt, GFLOP/s-t, GB/s-t és elem/s-t.
+
+ Az eredmények JSON-ba írhatók, és egy korábbi JSON-nal (baseline)
+ összevetve futásonkénti gyorsulás is kiírható, így a teljesítmény-
+ visszaesések észrevehetők.
+*/
+
+// A fordító ne dobhassa el a mért számítás eredményét
+template<typename T>
+inline void do_not_optimize(T const& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile char sink;
+    sink = *reinterpret_cast<char const volatile*>(&value);
+#endif
+}
+
+class BenchState {
+    using clock = std::chrono::steady_clock;
+
+    long long target_;
+    long long done_ = 0;
+    clock::time_point start_, stop_;
+    double flops_ = 0, bytes_ = 0, items_ = 0;
+
+public:
+    explicit BenchState(long long iterations) : target_(iterations) {}
+
+    // Igaz, amíg van hátra iteráció; az első hívás indítja, az utolsó állítja le az órát
+    bool keep_running() {
+        if (done_ == 0) start_ = clock::now();
+        if (done_ < target_) {
+            ++done_;
+            return true;
+        }
+        stop_ = clock::now();
+        return false;
+    }
+
+    // Iterációnkénti munka
+    void set_flops(double f) { flops_ = f; }
+    void set_bytes(double b) { bytes_ = b; }
+    void set_items(double i) { items_ = i; }
+
+    long long iterations() const { return done_; }
+    double seconds() const { return std::chrono::duration<double>(stop_ - start_).count(); }
+    double flops() const { return flops_; }
+    double bytes() const { return bytes_; }
+    double items() const { return items_; }
+};
+
+struct BenchResult {
+    std::string name;       // pl. "multiply/256"
+    long long iterations;
+    double seconds_per_iter;
+    double gflops;          // 0, ha nem értelmezett
+    double gbytes;          // GB/s
+    double items_per_sec;
+};
+
+class BenchSuite {
+    struct Entry {
+        std::string name;
+        std::vector<int> sizes;
+        std::function<void(BenchState&, int)> fn;
+    };
+    std::vector<Entry> entries_;
+    std::vector<BenchResult> results_;
+
+    static BenchResult measure(std::string const& name, std::function<void(BenchState&, int)> const& fn,
+                               int n, double min_time) {
+        long long iterations = 1;
+        for (;;) {
+            BenchState st(iterations);
+            fn(st, n);
+            double t = st.seconds();
+            // Elég hosszú mérés, vagy az iterációszám már irreálisan nagy
+            if (t >= min_time || iterations >= (1LL << 30)) {
+                double per_iter = t / st.iterations();
+                return {name + "/" + std::to_string(n), st.iterations(), per_iter,
+                        st.flops() / per_iter * 1e-9, st.bytes() / per_iter * 1e-9,
+                        st.items() / per_iter};
+            }
+            // Becslés a következő körre (legfeljebb tízszeres lépéssel, mint a Google Benchmark)
+            double factor = t > 0 ? std::min(10.0, 1.4 * min_time / t) : 10.0;
+            iterations = std::max(iterations + 1, static_cast<long long>(iterations * factor));
+        }
+    }
+
+public:
+    // Egy mérés a megadott méretekre; fn(st, n)
+    void add(std::string name, std::vector<int> sizes, std::function<void(BenchState&, int)> fn) {
+        entries_.push_back({std::move(name), std::move(sizes), std::move(fn)});
+    }
+
+    // Minden mérés futtatása, amelynek neve tartalmazza a filter-t (üres: mind)
+    void run(std::string const& filter, double min_time, std::map<std::string, double> const& baseline = {}) {
+        std::cout << std::left << std::setw(36) << "benchmark" << std::right
+                  << std::setw(14) << "time/iter" << std::setw(12) << "iters"
+                  << std::setw(11) << "GFLOP/s" << std::setw(11) << "GB/s"
+                  << std::setw(13) << "items/s";
+        if (!baseline.empty()) std::cout << std::setw(10) << "vs. base";
+        std::cout << "\n";
+        for (auto const& e : entries_) {
+            if (!filter.empty() && e.name.find(filter) == std::string::npos) continue;
+            for (int n : e.sizes) {
+                BenchResult r = measure(e.name, e.fn, n, min_time);
+                results_.push_back(r);
+                print(r, baseline);
+            }
+        }
+    }
+
+    std::vector<BenchResult> const& results() const { return results_; }
+
+    // Google Benchmark-hoz hasonló JSON (context + benchmarks tömb, ns-ban)
+    void write_json(std::ostream& os, std::map<std::string, std::string> const& context) const {
+        os << "{\n  \"context\": {\n";
+        std::time_t now = std::time(nullptr);
+        char date[32];
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+        os << "    \"date\": \"" << date << "\"";
+        for (auto const& kv : context)
+            os << ",\n    \"" << kv.first << "\": \"" << kv.second << "\"";
+        os << "\n  },\n  \"benchmarks\": [";
+        for (std::size_t i = 0; i < results_.size(); ++i) {
+            BenchResult const& r = results_[i];
+            os << (i ? ",\n" : "\n") << "    {\"name\": \"" << r.name << "\", "
+               << "\"iterations\": " << r.iterations << ", "
+               << std::setprecision(9)
+               << "\"real_time\": " << r.seconds_per_iter * 1e9 << ", \"time_unit\": \"ns\", "
+               << "\"gflops\": " << r.gflops << ", "
+               << "\"bytes_per_second\": " << r.gbytes * 1e9 << ", "
+               << "\"items_per_second\": " << r.items_per_sec << "}";
+        }
+        os << "\n  ]\n}\n" << std::defaultfloat;
+    }
+
+    /*
+     Korábbi JSON kimenet beolvasása: név -> real_time (ns)
+     Csak a write_json által írt formátumot ismeri (soronként egy mérés).
+    */
+    static std::map<std::string, double> read_baseline(std::string const& path) {
+        std::map<std::string, double> times;
+        std::ifstream in(path);
+        if (!in) throw std::runtime_error("Cannot open baseline file: " + path);
+        std::string line;
+        while (std::getline(in, line)) {
+            auto name_pos = line.find("\"name\": \"");
+            auto time_pos = line.find("\"real_time\": ");
+            if (name_pos == std::string::npos || time_pos == std::string::npos) continue;
+            name_pos += 9;
+            std::string name = line.substr(name_pos, line.find('"', name_pos) - name_pos);
+            times[name] = std::stod(line.substr(time_pos + 13));
+        }
+        return times;
+    }
+
+private:
+    static void print(BenchResult const& r, std::map<std::string, double> const& baseline) {
+        std::ostringstream t;
+        double s = r.seconds_per_iter;
+        t << std::fixed << std::setprecision(2);
+        if (s < 1e-6) t << s * 1e9 << " ns";
+        else if (s < 1e-3) t << s * 1e6 << " us";
+        else if (s < 1) t << s * 1e3 << " ms";
+        else t << s << " s";
+
+        std::cout << std::left << std::setw(36) << r.name << std::right
+                  << std::setw(14) << t.str() << std::setw(12) << r.iterations
+                  << std::fixed << std::setprecision(2)
+                  << std::setw(11) << r.gflops << std::setw(11) << r.gbytes
+                  << std::setw(13) << std::scientific << r.items_per_sec << std::fixed;
+        if (!baseline.empty()) {
+            auto it = baseline.find(r.name);
+            if (it != baseline.end())
+                std::cout << std::setw(9) << it->second / (s * 1e9) << "x";
+            else
+                std::cout << std::setw(10) << "-";
+        }
+        std::cout << std::defaultfloat << "\n";
+    }
+};
@@ -0,0 +1,342 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "matrix.h"
+
+/*
+ Szimmetrikus mátrixok felbontásai: Cholesky (A = L * L^T) és LDL^T
+
+ Szimmetrikus pozitív definit (SPD) mátrixra, pl. kovariancia- vagy
+ merevségi mátrixra, a Cholesky-felbontás ~n^3/3 szorzás-összeadás, fele
+ az LU-nak, és nem kell főelemet keresni. Indefinit szimmetrikus mátrixra
+ az LDL^T (L egységdiagonálisú, D diagonális) ugyanennyibe kerül, de
+ főelemcsere nélkül csak akkor működik, ha a bal felső minorok nem
+ nullák (pl. kvázidefinit, nyeregpont-jellegű mátrixok); különben a D
+ nulla eleménél megáll, mint a szinguláris LU.
+
+ Mindkét felbontás csak az alsó háromszöget olvassa és írja: a felső
+ háromszög (a főátló felett) érintetlen marad, ott bármi lehet.
+
+ Jobbra haladó blokkosított algoritmus, lu_block széles panelekkel:
+   1. a diagonális blokk felbontása (skalár kernel, L1-ben marad),
+   2. a panel alatti rész: L21 = A21 * L11^-T (* D1^-1), soronként párhuzamosan,
+   3. A22 -= L21 * L21^T (D1-gyel súlyozva), csak az alsó háromszögben:
+      a blokksorok téglalap részét a GEMM számolja, a diagonális blokk
+      alsó felét skalár ciklus; a blokksorok párhuzamosan futnak.
+
+   Cholesky<double> ch(A);
+   auto x = ch.solve(b);  auto ld = ch.log_det();  auto Ainv = ch.inverse();
+*/
+namespace matrix_kernels {
+
+namespace detail {
+
+// A22 -= W * L21^T az alsó háromszögben (W = L21 vagy L21 * D1), rest x rest, nb mélység
+template<typename T>
+void syrk_lower(int rest, int nb, T const* w, int ldw, T const* l, int ldl, T* a, int lda) {
+    auto rows = [&](int b0, int b1) {
+        for (int bi = b0; bi < b1; ++bi) {
+            int i0 = bi * lu_block, ib = std::min(lu_block, rest - i0);
+            // Téglalap rész a diagonális blokktól balra
+            if (i0 > 0)
+                gemm(ib, i0, nb, T{-1}, w + i0 * ldw, ldw, 1, l, 1, ldl, a + i0 * lda, lda, 1);
+            // A diagonális blokk alsó háromszöge
+            for (int i = i0; i < i0 + ib; ++i) {
+                T const* wi = w + i * ldw;
+                T* ai = a + i * lda;
+                for (int j = i0; j <= i; ++j) {
+                    T const* lj = l + j * ldl;
+                    T s{};
+                    for (int p = 0; p < nb; ++p) s += wi[p] * lj[p];
+                    ai[j] -= s;
+                }
+            }
+        }
+    };
+    int blocks = (rest + lu_block - 1) / lu_block;
+    if (static_cast<long long>(rest) * rest * nb < 2 * gemm_parallel_threshold)
+        rows(0, blocks);
+    else
+        parallel_for(0, blocks, 1, rows);
+}
+
+// Soronként x * L11^T = a (L11: nb x nb alsó háromszög, egységdiagonálisú, ha unit), rows sor
+template<typename T>
+void trsm_lower_t(int rows, int nb, T const* l11, int lda, T* a, bool unit) {
+    parallel_for(0, rows, std::max(1, (1 << 14) / std::max(1, nb * nb)), [&](int r0, int r1) {
+        for (int r = r0; r < r1; ++r) {
+            T* x = a + r * lda;
+            for (int j = 0; j < nb; ++j) {
+                T s = x[j];
+                T const* lj = l11 + j * lda;
+                for (int p = 0; p < j; ++p) s -= x[p] * lj[p];
+                x[j] = unit ? s : s / lj[j];
+            }
+        }
+    });
+}
+
+} // namespace detail
+
+/*
+ Cholesky-felbontás helyben: a alsó háromszögébe L kerül
+ Visszatérés: az első nem pozitív főelem oszlopa (a mátrix nem SPD), vagy -1.
+*/
+template<typename T>
+int cholesky_factor(int n, T* a, int lda) {
+    for (int k = 0; k < n; k += lu_block) {
+        int nb = std::min(lu_block, n - k);
+        T* akk = a + k * lda + k;
+        for (int j = 0; j < nb; ++j) {
+            T* aj = akk + j * lda;
+            T d = aj[j];
+            for (int p = 0; p < j; ++p) d -= aj[p] * aj[p];
+            if (!(d > T{})) return k + j;
+            d = std::sqrt(d);
+            aj[j] = d;
+            for (int i = j + 1; i < nb; ++i) {
+                T* ai = akk + i * lda;
+                T s = ai[j];
+                for (int p = 0; p < j; ++p) s -= ai[p] * aj[p];
+                ai[j] = s / d;
+            }
+        }
+        int rest = n - k - nb;
+        if (rest <= 0) break;
+        T* a21 = a + (k + nb) * lda + k;
+        detail::trsm_lower_t(rest, nb, akk, lda, a21, false);
+        detail::syrk_lower(rest, nb, a21, lda, a21, lda, a + (k + nb) * lda + k + nb, lda);
+    }
+    return -1;
+}
+
+/*
+ LDL^T-felbontás helyben főelemcsere nélkül: a szigorú alsó háromszögébe
+ L (egységdiagonálisú), főátlójába D kerül
+ Visszatérés: az első (közel) nulla D elem oszlopa, vagy -1.
+*/
+template<typename T>
+int ldlt_factor(int n, T* a, int lda) {
+    std::vector<T> w;
+    for (int k = 0; k < n; k += lu_block) {
+        int nb = std::min(lu_block, n - k);
+        T* akk = a + k * lda + k;
+        for (int j = 0; j < nb; ++j) {
+            T* aj = akk + j * lda;
+            T d = aj[j];
+            for (int p = 0; p < j; ++p) d -= aj[p] * aj[p] * akk[p * lda + p];
+            if (std::abs(d) < lu_singular_tolerance) return k + j;
+            aj[j] = d;
+            for (int i = j + 1; i < nb; ++i) {
+                T* ai = akk + i * lda;
+                T s = ai[j];
+                for (int p = 0; p < j; ++p) s -= ai[p] * aj[p] * akk[p * lda + p];
+                ai[j] = s / d;
+            }
+        }
+        int rest = n - k - nb;
+        if (rest <= 0) break;
+        T* a21 = a + (k + nb) * lda + k;
+        // L21 * D1 = A21 * L11^-T, ezt W-ben megtartjuk a frissítéshez, majd L21 = W * D1^-1
+        detail::trsm_lower_t(rest, nb, akk, lda, a21, true);
+        w.resize(static_cast<std::size_t>(rest) * nb);
+        for (int i = 0; i < rest; ++i)
+            for (int p = 0; p < nb; ++p) {
+                T& x = a21[i * lda + p];
+                w[static_cast<std::size_t>(i) * nb + p] = x;
+                x /= akk[p * lda + p];
+            }
+        detail::syrk_lower(rest, nb, w.data(), nb, a21, lda, a + (k + nb) * lda + k + nb, lda);
+    }
+    return -1;
+}
+
+/*
+ L * L^T * X = B vagy L * D * L^T * X = B, B helyén (n x nrhs, ldb sorhossz)
+ Előre helyettesítés L-lel soronkénti axpy-val, vissza L^T-vel (L sorai
+ L^T oszlopai, így az is folytonosan olvas).
+*/
+template<typename T>
+void symmetric_solve(int n, T const* l, int lda, T* b, int nrhs, int ldb, bool ldlt) {
+    for (int i = 0; i < n; ++i) {
+        T* bi = b + i * ldb;
+        T const* li = l + i * lda;
+        for (int r = 0; r < i; ++r) {
+            T v = li[r];
+            if (v == T{}) continue;
+            T const* br = b + r * ldb;
+            for (int c = 0; c < nrhs; ++c) bi[c] -= v * br[c];
+        }
+        if (!ldlt)
+            for (int c = 0; c < nrhs; ++c) bi[c] /= li[i];
+    }
+    if (ldlt)
+        for (int i = 0; i < n; ++i)
+            for (int c = 0; c < nrhs; ++c) b[i * ldb + c] /= l[i * lda + i];
+    for (int i = n - 1; i >= 0; --i) {
+        T* bi = b + i * ldb;
+        T const* li = l + i * lda;
+        if (!ldlt)
+            for (int c = 0; c < nrhs; ++c) bi[c] /= li[i];
+        for (int r = 0; r < i; ++r) {
+            T v = li[r];
+            if (v == T{}) continue;
+            T* br = b + r * ldb;
+            for (int c = 0; c < nrhs; ++c) br[c] -= v * bi[c];
+        }
+    }
+}
+
+} // namespace matrix_kernels
+
+/*
+ Újrahasznosítható Cholesky-felbontás SPD mátrixra
+ Ha A nem pozitív definit, positive_definite() hamis, a megoldók és a
+ determináns (det(), log_det()) kivételt dobnak.
+*/
+template<typename T>
+class Cholesky {
+    Matrix<T> l_;
+    int failed_col_;
+
+    void require_spd() const {
+        if (failed_col_ >= 0)
+            throw std::runtime_error("Matrix is not positive definite");
+    }
+
+public:
+    explicit Cholesky(Matrix<T> a) : l_(std::move(a)) {
+        check_same_size(l_.rows(), l_.cols());
+        failed_col_ = matrix_kernels::cholesky_factor(l_.rows(), l_.data(), l_.rows());
+    }
+
+    int size() const { return l_.rows(); }
+    bool positive_definite() const { return failed_col_ < 0; }
+
+    // L a tároló alsó háromszögében (a felső háromszög az eredeti A-é)
+    Matrix<T> const& factors() const { return l_; }
+
+    // L külön mátrixként, nullákkal a főátló felett
+    Matrix<T> lower() const {
+        require_spd();
+        Matrix<T> l(size(), size(), T{});
+        for (int i = 0; i < size(); ++i)
+            for (int j = 0; j <= i; ++j) l(i, j) = l_(i, j);
+        return l;
+    }
+
+    // log det A = 2 * sum log L(i, i); nagy n-nél a det() túlcsordulna
+    T log_det() const {
+        require_spd();
+        T s{};
+        for (int i = 0; i < size(); ++i) s += std::log(l_(i, i));
+        return 2 * s;
+    }
+
+    T det() const { return std::exp(log_det()); }
+
+    std::vector<T> solve(std::vector<T> b) const {
+        if (static_cast<int>(b.size()) != size())
+            throw MatrixSizeMismatch();
+        require_spd();
+        matrix_kernels::symmetric_solve(size(), l_.data(), size(), b.data(), 1, 1, false);
+        return b;
+    }
+
+    Matrix<T> solve(Matrix<T> B) const {
+        check_same_size(B.rows(), size());
+        require_spd();
+        matrix_kernels::symmetric_solve(size(), l_.data(), size(), B.data(), B.cols(), B.cols(), false);
+        return B;
+    }
+
+    Matrix<T> inverse() const {
+        return solve(Matrix<T>::identity(size()));
+    }
+};
+
+/*
+ LDL^T-felbontás szimmetrikus (akár indefinit) mátrixra, főelemcsere nélkül
+ A D előjelei adják A tehetetlenségét (pozitív / negatív sajátértékek száma).
+*/
+template<typename T>
+class LDLT {
+    Matrix<T> ld_;
+    int singular_col_;
+
+    void require_regular() const {
+        if (singular_col_ >= 0)
+            throw std::runtime_error("Matrix is singular or needs pivoting");
+    }
+
+public:
+    explicit LDLT(Matrix<T> a) : ld_(std::move(a)) {
+        check_same_size(ld_.rows(), ld_.cols());
+        singular_col_ = matrix_kernels::ldlt_factor(ld_.rows(), ld_.data(), ld_.rows());
+    }
+
+    int size() const { return ld_.rows(); }
+    bool singular() const { return singular_col_ >= 0; }
+
+    // L (egységdiagonálissal, nem tárolt) és D a tároló alsó háromszögében
+    Matrix<T> const& factors() const { return ld_; }
+
+    std::vector<T> d() const {
+        require_regular();
+        std::vector<T> d(size());
+        for (int i = 0; i < size(); ++i) d[i] = ld_(i, i);
+        return d;
+    }
+
+    // D pozitív és negatív elemeinek száma (Sylvester tehetetlenségi tétele)
+    std::pair<int, int> inertia() const {
+        require_regular();
+        int pos = 0;
+        for (int i = 0; i < size(); ++i) pos += ld_(i, i) > T{};
+        return {pos, size() - pos};
+    }
+
+    T det() const {
+        if (singular()) return T{};
+        T d = 1;
+        for (int i = 0; i < size(); ++i) d *= ld_(i, i);
+        return d;
+    }
+
+    // log |det A| és az előjel (det = sign * exp(log_abs_det))
+    T log_abs_det() const {
+        require_regular();
+        T s{};
+        for (int i = 0; i < size(); ++i) s += std::log(std::abs(ld_(i, i)));
+        return s;
+    }
+
+    int det_sign() const {
+        require_regular();
+        return inertia().second % 2 ? -1 : 1;
+    }
+
+    std::vector<T> solve(std::vector<T> b) const {
+        if (static_cast<int>(b.size()) != size())
+            throw MatrixSizeMismatch();
+        require_regular();
+        matrix_kernels::symmetric_solve(size(), ld_.data(), size(), b.data(), 1, 1, true);
+        return b;
+    }
+
+    Matrix<T> solve(Matrix<T> B) const {
+        check_same_size(B.rows(), size());
+        require_regular();
+        matrix_kernels::symmetric_solve(size(), ld_.data(), size(), B.data(), B.cols(), B.cols(), true);
+        return B;
+    }
+
+    Matrix<T> inverse() const {
+        return solve(Matrix<T>::identity(size()));
+    }
+};
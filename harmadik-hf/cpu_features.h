@@ -0,0 +1,49 @@
+#pragma once
+
+/*
+ Futásidejű CPU-képesség lekérdezés a SIMD kernelek kiválasztásához
+ x86-on GCC/Clang alatt a __builtin_cpu_supports-ot használjuk,
+ minden más esetben skalár szintet adunk, és a generikus út fut
+*/
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define MATRIX_X86_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+// Utasításkészlet-szintek növekvő sorrendben
+enum class SimdLevel { scalar = 0, sse2 = 1, avx2 = 2, avx512 = 3 };
+
+inline SimdLevel detect_simd_level() {
+#ifdef MATRIX_X86_DISPATCH
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return SimdLevel::avx512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return SimdLevel::avx2;
+    if (__builtin_cpu_supports("sse2"))
+        return SimdLevel::sse2;
+#endif
+    return SimdLevel::scalar;
+}
+
+inline SimdLevel& simd_level_slot() {
+    static SimdLevel level = detect_simd_level();
+    return level;
+}
+
+// Az aktuálisan használt szint (alapból a CPU által tudott legmagasabb)
+inline SimdLevel simd_level() { return simd_level_slot(); }
+
+/*
+ Szint lekorlátozása (teszteléshez, méréshez); a CPU-nál magasabbat nem enged
+ Visszaadja a ténylegesen beállított szintet.
+*/
+inline SimdLevel set_simd_level(SimdLevel level) {
+    SimdLevel max = detect_simd_level();
+    simd_level_slot() = static_cast<int>(level) < static_cast<int>(max) ? level : max;
+    return simd_level_slot();
+}
+
+// AVX2 + FMA (Haswell óta)
+inline bool cpu_has_avx2_fma() {
+    return static_cast<int>(simd_level()) >= static_cast<int>(SimdLevel::avx2);
+}
@@ -0,0 +1,297 @@
+#pragma once
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+#include "cpu_features.h"
+#include "pool_allocator.h"
+#include "thread_pool.h"
+
+/*
+ Blokkosított, csomagolt mátrixszorzás (GEMM)
+ C += alpha * A * B, ahol A: m x k, B: k x n, C: m x n
+
+ Minden operandust sor- és oszloplépéssel (rs, cs) adunk meg, így
+ sorfolytonos, oszlopfolytonos és transzponált elrendezés is működik.
+
+ Felépítés (Goto-féle ciklussorrend):
+   jc: NC oszlopos B-blokk  (L3)
+   pc: KC mélységű szelet   (B-panel csomagolása, L2/L3)
+   ic: MC soros A-blokk     (A-blokk csomagolása, L2)
+   jr/ir: MR x NR-es csempék, ezeket a regiszterben tartott
+          mikrokernel számolja (L1)
+
+ float/double esetén csomagolt, regisztercsempés út fut (AVX2+FMA
+ kernellel, ha a CPU tudja), minden más T-re egyszerű i-k-j ciklus.
+ Nagy szorzatoknál a C csempéit a globális szálkészlet osztja szét.
+*/
+namespace matrix_kernels {
+
+// Blokkméretek típusonként; a 0 MR jelzi, hogy nincs csomagolt út
+template<typename T>
+struct gemm_blocking {
+    static constexpr int MR = 0, NR = 0, KC = 0, MC = 0, NC = 0;
+};
+
+template<>
+struct gemm_blocking<double> {
+    static constexpr int MR = 6, NR = 8, KC = 256, MC = 72, NC = 4096;
+};
+
+template<>
+struct gemm_blocking<float> {
+    static constexpr int MR = 6, NR = 16, KC = 256, MC = 96, NC = 4096;
+};
+
+template<typename T>
+constexpr bool gemm_is_packed() { return gemm_blocking<T>::MR > 0; }
+
+// Ennyi szorzás-összeadás alatt nem éri meg szálakra bontani (kb. 128^3)
+constexpr long long gemm_parallel_threshold = 128LL * 128 * 128;
+
+/*
+ A-blokk csomagolása: mc x kc-s részt MR magas panelekre bontunk,
+ panelen belül oszlopfolytonosan; a szélső panelt nullával töltjük ki.
+ Az alpha-val itt szorzunk, így a mikrokernelnek nem kell vele törődnie.
+*/
+template<typename T, int MR>
+void pack_a(int mc, int kc, T alpha, const T* a, int rs_a, int cs_a, T* dst) {
+    for (int i0 = 0; i0 < mc; i0 += MR) {
+        int mr = std::min(MR, mc - i0);
+        for (int p = 0; p < kc; ++p) {
+            const T* src = a + i0 * rs_a + p * cs_a;
+            int i = 0;
+            for (; i < mr; ++i) dst[i] = alpha * src[i * rs_a];
+            for (; i < MR; ++i) dst[i] = T{};
+            dst += MR;
+        }
+    }
+}
+
+// B-panel csomagolása: kc x nc-s részt NR széles panelekre, panelen belül sorfolytonosan
+template<typename T, int NR>
+void pack_b(int kc, int nc, const T* b, int rs_b, int cs_b, T* dst) {
+    for (int j0 = 0; j0 < nc; j0 += NR) {
+        int nr = std::min(NR, nc - j0);
+        for (int p = 0; p < kc; ++p) {
+            const T* src = b + p * rs_b + j0 * cs_b;
+            int j = 0;
+            for (; j < nr; ++j) dst[j] = src[j * cs_b];
+            for (; j < NR; ++j) dst[j] = T{};
+            dst += NR;
+        }
+    }
+}
+
+/*
+ Generikus mikrokernel: c[MR x NR] += a_panel * b_panel
+ A fix méretű akkumulátortömböt a fordító regiszterekben tartja és vektorizálja.
+*/
+template<typename T, int MR, int NR>
+void micro_kernel_generic(int kc, const T* a, const T* b, T* c, int rs_c) {
+    T acc[MR][NR] = {};
+    for (int p = 0; p < kc; ++p) {
+        for (int i = 0; i < MR; ++i) {
+            T ai = a[i];
+            for (int j = 0; j < NR; ++j)
+                acc[i][j] += ai * b[j];
+        }
+        a += MR;
+        b += NR;
+    }
+    for (int i = 0; i < MR; ++i)
+        for (int j = 0; j < NR; ++j)
+            c[i * rs_c + j] += acc[i][j];
+}
+
+#ifdef MATRIX_X86_DISPATCH
+// 6x8-as double mikrokernel: 12 ymm akkumulátor, soronként két 4-es vektor
+__attribute__((target("avx2,fma")))
+inline void micro_kernel_avx2(int kc, const double* a, const double* b, double* c, int rs_c) {
+    __m256d acc[6][2];
+    for (int i = 0; i < 6; ++i) acc[i][0] = acc[i][1] = _mm256_setzero_pd();
+    for (int p = 0; p < kc; ++p) {
+        __m256d b0 = _mm256_loadu_pd(b);
+        __m256d b1 = _mm256_loadu_pd(b + 4);
+        for (int i = 0; i < 6; ++i) {
+            __m256d ai = _mm256_broadcast_sd(a + i);
+            acc[i][0] = _mm256_fmadd_pd(ai, b0, acc[i][0]);
+            acc[i][1] = _mm256_fmadd_pd(ai, b1, acc[i][1]);
+        }
+        a += 6;
+        b += 8;
+    }
+    for (int i = 0; i < 6; ++i) {
+        double* ci = c + i * rs_c;
+        _mm256_storeu_pd(ci, _mm256_add_pd(_mm256_loadu_pd(ci), acc[i][0]));
+        _mm256_storeu_pd(ci + 4, _mm256_add_pd(_mm256_loadu_pd(ci + 4), acc[i][1]));
+    }
+}
+
+// 6x16-os float mikrokernel: ugyanaz a séma 8-as float vektorokkal
+__attribute__((target("avx2,fma")))
+inline void micro_kernel_avx2(int kc, const float* a, const float* b, float* c, int rs_c) {
+    __m256 acc[6][2];
+    for (int i = 0; i < 6; ++i) acc[i][0] = acc[i][1] = _mm256_setzero_ps();
+    for (int p = 0; p < kc; ++p) {
+        __m256 b0 = _mm256_loadu_ps(b);
+        __m256 b1 = _mm256_loadu_ps(b + 8);
+        for (int i = 0; i < 6; ++i) {
+            __m256 ai = _mm256_broadcast_ss(a + i);
+            acc[i][0] = _mm256_fmadd_ps(ai, b0, acc[i][0]);
+            acc[i][1] = _mm256_fmadd_ps(ai, b1, acc[i][1]);
+        }
+        a += 6;
+        b += 16;
+    }
+    for (int i = 0; i < 6; ++i) {
+        float* ci = c + i * rs_c;
+        _mm256_storeu_ps(ci, _mm256_add_ps(_mm256_loadu_ps(ci), acc[i][0]));
+        _mm256_storeu_ps(ci + 8, _mm256_add_ps(_mm256_loadu_ps(ci + 8), acc[i][1]));
+    }
+}
+#endif
+
+template<typename T>
+using micro_kernel_fn = void (*)(int, const T*, const T*, T*, int);
+
+template<typename T>
+micro_kernel_fn<T> select_micro_kernel() {
+    using B = gemm_blocking<T>;
+#ifdef MATRIX_X86_DISPATCH
+    if (cpu_has_avx2_fma())
+        return static_cast<micro_kernel_fn<T>>(&micro_kernel_avx2);
+#endif
+    return &micro_kernel_generic<T, B::MR, B::NR>;
+}
+
+/*
+ Makrokernel: egy csomagolt A-blokk (mc x kc) és B-panel (kc x nc) szorzata C-be
+ A teljes csempék közvetlenül C-be íródnak, a szélsők egy helyi pufferen át.
+*/
+template<typename T>
+void macro_kernel(int mc, int nc, int kc, const T* pa, const T* pb,
+                  T* c, int rs_c, int cs_c, micro_kernel_fn<T> kernel) {
+    constexpr int MR = gemm_blocking<T>::MR, NR = gemm_blocking<T>::NR;
+    T tile[MR * NR];
+    for (int jr = 0; jr < nc; jr += NR) {
+        int nr = std::min(NR, nc - jr);
+        const T* b_panel = pb + jr * kc;
+        for (int ir = 0; ir < mc; ir += MR) {
+            int mr = std::min(MR, mc - ir);
+            const T* a_panel = pa + ir * kc;
+            T* c_tile = c + ir * rs_c + jr * cs_c;
+            if (mr == MR && nr == NR && cs_c == 1) {
+                kernel(kc, a_panel, b_panel, c_tile, rs_c);
+            } else {
+                std::fill(tile, tile + MR * NR, T{});
+                kernel(kc, a_panel, b_panel, tile, NR);
+                for (int i = 0; i < mr; ++i)
+                    for (int j = 0; j < nr; ++j)
+                        c_tile[i * rs_c + j * cs_c] += tile[i * NR + j];
+            }
+        }
+    }
+}
+
+/*
+ Csomagolt út float/double-ra
+ A B-panelt hívásonként egyszer csomagoljuk (párhuzamosan, NR-es sávonként),
+ utána a C-t (A-blokk x oszlopcsoport) csempékre bontjuk, ezek a
+ szálkészlet feladatai. Az A-blokk puffere szálanként újrahasznosul.
+*/
+template<typename T>
+void gemm_packed(int m, int n, int k, T alpha,
+                 const T* a, int rs_a, int cs_a,
+                 const T* b, int rs_b, int cs_b,
+                 T* c, int rs_c, int cs_c) {
+    using B = gemm_blocking<T>;
+    micro_kernel_fn<T> kernel = select_micro_kernel<T>();
+    std::vector<T, PoolAllocator<T>> buf_b;  // ismétlődő szorzásnál a készletből jön
+
+    // Soros út kis szorzatra vagy egy szálra; különben annyi oszlopcsoport,
+    // hogy szálanként legalább 4 csempe jusson, de egy csoport se legyen túl keskeny
+    ThreadPool& pool = ThreadPool::global();
+    bool serial = pool.size() == 1 ||
+                  static_cast<long long>(m) * n * k < gemm_parallel_threshold;
+    int m_blocks = (m + B::MC - 1) / B::MC;
+
+    for (int jc = 0; jc < n; jc += B::NC) {
+        int nc = std::min(B::NC, n - jc);
+        int nr_panels = (nc + B::NR - 1) / B::NR;
+        int col_groups = 1;
+        if (!serial) {
+            int wanted = (4 * static_cast<int>(pool.size()) + m_blocks - 1) / m_blocks;
+            col_groups = std::max(1, std::min(wanted, nr_panels / 8));
+        }
+        for (int pc = 0; pc < k; pc += B::KC) {
+            int kc = std::min(B::KC, k - pc);
+            buf_b.resize(static_cast<std::size_t>(kc) * nr_panels * B::NR);
+            const T* b_block = b + pc * rs_b + jc * cs_b;
+            pool.parallel_for(0, nr_panels, serial ? nr_panels : 16, [&](int lo, int hi) {
+                int j0 = lo * B::NR, j1 = std::min(nc, hi * B::NR);
+                pack_b<T, B::NR>(kc, j1 - j0, b_block + j0 * cs_b, rs_b, cs_b,
+                                 buf_b.data() + static_cast<std::size_t>(j0) * kc);
+            });
+
+            int tiles = m_blocks * col_groups;
+            pool.parallel_for(0, tiles, serial ? tiles : 1, [&](int lo, int hi) {
+                static thread_local std::vector<T> buf_a;
+                for (int t = lo; t < hi; ++t) {
+                    int ic = (t / col_groups) * B::MC;
+                    int g = t % col_groups;
+                    int mc = std::min(B::MC, m - ic);
+                    int p0 = nr_panels * g / col_groups, p1 = nr_panels * (g + 1) / col_groups;
+                    int j0 = p0 * B::NR, j1 = std::min(nc, p1 * B::NR);
+                    if (j0 >= j1) continue;
+                    int mc_padded = (mc + B::MR - 1) / B::MR * B::MR;
+                    buf_a.resize(static_cast<std::size_t>(mc_padded) * kc);
+                    pack_a<T, B::MR>(mc, kc, alpha, a + ic * rs_a + pc * cs_a, rs_a, cs_a, buf_a.data());
+                    macro_kernel<T>(mc, j1 - j0, kc, buf_a.data(),
+                                    buf_b.data() + static_cast<std::size_t>(j0) * kc,
+                                    c + ic * rs_c + (jc + j0) * cs_c, rs_c, cs_c, kernel);
+                }
+            });
+        }
+    }
+}
+
+// Generikus út tetszőleges T-re: i-k-j sorrend, a belső ciklus C és B sorain halad
+template<typename T>
+void gemm_reference(int m, int n, int k, T alpha,
+                    const T* a, int rs_a, int cs_a,
+                    const T* b, int rs_b, int cs_b,
+                    T* c, int rs_c, int cs_c) {
+    auto rows = [&](int i0, int i1) {
+        for (int i = i0; i < i1; ++i)
+            for (int p = 0; p < k; ++p) {
+                T aip = alpha * a[i * rs_a + p * cs_a];
+                const T* bp = b + p * rs_b;
+                T* ci = c + i * rs_c;
+                for (int j = 0; j < n; ++j)
+                    ci[j * cs_c] += aip * bp[j * cs_b];
+            }
+    };
+    if (static_cast<long long>(m) * n * k < gemm_parallel_threshold)
+        rows(0, m);
+    else
+        parallel_for(0, m, 8, rows);
+}
+
+template<typename T>
+void gemm(int m, int n, int k, T alpha,
+          const T* a, int rs_a, int cs_a,
+          const T* b, int rs_b, int cs_b,
+          T* c, int rs_c, int cs_c) {
+    if (m <= 0 || n <= 0 || k <= 0) return;
+    if constexpr (gemm_is_packed<T>()) {
+        // Kis szorzatoknál a csomagolás többe kerül, mint amennyit nyer
+        constexpr long long small_gemm = 32LL * 32 * 32;
+        if (static_cast<long long>(m) * n * k > small_gemm)
+            return gemm_packed(m, n, k, alpha, a, rs_a, cs_a, b, rs_b, cs_b, c, rs_c, cs_c);
+    }
+    gemm_reference(m, n, k, alpha, a, rs_a, cs_a, b, rs_b, cs_b, c, rs_c, cs_c);
+}
+
+} // namespace matrix_kernels
@@ -0,0 +1,481 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "matrix.h"
+#include "sparse_matrix.h"
+
+/*
+ Krylov-altér módszerek A * x = b megoldására, inverz nélkül
+
+   SparseMatrix<double> A = ...;
+   std::vector<double> x(n);                       // kezdőközelítés (itt 0)
+   KrylovOptions<double> opt;
+   opt.rel_tol = 1e-10;
+   KrylovResult<double> r = cg(A, b, x, opt, JacobiPreconditioner<double>(A));
+   // r.status, r.iterations, r.matvecs, r.residual (||b - A x||), r.history
+
+ Az operátor bármi lehet, ami mátrix-vektor szorzást ad:
+   - Matrix<T> (sűrű, gemv), SparseMatrix<T> (SpMV),
+   - vagy egy void(T const* x, T* y) hívható, ami y = A * x-et számol
+     (mátrixmentes operátor, pl. egy rácson közvetlenül).
+ Egy lépés költsége egy (BiCGSTAB-nál kettő) mat-vec és néhány vektor-
+ művelet, így a memória O(n) (GMRES-nél O(n * restart)).
+
+   cg       : szimmetrikus pozitív definit A-ra (előkondicionálva PCG;
+              ekkor M is legyen SPD, pl. Jacobi)
+   bicgstab : általános A, rövid rekurzió, jobbról előkondicionálva
+   gmres    : általános A, restart lépésenként újraindítva, jobbról
+              előkondicionálva; a maradék a lépések alatt nem nő
+
+ Előkondicionálók (z = M^-1 r): IdentityPreconditioner, Jacobi (a főátló
+ inverze) és ILU(0) (hiányos LU a ritka mátrix mintázatán). Saját is
+ adható egy apply(T const* r, T* z, int n) const tagfüggvénnyel.
+
+ Leállás: ||r|| <= max(abs_tol, rel_tol * ||b||), max_iterations, vagy ha
+ az opt.callback(iteráció, ||r||) hamisat ad. A végén a valódi maradékot
+ (b - A x) újraszámoljuk. A vektorműveletek nagy n-nél a szálkészleten
+ futnak, a skalárszorzatokat rögzített darabokban és sorrendben
+ összegezzük, így sűrű és CSR operátornál az eredmény nem függ a
+ szálszámtól.
+*/
+
+enum class KrylovStatus { converged, max_iterations, breakdown, stopped };
+
+template<typename T>
+struct KrylovOptions {
+    T rel_tol = T(1e-10);
+    T abs_tol = T(0);
+    int max_iterations = 1000;
+    int restart = 30;                       // GMRES: Krylov-altér mérete újraindításig
+    bool record_history = false;            // ||r|| minden lépés után a history-ba
+    std::function<bool(int, T)> callback;   // (iteráció, ||r||); false: leállítás
+};
+
+template<typename T>
+struct KrylovResult {
+    KrylovStatus status = KrylovStatus::max_iterations;
+    int iterations = 0;
+    int matvecs = 0;
+    T residual = T(0);           // ||b - A x|| a végén
+    T relative_residual = T(0);  // residual / ||b||
+    std::vector<T> history;
+
+    bool converged() const { return status == KrylovStatus::converged; }
+};
+
+/*
+ Előkondicionálók
+*/
+
+template<typename T>
+struct IdentityPreconditioner {
+    void apply(T const* r, T* z, int n) const { std::copy(r, r + n, z); }
+};
+
+// M = diag(A)
+template<typename T>
+class JacobiPreconditioner {
+    std::vector<T> inv_diag_;
+
+    void invert() {
+        for (T& d : inv_diag_) {
+            if (d == T{}) throw std::runtime_error("Zero diagonal in Jacobi preconditioner");
+            d = T(1) / d;
+        }
+    }
+
+public:
+    explicit JacobiPreconditioner(std::vector<T> diagonal) : inv_diag_(std::move(diagonal)) { invert(); }
+
+    explicit JacobiPreconditioner(Matrix<T> const& a) : inv_diag_(a.rows()) {
+        check_same_size(a.rows(), a.cols());
+        for (int i = 0; i < a.rows(); ++i) inv_diag_[i] = a(i, i);
+        invert();
+    }
+
+    explicit JacobiPreconditioner(SparseMatrix<T> const& a) : inv_diag_(a.rows()) {
+        check_same_size(a.rows(), a.cols());
+        for (int i = 0; i < a.rows(); ++i) inv_diag_[i] = a(i, i);
+        invert();
+    }
+
+    void apply(T const* r, T* z, int n) const {
+        check_same_size(n, static_cast<int>(inv_diag_.size()));
+        for (int i = 0; i < n; ++i) z[i] = r[i] * inv_diag_[i];
+    }
+};
+
+/*
+ ILU(0): L * U ~ A, ahol L és U csak A nemnulla helyein nemnulla
+ A felbontás a CSR-tömbök másolatán helyben készül (IKJ-sorrend), a
+ főátlónak minden sorban jelen kell lennie. Alkalmazása egy előre és egy
+ visszahelyettesítés, O(nnz).
+*/
+template<typename T>
+class ILU0Preconditioner {
+    int n_;
+    std::vector<std::size_t> ptr_;
+    std::vector<int> idx_;
+    std::vector<T> val_;
+    std::vector<std::size_t> diag_;  // a főátló helye soronként
+
+public:
+    explicit ILU0Preconditioner(SparseMatrix<T> const& a) : n_(a.rows()) {
+        check_same_size(a.rows(), a.cols());
+        SparseMatrix<T> csr = a.to_csr();
+        ptr_ = csr.outer_ptr();
+        idx_ = csr.inner_indices();
+        val_ = csr.values();
+        diag_.resize(n_);
+        std::vector<std::size_t> pos(n_, static_cast<std::size_t>(-1));  // oszlop -> hely az i. sorban
+        for (int i = 0; i < n_; ++i) {
+            for (std::size_t k = ptr_[i]; k < ptr_[i + 1]; ++k) pos[idx_[k]] = k;
+            if (pos[i] == static_cast<std::size_t>(-1))
+                throw std::runtime_error("ILU(0): missing diagonal entry");
+            diag_[i] = pos[i];
+            for (std::size_t k = ptr_[i]; k < ptr_[i + 1] && idx_[k] < i; ++k) {
+                int c = idx_[k];
+                T l = val_[k] /= val_[diag_[c]];
+                for (std::size_t m = diag_[c] + 1; m < ptr_[c + 1]; ++m)
+                    if (pos[idx_[m]] != static_cast<std::size_t>(-1)) val_[pos[idx_[m]]] -= l * val_[m];
+            }
+            if (val_[diag_[i]] == T{})
+                throw std::runtime_error("ILU(0): zero pivot");
+            for (std::size_t k = ptr_[i]; k < ptr_[i + 1]; ++k) pos[idx_[k]] = static_cast<std::size_t>(-1);
+        }
+    }
+
+    explicit ILU0Preconditioner(Matrix<T> const& a) : ILU0Preconditioner(SparseMatrix<T>(a)) {}
+
+    void apply(T const* r, T* z, int n) const {
+        check_same_size(n, n_);
+        for (int i = 0; i < n_; ++i) {
+            T s = r[i];
+            for (std::size_t k = ptr_[i]; k < diag_[i]; ++k) s -= val_[k] * z[idx_[k]];
+            z[i] = s;
+        }
+        for (int i = n_ - 1; i >= 0; --i) {
+            T s = z[i];
+            for (std::size_t k = diag_[i] + 1; k < ptr_[i + 1]; ++k) s -= val_[k] * z[idx_[k]];
+            z[i] = s / val_[diag_[i]];
+        }
+    }
+};
+
+namespace krylov_detail {
+
+// A vektorműveletek darabmérete (párhuzamosítás és a skalárszorzat összegzési sorrendje)
+constexpr int vector_chunk = 1 << 14;
+
+inline int chunks(int n) { return (n + vector_chunk - 1) / vector_chunk; }
+
+template<typename F>
+void for_chunks(int n, F f) {
+    int c = chunks(n);
+    auto run = [&](int c0, int c1) {
+        for (int k = c0; k < c1; ++k) f(k * vector_chunk, std::min(n, (k + 1) * vector_chunk));
+    };
+    if (c > 1)
+        parallel_for(0, c, 1, run);
+    else
+        run(0, c);
+}
+
+template<typename T>
+T dot(std::vector<T> const& a, std::vector<T> const& b) {
+    int n = static_cast<int>(a.size());
+    std::vector<T> part(chunks(n), T{});
+    for_chunks(n, [&](int i0, int i1) {
+        T s{};
+        for (int i = i0; i < i1; ++i) s += a[i] * b[i];
+        part[i0 / vector_chunk] = s;
+    });
+    T s{};
+    for (T p : part) s += p;
+    return s;
+}
+
+template<typename T>
+T norm(std::vector<T> const& a) { return std::sqrt(dot(a, a)); }
+
+// y += alpha * x
+template<typename T>
+void axpy(T alpha, std::vector<T> const& x, std::vector<T>& y) {
+    for_chunks(static_cast<int>(y.size()), [&](int i0, int i1) {
+        matrix_kernels::simd_axpy(y.data() + i0, alpha, x.data() + i0, static_cast<std::size_t>(i1 - i0));
+    });
+}
+
+// y = x + beta * y
+template<typename T>
+void xpay(std::vector<T> const& x, T beta, std::vector<T>& y) {
+    for_chunks(static_cast<int>(y.size()), [&](int i0, int i1) {
+        for (int i = i0; i < i1; ++i) y[i] = x[i] + beta * y[i];
+    });
+}
+
+// y = A * x a támogatott operátorfajtákra
+template<typename Op, typename T>
+void apply(Op const& a, std::vector<T> const& x, std::vector<T>& y) {
+    int n = static_cast<int>(x.size());
+    if constexpr (is_dense_matrix<Op>::value) {
+        check_same_size(a.cols(), n);
+        check_same_size(a.rows(), static_cast<int>(y.size()));
+        std::fill(y.begin(), y.end(), T{});
+        gemv(T{1}, a.view(), MatrixView<T>(x.data(), n, 1, 1), MatrixRef<T>(y.data(), n, 1, 1));
+    } else if constexpr (std::is_same_v<Op, SparseMatrix<T>>) {
+        check_same_size(a.cols(), n);
+        check_same_size(a.rows(), static_cast<int>(y.size()));
+        a.multiply(x.data(), y.data());
+    } else {
+        a(x.data(), y.data());
+    }
+}
+
+// A műveletszámláló és a leállási feltétel közös része
+template<typename Op, typename T>
+struct Solve {
+    Op const& a;
+    std::vector<T> const& b;
+    KrylovOptions<T> const& opt;
+    KrylovResult<T> result;
+    T tol;
+    int n;
+
+    Solve(Op const& a_, std::vector<T> const& b_, std::vector<T> const& x, KrylovOptions<T> const& opt_)
+        : a(a_), b(b_), opt(opt_), n(static_cast<int>(b_.size())) {
+        check_same_size(static_cast<int>(x.size()), n);
+        tol = std::max(opt.abs_tol, opt.rel_tol * norm(b));
+    }
+
+    void matvec(std::vector<T> const& x, std::vector<T>& y) {
+        apply(a, x, y);
+        ++result.matvecs;
+    }
+
+    // r = b - A * x
+    void residual(std::vector<T> const& x, std::vector<T>& r) {
+        matvec(x, r);
+        xpay(b, T(-1), r);
+    }
+
+    // Egy lépés lezárása; true: le kell állni (result.status beállítva)
+    bool step(T rn) {
+        ++result.iterations;
+        if (opt.record_history) result.history.push_back(rn);
+        if (rn <= tol) {
+            result.status = KrylovStatus::converged;
+            return true;
+        }
+        if (opt.callback && !opt.callback(result.iterations, rn)) {
+            result.status = KrylovStatus::stopped;
+            return true;
+        }
+        return false;
+    }
+
+    // A valódi maradék a végén
+    KrylovResult<T> finish(std::vector<T> const& x) {
+        std::vector<T> r(n);
+        residual(x, r);
+        result.residual = norm(r);
+        T bn = norm(b);
+        result.relative_residual = bn > T(0) ? result.residual / bn : result.residual;
+        return result;
+    }
+};
+
+} // namespace krylov_detail
+
+/*
+ Konjugált gradiens (előkondicionálva: PCG)
+ A-nak és M-nek szimmetrikusnak és pozitív definitnek kell lennie.
+*/
+template<typename Op, typename T, typename Precond = IdentityPreconditioner<T>>
+KrylovResult<T> cg(Op const& a, std::vector<T> const& b, std::vector<T>& x,
+                   KrylovOptions<T> const& opt = {}, Precond const& m = {}) {
+    using namespace krylov_detail;
+    Solve<Op, T> s(a, b, x, opt);
+    int n = s.n;
+    std::vector<T> r(n), z(n), p(n), q(n);
+    s.residual(x, r);
+    if (norm(r) <= s.tol) {
+        s.result.status = KrylovStatus::converged;
+        return s.finish(x);
+    }
+    m.apply(r.data(), z.data(), n);
+    p = z;
+    T rz = dot(r, z);
+    while (s.result.iterations < opt.max_iterations) {
+        s.matvec(p, q);
+        T pq = dot(p, q);
+        if (pq == T{} || !std::isfinite(pq)) {
+            s.result.status = KrylovStatus::breakdown;
+            break;
+        }
+        T alpha = rz / pq;
+        axpy(alpha, p, x);
+        axpy(-alpha, q, r);
+        if (s.step(norm(r))) break;
+        m.apply(r.data(), z.data(), n);
+        T rz_new = dot(r, z);
+        xpay(z, rz_new / rz, p);
+        rz = rz_new;
+    }
+    return s.finish(x);
+}
+
+/*
+ BiCGSTAB (van der Vorst), jobbról előkondicionálva: A * M^-1 * y = b,
+ x = M^-1 * y, így a figyelt maradék a valódi maradék
+*/
+template<typename Op, typename T, typename Precond = IdentityPreconditioner<T>>
+KrylovResult<T> bicgstab(Op const& a, std::vector<T> const& b, std::vector<T>& x,
+                         KrylovOptions<T> const& opt = {}, Precond const& m = {}) {
+    using namespace krylov_detail;
+    Solve<Op, T> s(a, b, x, opt);
+    int n = s.n;
+    std::vector<T> r(n), r_hat(n), p(n, T{}), v(n, T{}), p_hat(n), s_vec(n), s_hat(n), t(n);
+    s.residual(x, r);
+    if (norm(r) <= s.tol) {
+        s.result.status = KrylovStatus::converged;
+        return s.finish(x);
+    }
+    r_hat = r;
+    T rho = T(1), alpha = T(1), omega = T(1);
+    while (s.result.iterations < opt.max_iterations) {
+        T rho_new = dot(r_hat, r);
+        if (rho_new == T{} || omega == T{}) {
+            s.result.status = KrylovStatus::breakdown;
+            break;
+        }
+        // p = r + beta * (p - omega * v)
+        T beta = (rho_new / rho) * (alpha / omega);
+        axpy(-omega, v, p);
+        xpay(r, beta, p);
+        m.apply(p.data(), p_hat.data(), n);
+        s.matvec(p_hat, v);
+        T rv = dot(r_hat, v);
+        if (rv == T{} || !std::isfinite(rv)) {
+            s.result.status = KrylovStatus::breakdown;
+            break;
+        }
+        alpha = rho_new / rv;
+        s_vec = r;
+        axpy(-alpha, v, s_vec);
+        T sn = norm(s_vec);
+        if (sn <= s.tol) {
+            axpy(alpha, p_hat, x);
+            s.step(sn);
+            break;
+        }
+        m.apply(s_vec.data(), s_hat.data(), n);
+        s.matvec(s_hat, t);
+        T tt = dot(t, t);
+        omega = tt > T(0) ? dot(t, s_vec) / tt : T(0);
+        axpy(alpha, p_hat, x);
+        axpy(omega, s_hat, x);
+        r = s_vec;
+        axpy(-omega, t, r);
+        rho = rho_new;
+        if (s.step(norm(r))) break;
+    }
+    return s.finish(x);
+}
+
+/*
+ GMRES(restart), jobbról előkondicionálva
+ Arnoldi-folyamat módosított Gram-Schmidttel, a Hessenberg-mátrixot
+ Givens-forgatásokkal hozzuk felső háromszög alakra, így a maradék
+ normája minden lépésben mat-vec nélkül adódik (|g[j+1]|). restart lépés
+ után x-et frissítjük, és a valódi maradékból indulunk újra.
+*/
+template<typename Op, typename T, typename Precond = IdentityPreconditioner<T>>
+KrylovResult<T> gmres(Op const& a, std::vector<T> const& b, std::vector<T>& x,
+                      KrylovOptions<T> const& opt = {}, Precond const& m = {}) {
+    using namespace krylov_detail;
+    Solve<Op, T> s(a, b, x, opt);
+    int n = s.n;
+    int restart = std::max(1, opt.restart);
+    std::vector<std::vector<T>> v(restart + 1, std::vector<T>(n));
+    std::vector<T> h(static_cast<std::size_t>(restart + 1) * restart), g(restart + 1), cs(restart), sn(restart);
+    std::vector<T> r(n), w(n), z(n), y(restart);
+    auto H = [&](int i, int j) -> T& { return h[static_cast<std::size_t>(i) * restart + j]; };
+
+    s.residual(x, r);
+    T beta = norm(r);
+    if (beta <= s.tol) {
+        s.result.status = KrylovStatus::converged;
+        return s.finish(x);
+    }
+    bool done = false;
+    while (!done && s.result.iterations < opt.max_iterations) {
+        for (int i = 0; i < n; ++i) v[0][i] = r[i] / beta;
+        std::fill(g.begin(), g.end(), T{});
+        g[0] = beta;
+        int k = 0;
+        while (k < restart && s.result.iterations < opt.max_iterations) {
+            m.apply(v[k].data(), z.data(), n);
+            s.matvec(z, w);
+            for (int i = 0; i <= k; ++i) {
+                H(i, k) = dot(w, v[i]);
+                axpy(-H(i, k), v[i], w);
+            }
+            T hn = norm(w);
+            H(k + 1, k) = hn;
+            if (hn > T(0))
+                for (int i = 0; i < n; ++i) v[k + 1][i] = w[i] / hn;
+            // Korábbi forgatások, majd az új, ami H(k + 1, k)-t kinullázza
+            for (int i = 0; i < k; ++i) {
+                T t = cs[i] * H(i, k) + sn[i] * H(i + 1, k);
+                H(i + 1, k) = -sn[i] * H(i, k) + cs[i] * H(i + 1, k);
+                H(i, k) = t;
+            }
+            T d = std::hypot(H(k, k), H(k + 1, k));
+            if (d == T{}) {
+                s.result.status = KrylovStatus::breakdown;
+                done = true;
+                break;
+            }
+            cs[k] = H(k, k) / d;
+            sn[k] = H(k + 1, k) / d;
+            H(k, k) = d;
+            H(k + 1, k) = T{};
+            g[k + 1] = -sn[k] * g[k];
+            g[k] *= cs[k];
+            ++k;
+            // Szerencsés leállás (hn == 0): a megoldás a mostani altérben van
+            if (s.step(std::abs(g[k])) || hn == T{}) {
+                if (hn == T{}) s.result.status = KrylovStatus::converged;
+                done = true;
+                break;
+            }
+        }
+        // H(0..k, 0..k) * y = g, majd x += M^-1 * (V * y)
+        for (int i = k - 1; i >= 0; --i) {
+            T t = g[i];
+            for (int j = i + 1; j < k; ++j) t -= H(i, j) * y[j];
+            y[i] = t / H(i, i);
+        }
+        std::fill(w.begin(), w.end(), T{});
+        for (int j = 0; j < k; ++j) axpy(y[j], v[j], w);
+        m.apply(w.data(), z.data(), n);
+        axpy(T(1), z, x);
+        if (done) break;
+        s.residual(x, r);
+        beta = norm(r);
+        if (beta <= s.tol) {
+            s.result.status = KrylovStatus::converged;
+            break;
+        }
+    }
+    return s.finish(x);
+}
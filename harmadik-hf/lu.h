@@ -0,0 +1,216 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "matrix.h"
+
+/*
+ LU-felbontás részleges főelemkiválasztással: P * A = L * U
+
+ A nyers függvények (lu_factor, lu_solve, lu_solve_right) sorfolytonos,
+ lda sorhosszú puffereken dolgoznak helyben, így külső tárolón is
+ használhatók; az LU<T> osztály ezekre épül.
+*/
+namespace matrix_kernels {
+
+// Ennél kisebb abszolút értékű főelemet nullának (szingulárisnak) veszünk,
+// ugyanúgy, mint a korábbi inv() / determinant()
+constexpr double lu_singular_tolerance = 1e-12;
+
+// Panelszélesség a blokkosított felbontáshoz
+constexpr int lu_block = 64;
+
+template<typename T>
+void swap_rows(T* a, int lda, int n, int r1, int r2) {
+    if (r1 == r2) return;
+    std::swap_ranges(a + r1 * lda, a + r1 * lda + n, a + r2 * lda);
+}
+
+/*
+ Jobbra haladó (right-looking) blokkosított felbontás
+ Minden lu_block széles panelre:
+   1. a panelt oszloponként bontjuk főelemkiválasztással (teljes sorcserével),
+   2. U12 = L11^-1 * A12 (egységdiagonálisú alsó háromszög, soronként),
+   3. A22 -= L21 * U12 a blokkosított (párhuzamos) GEMM-mel.
+ A cserék piv-be kerülnek (LAPACK-stílus: az i. sort a piv[i]. sorral cseréltük).
+ Visszatérés: az első (közel) nulla főelem oszlopa, vagy -1, ha nem szinguláris.
+*/
+template<typename T>
+int lu_factor(int n, T* a, int lda, int* piv) {
+    int singular_col = -1;
+    for (int k = 0; k < n; k += lu_block) {
+        int nb = std::min(lu_block, n - k);
+
+        for (int j = k; j < k + nb; ++j) {
+            int p = j;
+            for (int i = j + 1; i < n; ++i)
+                if (std::abs(a[i * lda + j]) > std::abs(a[p * lda + j]))
+                    p = i;
+            piv[j] = p;
+            swap_rows(a, lda, n, j, p);
+
+            T pivot = a[j * lda + j];
+            if (std::abs(pivot) < lu_singular_tolerance) {
+                if (singular_col < 0) singular_col = j;
+                continue;
+            }
+            for (int i = j + 1; i < n; ++i) {
+                T* row = a + i * lda;
+                T l = row[j] /= pivot;
+                if (l == T{}) continue;
+                T const* prow = a + j * lda;
+                for (int c = j + 1; c < k + nb; ++c)
+                    row[c] -= l * prow[c];
+            }
+        }
+
+        int rest = n - k - nb;
+        if (rest <= 0) continue;
+        for (int i = k + 1; i < k + nb; ++i) {
+            T* row = a + i * lda + k + nb;
+            for (int r = k; r < i; ++r) {
+                T l = a[i * lda + r];
+                T const* urow = a + r * lda + k + nb;
+                for (int c = 0; c < rest; ++c)
+                    row[c] -= l * urow[c];
+            }
+        }
+        gemm(rest, rest, nb, T{-1},
+             a + (k + nb) * lda + k, lda, 1,
+             a + k * lda + k + nb, lda, 1,
+             a + (k + nb) * lda + k + nb, lda, 1);
+    }
+    return singular_col;
+}
+
+/*
+ A * X = B megoldása a felbontásból, B helyén (n x nrhs, ldb sorhossz)
+ Sorcserék, előre helyettesítés L-lel, majd vissza U-val; mind soronkénti
+ axpy, így több jobb oldal esetén is folytonosan olvasunk.
+*/
+template<typename T>
+void lu_solve(int n, T const* lu, int lda, int const* piv, T* b, int nrhs, int ldb) {
+    for (int i = 0; i < n; ++i)
+        swap_rows(b, ldb, nrhs, i, piv[i]);
+    for (int i = 1; i < n; ++i) {
+        T* bi = b + i * ldb;
+        for (int r = 0; r < i; ++r) {
+            T l = lu[i * lda + r];
+            if (l == T{}) continue;
+            T const* br = b + r * ldb;
+            for (int c = 0; c < nrhs; ++c) bi[c] -= l * br[c];
+        }
+    }
+    for (int i = n - 1; i >= 0; --i) {
+        T* bi = b + i * ldb;
+        for (int r = i + 1; r < n; ++r) {
+            T u = lu[i * lda + r];
+            if (u == T{}) continue;
+            T const* br = b + r * ldb;
+            for (int c = 0; c < nrhs; ++c) bi[c] -= u * br[c];
+        }
+        T d = lu[i * lda + i];
+        for (int c = 0; c < nrhs; ++c) bi[c] /= d;
+    }
+}
+
+/*
+ X * A = B megoldása (m x n-es B helyén), azaz X = B * A^-1 inverz nélkül
+ P*A = L*U miatt X * P^T * L * U = B: előbb Y * U = B, majd Z * L = Y,
+ végül X = Z * P (oszlopcserék fordított sorrendben).
+*/
+template<typename T>
+void lu_solve_right(int n, T const* lu, int lda, int const* piv, T* b, int m, int ldb) {
+    for (int row = 0; row < m; ++row) {
+        T* x = b + row * ldb;
+        for (int j = 0; j < n; ++j) {
+            T s = x[j];
+            for (int r = 0; r < j; ++r) s -= x[r] * lu[r * lda + j];
+            x[j] = s / lu[j * lda + j];
+        }
+        for (int j = n - 1; j >= 0; --j) {
+            T s = x[j];
+            for (int r = j + 1; r < n; ++r) s -= x[r] * lu[r * lda + j];
+            x[j] = s;
+        }
+        for (int j = n - 1; j >= 0; --j)
+            std::swap(x[j], x[piv[j]]);
+    }
+}
+
+} // namespace matrix_kernels
+
+/*
+ Újrahasznosítható LU-felbontás
+ Egyszer O(n^3) a felbontás, utána minden jobb oldal O(n^2):
+   LU<double> lu(A);
+   auto x = lu.solve(b);  auto d = lu.det();  auto Ainv = lu.inverse();
+*/
+template<typename T>
+class LU {
+    Matrix<T> lu_;
+    std::vector<int> piv_;
+    int singular_col_;
+
+    void require_regular() const {
+        if (singular_col_ >= 0)
+            throw std::runtime_error("Matrix is singular");
+    }
+
+public:
+    explicit LU(Matrix<T> a) : lu_(std::move(a)), piv_(lu_.rows()) {
+        check_same_size(lu_.rows(), lu_.cols());
+        int n = lu_.rows();
+        singular_col_ = matrix_kernels::lu_factor(n, lu_.data(), n, piv_.data());
+    }
+
+    int size() const { return lu_.size(); }
+    bool singular() const { return singular_col_ >= 0; }
+
+    // L (egységdiagonálissal, nem tárolt) és U egy mátrixban, valamint a sorcserék
+    Matrix<T> const& factors() const { return lu_; }
+    std::vector<int> const& pivots() const { return piv_; }
+
+    T det() const {
+        if (singular()) return T{};
+        T d = 1;
+        for (int i = 0; i < size(); ++i) {
+            d *= lu_(i, i);
+            if (piv_[i] != i) d = -d;
+        }
+        return d;
+    }
+
+    // A * x = b
+    std::vector<T> solve(std::vector<T> b) const {
+        if (static_cast<int>(b.size()) != size())
+            throw MatrixSizeMismatch();
+        require_regular();
+        matrix_kernels::lu_solve(size(), lu_.data(), size(), piv_.data(), b.data(), 1, 1);
+        return b;
+    }
+
+    // A * X = B, ahol B n x k-s (k jobb oldal oszloponként)
+    Matrix<T> solve(Matrix<T> B) const {
+        check_same_size(B.rows(), size());
+        require_regular();
+        matrix_kernels::lu_solve(size(), lu_.data(), size(), piv_.data(), B.data(), B.cols(), B.cols());
+        return B;
+    }
+
+    // X * A = B, ahol B m x n-es
+    Matrix<T> solve_right(Matrix<T> B) const {
+        check_same_size(B.cols(), size());
+        require_regular();
+        matrix_kernels::lu_solve_right(size(), lu_.data(), size(), piv_.data(), B.data(), B.rows(), B.cols());
+        return B;
+    }
+
+    Matrix<T> inverse() const {
+        return solve(Matrix<T>::identity(size()));
+    }
+};
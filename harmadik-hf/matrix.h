@@ -1,11 +1,18 @@
 #pragma once
 
 #include <vector>
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
 #include <stdexcept>
 #include <cmath>
 
+#include "gemm.h"
+#include "pool_allocator.h"
+#include "simd_kernels.h"
+#include "strassen.h"
+#include "thread_pool.h"
+
 /*
  Kivételosztály mátrixméret-ellenőrzéshez
  Ha két mátrix mérete eltér, ezt dobjuk
@@ -24,223 +31,440 @@ inline void check_same_size(int a, int b) {
         throw MatrixSizeMismatch();
 }
 
+// A kifejezéssablonok és a nézetek a fenti méretellenőrzésre épülnek
+#include "matrix_expr.h"
+#include "matrix_view.h"
+
 /*
  Szépen formázott mátrix kiírás segédfüggvénye
 */
-template<typename T>
-void print_matrix(const std::vector<T>& data, int n) {
-    for (int i = 0; i < n; ++i) {
+template<typename T, typename A>
+void print_matrix(const std::vector<T, A>& data, int rows, int cols) {
+    for (int i = 0; i < rows; ++i) {
         std::cout << "|";
-        for (int j = 0; j < n; ++j) {
-            std::cout << data[i * n + j];
-            if (j != n - 1) std::cout << " ";
+        for (int j = 0; j < cols; ++j) {
+            std::cout << data[i * cols + j];
+            if (j != cols - 1) std::cout << " ";
         }
         std::cout << "|\n";
     }
 }
 
+template<typename T, typename A>
+void print_matrix(const std::vector<T, A>& data, int n) {
+    print_matrix(data, n, n);
+}
+
+template<typename T>
+class LU;
+
+template<typename T, typename Alloc = default_matrix_allocator<T>>
+class Matrix;
+
 /*
- Négyzetes mátrix osztály sablonnal
+ Mátrix osztály sablonnal (négyzetes és téglalap alakú is)
  Típusfüggetlen (pl. double, int)
- Tárolás sorfolytonos std::vector-ben
+ Tárolás sorfolytonos std::vector-ben, cserélhető allokátorral
+ (számtípusokra alapból PoolAllocator, lásd pool_allocator.h)
 */
-template<typename T>
-class Matrix {
-    std::vector<T> data_;  // Az adatok tárolása
-    int n_;                // A mátrix mérete: n x n
+template<typename T, typename Alloc>
+class Matrix : public MatrixExpr<Matrix<T, Alloc>> {
+    std::vector<T, Alloc> data_;  // Az adatok tárolása (alapból 64 bájtra igazított készletből)
+    int rows_, cols_;      // A mátrix mérete: rows x cols
+
+    /*
+     Kifejezés kiértékelése egyetlen menetben: (i, j) = op((i, j), e(i, j))
+     Nagy mátrixnál a menetet sordarabokra bontva párhuzamosan futtatjuk.
+     Ha egy nézet a kifejezésben más elrendezésben olvas minket (A.view().t(),
+     eltolt blokk), helyben már felülírt elemet olvasna: előbb ideiglenesbe.
+    */
+    template<typename E, typename Op>
+    void apply_expr(E const& e, Op op) {
+        if (e.aliases(extent())) {
+            Matrix tmp(e);
+            apply_expr(tmp, op);
+            return;
+        }
+        T* d = data_.data();
+        int cols = cols_;
+        parallel_for(0, rows_, parallel_grain(cols), [&](int i0, int i1) {
+            for (int i = i0; i < i1; ++i) {
+                T* di = d + static_cast<std::size_t>(i) * cols;
+                for (int j = 0; j < cols; ++j)
+                    di[j] = op(di[j], e(i, j));
+            }
+        });
+    }
+
+    // Elemenkénti kernel darabonként: f(kezdőindex, hossz), nagy mátrixnál párhuzamosan
+    template<typename F>
+    void for_each_chunk(F f) {
+        parallel_for(0, static_cast<int>(data_.size()), 1 << 15, [&](int lo, int hi) {
+            f(static_cast<std::size_t>(lo), static_cast<std::size_t>(hi - lo));
+        });
+    }
+
+    void check_same_shape(Matrix const& other) const {
+        check_same_size(rows_, other.rows_);
+        check_same_size(cols_, other.cols_);
+    }
+
+    void check_square() const { check_same_size(rows_, cols_); }
 
 public:
-    Matrix(int n, T const& val = T{}) : data_(n * n, val), n_(n) {}
+    using value_type = T;
 
-    Matrix(int n, std::initializer_list<T> const& il) : data_(il), n_(n) {
-        if (data_.size() != static_cast<size_t>(n_ * n_))
+    // n x n-es mátrix val értékkel feltöltve
+    // explicit: különben A * 2.0-ban a 2.0 is "mátrixszá" konvertálódhatna
+    explicit Matrix(int n, T const& val = T{}) : Matrix(n, n, val) {}
+
+    // Téglalap alakú mátrix: rows x cols, val értékkel feltöltve; a kitöltő érték
+    // kötelező, hogy ne keveredjen a Matrix(n, val) négyzetes konstruktorral
+    Matrix(int rows, int cols, T const& val)
+        : data_(static_cast<std::size_t>(rows) * cols, val), rows_(rows), cols_(cols) {}
+
+    // rows x cols-os nullmátrix
+    static Matrix zeros(int rows, int cols) { return Matrix(rows, cols, T{}); }
+
+    Matrix(int n, std::initializer_list<T> const& il) : Matrix(n, n, il) {}
+
+    Matrix(int rows, int cols, std::initializer_list<T> const& il)
+        : data_(il), rows_(rows), cols_(cols) {
+        if (data_.size() != static_cast<size_t>(rows_) * cols_)
             throw std::runtime_error("Initializer list size mismatch");
     }
 
-    T& operator()(int i, int j) { return data_[i * n_ + j]; }
-    T const& operator()(int i, int j) const { return data_[i * n_ + j]; }
+    // Kiértékelés kifejezésből vagy nézetből, pl. Matrix<double> D = A + B - C * 2.0;
+    template<typename E>
+    Matrix(MatrixExpr<E> const& e)
+        : data_(static_cast<std::size_t>(e.self().rows()) * e.self().cols()),
+          rows_(e.self().rows()), cols_(e.self().cols()) {
+        apply_expr(e.self(), [](T const&, T const& x) { return x; });
+    }
 
-    int size() const { return n_; }
+    Matrix(Matrix const&) = default;
+    Matrix(Matrix&&) = default;
+    Matrix& operator=(Matrix const&) = default;
+    Matrix& operator=(Matrix&&) = default;
+
+    // Értékadás kifejezésből; A = A * 2.0 helyben fut, A = A.view().t() ideiglenessel
+    template<typename E>
+    Matrix& operator=(MatrixExpr<E> const& e) {
+        int rows = e.self().rows(), cols = e.self().cols();
+        if (rows != rows_ || cols != cols_) {
+            // Más méret esetén a kifejezés nem hivatkozhat ránk, előbb kiértékeljük
+            Matrix tmp(e);
+            return *this = std::move(tmp);
+        }
+        apply_expr(e.self(), [](T const&, T const& x) { return x; });
+        return *this;
+    }
 
-    Matrix<T>& operator+=(Matrix<T> const& other) {
-        check_same_size(n_, other.n_);
-        for (int i = 0; i < n_ * n_; ++i) data_[i] += other.data_[i];
+    T& operator()(int i, int j) { return data_[i * cols_ + j]; }
+    T const& operator()(int i, int j) const { return data_[i * cols_ + j]; }
+
+    // Négyzetes mátrixnál n (téglalap alakúnál a sorok száma)
+    int size() const { return rows_; }
+    int rows() const { return rows_; }
+    int cols() const { return cols_; }
+
+    // Nyers, sorfolytonos adatok (pl. a kernelek és az LU-felbontás számára)
+    T* data() { return data_.data(); }
+    T const* data() const { return data_.data(); }
+
+    // Nézetek másolás nélkül (matrix_view.h); a mátrixnál tovább nem élhetnek
+    // Kifejezéslevélként: a célmátrix memóriájába olvas-e más elrendezésben (matrix_expr.h)
+    expr_extent<T> extent() const { return {data_.data(), rows_, cols_, cols_, 1}; }
+    bool aliases(expr_extent<T> const& dst) const { return expr_overlaps(extent(), dst); }
+
+    MatrixRef<T> view() { return MatrixRef<T>(data_.data(), rows_, cols_, cols_); }
+    MatrixView<T> view() const { return MatrixView<T>(data_.data(), rows_, cols_, cols_); }
+    operator MatrixView<T>() const { return view(); }
+    operator MatrixRef<T>() { return view(); }
+
+    MatrixRef<T> block(int r0, int c0, int rows, int cols) { return view().block(r0, c0, rows, cols); }
+    MatrixView<T> block(int r0, int c0, int rows, int cols) const { return view().block(r0, c0, rows, cols); }
+    MatrixRef<T> row(int i) { return view().row(i); }
+    MatrixView<T> row(int i) const { return view().row(i); }
+    MatrixRef<T> col(int j) { return view().col(j); }
+    MatrixView<T> col(int j) const { return view().col(j); }
+
+    // Az összetett értékadások SIMD kernelekkel futnak (simd_kernels.h)
+    Matrix& operator+=(Matrix const& other) {
+        check_same_shape(other);
+        for_each_chunk([&](std::size_t i, std::size_t len) {
+            matrix_kernels::simd_add(data_.data() + i, other.data_.data() + i, len);
+        });
         return *this;
     }
 
-    Matrix<T>& operator-=(Matrix<T> const& other) {
-        check_same_size(n_, other.n_);
-        for (int i = 0; i < n_ * n_; ++i) data_[i] -= other.data_[i];
+    Matrix& operator-=(Matrix const& other) {
+        check_same_shape(other);
+        for_each_chunk([&](std::size_t i, std::size_t len) {
+            matrix_kernels::simd_sub(data_.data() + i, other.data_.data() + i, len);
+        });
         return *this;
     }
 
-    Matrix<T>& operator*=(T const& s) {
-        for (std::size_t i = 0; i < data_.size(); ++i) data_[i] *= s;
+    // A += alpha * B egyetlen menetben (FMA, ha van)
+    Matrix& axpy(T const& alpha, Matrix const& other) {
+        check_same_shape(other);
+        for_each_chunk([&](std::size_t i, std::size_t len) {
+            matrix_kernels::simd_axpy(data_.data() + i, alpha, other.data_.data() + i, len);
+        });
         return *this;
     }
 
-    Matrix<T>& operator/=(T const& s) {
-        for (std::size_t i = 0; i < data_.size(); ++i) data_[i] /= s;
+    // A += alpha * B és A -= alpha * B kifejezésként írva is axpy-ra fordul
+    Matrix& operator+=(MatrixScalarExpr<Matrix, expr_mul> const& e) {
+        return axpy(e.scalar(), e.operand());
+    }
+
+    Matrix& operator-=(MatrixScalarExpr<Matrix, expr_mul> const& e) {
+        return axpy(-e.scalar(), e.operand());
+    }
+
+    Matrix& operator*=(T const& s) {
+        for_each_chunk([&](std::size_t i, std::size_t len) {
+            matrix_kernels::simd_scale(data_.data() + i, s, len);
+        });
         return *this;
     }
 
-    Matrix<T> inv() const {
-        Matrix<T> a = *this;
-        Matrix<T> inv(n_, T{});
-        for (int i = 0; i < n_; ++i) inv(i, i) = 1;
+    Matrix& operator/=(T const& s) {
+        for_each_chunk([&](std::size_t i, std::size_t len) {
+            matrix_kernels::simd_div(data_.data() + i, s, len);
+        });
+        return *this;
+    }
 
-        for (int i = 0; i < n_; ++i) {
-            T pivot = a(i, i);
-            if (std::abs(pivot) < 1e-12)
-                throw std::runtime_error("Matrix is singular");
+    template<typename E>
+    Matrix& operator+=(MatrixExpr<E> const& e) {
+        check_same_size(rows_, e.self().rows());
+        check_same_size(cols_, e.self().cols());
+        apply_expr(e.self(), [](T const& d, T const& x) { return d + x; });
+        return *this;
+    }
 
-            for (int j = 0; j < n_; ++j) {
-                a(i, j) /= pivot;
-                inv(i, j) /= pivot;
-            }
+    template<typename E>
+    Matrix& operator-=(MatrixExpr<E> const& e) {
+        check_same_size(rows_, e.self().rows());
+        check_same_size(cols_, e.self().cols());
+        apply_expr(e.self(), [](T const& d, T const& x) { return d - x; });
+        return *this;
+    }
 
-            for (int k = 0; k < n_; ++k) {
-                if (k == i) continue;
-                T factor = a(k, i);
-                for (int j = 0; j < n_; ++j) {
-                    a(k, j) -= factor * a(i, j);
-                    inv(k, j) -= factor * inv(i, j);
-                }
-            }
-        }
-        return inv;
+    // Inverz az LU-felbontásból (részleges főelemkiválasztással, lásd lu.h)
+    Matrix inv() const {
+        check_square();
+        return LU<T>(*this).inverse();
     }
 
-    Matrix<T> transpose() const {
-        Matrix<T> result(n_);
-        for (int i = 0; i < n_; ++i)
-            for (int j = 0; j < n_; ++j)
-                result(j, i) = (*this)(i, j);
+    // Blokkosított, gyorsítótár-független transzponálás (transpose.h)
+    Matrix transpose() const {
+        Matrix result(cols_, rows_, T{});
+        matrix_kernels::transpose(rows_, cols_, data_.data(), cols_, result.data_.data(), rows_);
         return result;
     }
 
-    T determinant() const {
-        Matrix<T> temp = *this;
-        T det = 1;
-
-        for (int i = 0; i < n_; ++i) {
-            int pivot_row = i;
-            for (int k = i + 1; k < n_; ++k) {
-                if (std::abs(temp(k, i)) > std::abs(temp(pivot_row, i)))
-                    pivot_row = k;
-            }
-            if (std::abs(temp(pivot_row, i)) < 1e-12)
-                return 0;
-
-            if (i != pivot_row) {
-                for (int j = 0; j < n_; ++j)
-                    std::swap(temp(i, j), temp(pivot_row, j));
-                det = -det;
-            }
+    // Helyben transzponálás négyzetes mátrixra, foglalás nélkül
+    Matrix& transpose_inplace() {
+        check_square();
+        matrix_kernels::transpose_inplace(rows_, data_.data(), cols_);
+        return *this;
+    }
 
-            det *= temp(i, i);
-            for (int k = i + 1; k < n_; ++k) {
-                T factor = temp(k, i) / temp(i, i);
-                for (int j = 0; j < n_; ++j)
-                    temp(k, j) -= factor * temp(i, j);
-            }
-        }
-        return det;
+    // Determináns: a főátló szorzata előjellel; szinguláris mátrixra 0
+    T determinant() const {
+        check_square();
+        return LU<T>(*this).det();
     }
 
-    static Matrix<T> identity(int n) {
-        Matrix<T> id(n);
+    static Matrix identity(int n) {
+        Matrix id(n);
         for (int i = 0; i < n; ++i)
             id(i, i) = T{1};
         return id;
     }
 
     void print() const {
-        print_matrix(data_, n_);
+        print_matrix(data_, rows_, cols_);
     }
 
-    friend std::ostream& operator<<(std::ostream& os, Matrix<T> const& m) {
-        for (int i = 0; i < m.n_; ++i) {
+    friend std::ostream& operator<<(std::ostream& os, Matrix const& m) {
+        for (int i = 0; i < m.rows_; ++i) {
             os << "|";
-            for (int j = 0; j < m.n_; ++j) {
+            for (int j = 0; j < m.cols_; ++j) {
                 os << m(i, j);
-                if (j != m.n_ - 1) os << " ";
+                if (j != m.cols_ - 1) os << " ";
             }
             os << "|\n";
         }
         return os;
     }
 
-    // Mátrix-mátrix és skalár műveletek
-    friend Matrix<T> operator+(Matrix<T> a, Matrix<T> const& b) {
-        check_same_size(a.n_, b.n_);
-        return a += b;
-    }
-
-    friend Matrix<T> operator-(Matrix<T> a, Matrix<T> const& b) {
-        check_same_size(a.n_, b.n_);
-        return a -= b;
+    // Az elemenkénti +, -, skalárszorzás és -osztás kifejezéssablon (matrix_expr.h)
+
+    // Klasszikus GEMM, vagy kérésre (set_multiply_algorithm) nagy méreteknél Strassen–Winograd
+    friend Matrix operator*(Matrix const& a, Matrix const& b) {
+        check_same_size(a.cols_, b.rows_);
+        Matrix result(a.rows_, b.cols_, T{});
+        if (matrix_kernels::use_strassen<T>(a.rows_, b.cols_, a.cols_))
+            matrix_kernels::strassen_gemm(a.rows_, b.cols_, a.cols_, a.data(), a.cols_, 1, b.data(), b.cols_, 1,
+                                          result.data(), b.cols_, 1, strassen_cutoff());
+        else
+            gemm(T{1}, a.view(), b.view(), result.view());
+        return result;
     }
 
-    friend Matrix<T> operator*(Matrix<T> a, T const& s) {
-        return a *= s;
+    // a / b = a * b^-1, de inverz helyett X * b = a megoldásával
+    friend Matrix operator/(Matrix const& a, Matrix const& b) {
+        b.check_square();
+        check_same_size(a.cols_, b.rows_);
+        return LU<T>(b).solve_right(a);
     }
 
-    friend Matrix<T> operator*(T const& s, Matrix<T> a) {
-        return a *= s;
+    // Mátrix * vektor (soronkénti darabok párhuzamosan, ha elég nagy)
+    friend std::vector<T> operator*(Matrix const& m, std::vector<T> const& v) {
+        return m.view() * v;
     }
 
-    friend Matrix<T> operator/(Matrix<T> a, T const& s) {
-        return a /= s;
+    // Vektor * mátrix (oszlopdarabok párhuzamosan, soronként folytonos olvasással)
+    friend std::vector<T> operator*(std::vector<T> const& v, Matrix const& m) {
+        if (m.rows_ != static_cast<int>(v.size()))
+            throw MatrixSizeMismatch();
+        std::vector<T> result(m.cols_, T{});
+        parallel_for(0, m.cols_, parallel_grain(m.rows_), [&](int j0, int j1) {
+            for (int i = 0; i < m.rows_; ++i) {
+                T const* row = m.data_.data() + static_cast<std::size_t>(i) * m.cols_;
+                for (int j = j0; j < j1; ++j)
+                    result[j] += v[i] * row[j];
+            }
+        });
+        return result;
     }
 
-    friend Matrix<T> operator*(Matrix<T> const& a, Matrix<T> const& b) {
-        check_same_size(a.n_, b.n_);
-        int n = a.n_;
-        Matrix<T> result(n);
-        for (int i = 0; i < n; ++i)
-            for (int j = 0; j < n; ++j)
-                for (int k = 0; k < n; ++k)
-                    result(i, j) += a(i, k) * b(k, j);
+    // Tenzorszorzás (Kronecker-szorzat), A sorai szerint párhuzamosan
+    friend Matrix tensor(Matrix const& A, Matrix const& B) {
+        int r1 = A.rows_, c1 = A.cols_, r2 = B.rows_, c2 = B.cols_;
+        Matrix result(r1 * r2, c1 * c2, T{});
+        parallel_for(0, r1, parallel_grain(c1 * r2 * c2), [&](int i0, int i1) {
+            for (int i = i0; i < i1; ++i)
+                for (int j = 0; j < c1; ++j)
+                    for (int k = 0; k < r2; ++k)
+                        for (int l = 0; l < c2; ++l)
+                            result(i * r2 + k, j * c2 + l) = A(i, j) * B(k, l);
+        });
         return result;
     }
 
-    friend Matrix<T> operator/(Matrix<T> const& a, Matrix<T> const& b) {
-        check_same_size(a.n_, b.n_);
-        return a * b.inv();
+private:
+    // Darabméret a parallel_for-hoz: egy darab legalább ~32k elemet dolgozzon fel,
+    // így kis mátrixoknál egyetlen darab marad és minden sorosan fut
+    static int parallel_grain(int work_per_item) {
+        constexpr int min_work = 1 << 15;
+        return std::max(1, min_work / std::max(1, work_per_item));
     }
+};
 
-    // Mátrix * vektor
-    friend std::vector<T> operator*(Matrix<T> const& m, std::vector<T> const& v) {
-        if (m.n_ != static_cast<int>(v.size()))
-            throw MatrixSizeMismatch();
-        std::vector<T> result(m.n_, T{});
-        for (int i = 0; i < m.n_; ++i)
-            for (int j = 0; j < m.n_; ++j)
-                result[i] += m(i, j) * v[j];
-        return result;
-    }
+template<typename E>
+struct is_dense_matrix : std::false_type {};
 
-    // Vektor * mátrix
-    friend std::vector<T> operator*(std::vector<T> const& v, Matrix<T> const& m) {
-        if (m.n_ != static_cast<int>(v.size()))
-            throw MatrixSizeMismatch();
-        std::vector<T> result(m.n_, T{});
-        for (int j = 0; j < m.n_; ++j)
-            for (int i = 0; i < m.n_; ++i)
-                result[j] += v[i] * m(i, j);
-        return result;
-    }
+template<typename T, typename Alloc>
+struct is_dense_matrix<Matrix<T, Alloc>> : std::true_type {};
 
-    // Tenzorszorzás (Kronecker-szorzat)
-    friend Matrix<T> tensor(Matrix<T> const& A, Matrix<T> const& B) {
-        int n1 = A.n_, n2 = B.n_;
-        Matrix<T> result(n1 * n2);
-        for (int i = 0; i < n1; ++i)
-            for (int j = 0; j < n1; ++j)
-                for (int k = 0; k < n2; ++k)
-                    for (int l = 0; l < n2; ++l)
-                        result(i * n2 + k, j * n2 + l) = A(i, j) * B(k, l);
-        return result;
-    }
+// Nézetek szorzata új mátrixba, a blokkosított kernellel (gemm.h), mint a Matrix * Matrix
+template<typename T>
+Matrix<T> multiply(MatrixView<T> a, MatrixView<T> b) {
+    check_same_size(a.cols(), b.rows());
+    Matrix<T> result(a.rows(), b.cols(), T{});
+    if (matrix_kernels::use_strassen<T>(a.rows(), b.cols(), a.cols()))
+        matrix_kernels::strassen_gemm(a.rows(), b.cols(), a.cols(), a.data(), a.ld(), a.stride(), b.data(), b.ld(),
+                                      b.stride(), result.data(), result.cols(), 1, strassen_cutoff());
+    else
+        gemm(T{1}, a, b, result.view());
+    return result;
+}
+
+// Strassen–Winograd-szorzat a beállított algoritmustól függetlenül (strassen.h)
+template<typename T>
+Matrix<T> strassen_multiply(Matrix<T> const& a, Matrix<T> const& b, int cutoff = strassen_cutoff()) {
+    check_same_size(a.cols(), b.rows());
+    Matrix<T> result(a.rows(), b.cols(), T{});
+    matrix_kernels::strassen_gemm(a.rows(), b.cols(), a.cols(), a.data(), a.cols(), 1, b.data(), b.cols(), 1,
+                                  result.data(), b.cols(), 1, cutoff);
+    return result;
+}
+
+/*
+ A Strassen-szorzat eltérése a klasszikustól (C) ugyanarra a bemenetre
+ A normwise az a mennyiség, amire a Strassen-típusú hibakorlátok
+ vonatkoznak; mérésünk szerint (n = 2048) szintenként ~3-szorosára nő.
+*/
+template<typename T>
+struct StrassenError {
+    int levels = 0;         // lefutott Strassen-szintek (0: végig klasszikus)
+    T max_abs{};            // max |C_s - C|
+    T relative{};           // ||C_s - C||_F / ||C||_F
+    T normwise{};           // max |C_s - C| / (max |A| * max |B|)
 };
+
+template<typename T>
+StrassenError<T> strassen_error(Matrix<T> const& a, Matrix<T> const& b, int cutoff = strassen_cutoff()) {
+    Matrix<T> fast = strassen_multiply(a, b, cutoff);
+    Matrix<T> exact(a.rows(), b.cols(), T{});
+    gemm(T{1}, a.view(), b.view(), exact.view());
+    auto max_abs = [](Matrix<T> const& m) {
+        T r{};
+        for (int i = 0; i < m.rows(); ++i)
+            for (int j = 0; j < m.cols(); ++j) r = std::max<T>(r, std::abs(m(i, j)));
+        return r;
+    };
+    StrassenError<T> e;
+    e.levels = matrix_kernels::strassen_levels(a.rows(), b.cols(), a.cols(), cutoff);
+    T diff2{}, norm2{};
+    for (int i = 0; i < exact.rows(); ++i)
+        for (int j = 0; j < exact.cols(); ++j) {
+            T d = fast(i, j) - exact(i, j);
+            e.max_abs = std::max<T>(e.max_abs, std::abs(d));
+            diff2 += d * d;
+            norm2 += exact(i, j) * exact(i, j);
+        }
+    e.relative = norm2 > T{} ? std::sqrt(diff2 / norm2) : std::sqrt(diff2);
+    T scale = max_abs(a) * max_abs(b);
+    e.normwise = scale > T{} ? e.max_abs / scale : e.max_abs;
+    return e;
+}
+
+// Nézet * vektor
+template<typename T>
+std::vector<T> operator*(MatrixView<T> const& m, std::vector<T> const& v) {
+    if (m.cols() != static_cast<int>(v.size()))
+        throw MatrixSizeMismatch();
+    std::vector<T> result(m.rows(), T{});
+    gemv(T{1}, m, MatrixView<T>(v.data(), m.cols(), 1, 1),
+         MatrixRef<T>(result.data(), m.rows(), 1, 1));
+    return result;
+}
+
+/*
+ Kifejezések és nézetek szorzata: a mátrixok és nézetek másolás nélkül,
+ az összetett kifejezések egyszeri kiértékelés után mennek a GEMM-be
+*/
+template<typename E>
+auto product_operand(E const& e) {
+    using V = typename E::value_type;
+    if constexpr (is_dense_matrix<E>::value || std::is_same_v<E, MatrixView<V>>)
+        return MatrixView<V>(e);
+    else
+        return Matrix<V>(e);
+}
+
+template<typename L, typename R>
+Matrix<typename L::value_type> operator*(MatrixExpr<L> const& a, MatrixExpr<R> const& b) {
+    auto ea = product_operand(a.self());
+    auto eb = product_operand(b.self());
+    return multiply(MatrixView<typename L::value_type>(ea), MatrixView<typename L::value_type>(eb));
+}
+
+#include "lu.h"
@@ -0,0 +1,369 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "matrix.h"
+
+/*
+ Sok, azonos méretű kis mátrix kötegelt kezelése (MatrixBatch<T>)
+
+ Több százezer független 2x2 ... 8x8-as mátrix esetén a Matrix<T>
+ hívásonkénti foglalása és elágazó skalár kódja dominál. Itt a K mátrixot
+ "struktúrák tömbje" helyett "tömbök struktúrájaként" (SoA) tároljuk:
+ az összes mátrix (i, j) eleme egymás után, folytonosan van:
+
+   (k. mátrix)(i, j) = data[(i * cols + j) * ld + k]
+
+ ahol ld a K felkerekítve batch_lanes többszörösére. A kernelek
+ batch_lanes mátrixot visznek egyszerre (a legbelső ciklus mindig a
+ köteg mentén fut), így elágazás nélkül vektorizálhatók; a sorcseréket is
+ maszkolt kiválasztással (blend) végezzük sávonként. Az utasításkészletet
+ futásidőben választjuk (lásd simd_dispatch), nagy kötegnél a szálkészlet
+ osztja szét a darabokat.
+
+   MatrixBatch<double> A(100000, 3, 3);        // 100000 db 3x3
+   auto C = A * B;                              // kötegelt szorzás
+   BatchLU<double> lu(A);
+   auto X = lu.solve(Bv);  auto D = lu.det();  auto Ainv = lu.inverse();
+*/
+namespace matrix_kernels {
+
+// Egyszerre feldolgozott mátrixok száma (a sávok száma)
+constexpr int batch_lanes = 16;
+
+/*
+ Darabonkénti kernelek: minden "sík" batch_lanes egymás utáni értéket tartalmaz,
+ a síkok között ld a távolság
+*/
+
+// C = A * B (m x p szor p x n)
+template<typename T>
+inline void batch_gemm_chunk(int m, int n, int p, T const* a, T const* b, T* c, std::size_t ld) {
+    constexpr int L = batch_lanes;
+    for (int i = 0; i < m; ++i)
+        for (int j = 0; j < n; ++j) {
+            T acc[L] = {};
+            for (int q = 0; q < p; ++q) {
+                T const* aq = a + (i * p + q) * ld;
+                T const* bq = b + (q * n + j) * ld;
+                for (int l = 0; l < L; ++l) acc[l] += aq[l] * bq[l];
+            }
+            T* cij = c + (i * n + j) * ld;
+            for (int l = 0; l < L; ++l) cij[l] = acc[l];
+        }
+}
+
+/*
+ A sávonkénti sorindexeket és jelzőket is T típusú síkokban tartjuk
+ (kis egészek, pontosan ábrázolhatók), így egy ciklusban nem keveredik
+ int és lebegőpontos vektor. Mint batch_gemm_chunk-ban, a síkokat helyi
+ tömbökbe olvassuk, ott számolunk, és csak a végén írunk vissza: a helyi
+ tömb nem fedheti át a síkokat, így a sávciklusok vektorregiszterbe kerülnek.
+*/
+
+// Az r. és k. sor cseréje (cols oszlop) azokban a sávokban, ahol sel[l] == r
+template<typename T>
+inline void batch_masked_swap(T* a, int cols, int k, int r, T const* sel, std::size_t ld) {
+    constexpr int L = batch_lanes;
+    T rt = static_cast<T>(r);
+    bool any = false;
+    for (int l = 0; l < L; ++l) any |= sel[l] == rt;
+    if (!any) return;
+    for (int j = 0; j < cols; ++j) {
+        T* rk = a + (k * cols + j) * ld;
+        T* rr = a + (r * cols + j) * ld;
+        T x[L], y[L];
+        for (int l = 0; l < L; ++l) {
+            bool s = sel[l] == rt;
+            x[l] = s ? rr[l] : rk[l];
+            y[l] = s ? rk[l] : rr[l];
+        }
+        for (int l = 0; l < L; ++l) rk[l] = x[l];
+        for (int l = 0; l < L; ++l) rr[l] = y[l];
+    }
+}
+
+/*
+ LU-felbontás helyben, sávonkénti részleges főelemkiválasztással
+ (ugyanaz a tárolás, mint lu_factor-ban: L egységdiagonális, a cseréket a
+ piv síkok őrzik). A szinguláris sávokban sing 1, ott a szorzók nullák.
+*/
+template<typename T>
+inline void batch_lu_factor_chunk(int n, T* a, T* piv, T* sing, std::size_t ld) {
+    constexpr int L = batch_lanes;
+    T flag[L] = {};
+    for (int k = 0; k < n; ++k) {
+        T pr[L], best[L];
+        T const* akk = a + (k * n + k) * ld;
+        for (int l = 0; l < L; ++l) {
+            pr[l] = static_cast<T>(k);
+            best[l] = std::abs(akk[l]);
+        }
+        for (int r = k + 1; r < n; ++r) {
+            T const* ark = a + (r * n + k) * ld;
+            T rt = static_cast<T>(r);
+            for (int l = 0; l < L; ++l) {
+                T v = std::abs(ark[l]);
+                bool better = v > best[l];
+                best[l] = better ? v : best[l];
+                pr[l] = better ? rt : pr[l];
+            }
+        }
+        T* pk = piv + k * ld;
+        for (int l = 0; l < L; ++l) pk[l] = pr[l];
+        for (int r = k + 1; r < n; ++r)
+            batch_masked_swap(a, n, k, r, pr, ld);
+
+        // Szinguláris sávban a főelem helyett 1-gyel osztunk, és a szorzót nullázzuk
+        T pivot[L], keep[L];
+        for (int l = 0; l < L; ++l) {
+            bool s = std::abs(akk[l]) < static_cast<T>(lu_singular_tolerance);
+            flag[l] = s ? T{1} : flag[l];
+            pivot[l] = s ? T{1} : akk[l];
+            keep[l] = s ? T{} : T{1};
+        }
+        for (int i = k + 1; i < n; ++i) {
+            T* aik = a + (i * n + k) * ld;
+            T mult[L];
+            for (int l = 0; l < L; ++l) mult[l] = aik[l] / pivot[l] * keep[l];
+            for (int l = 0; l < L; ++l) aik[l] = mult[l];
+            for (int j = k + 1; j < n; ++j) {
+                T* aij = a + (i * n + j) * ld;
+                T const* akj = a + (k * n + j) * ld;
+                T x[L];
+                for (int l = 0; l < L; ++l) x[l] = aij[l] - mult[l] * akj[l];
+                for (int l = 0; l < L; ++l) aij[l] = x[l];
+            }
+        }
+    }
+    for (int l = 0; l < L; ++l) sing[l] = flag[l];
+}
+
+// A * X = B (B: n x m, helyben) a felbontásból: cserék, előre, majd vissza helyettesítés
+template<typename T>
+inline void batch_lu_solve_chunk(int n, T const* lu, T const* piv, T* b, int m, std::size_t ld) {
+    constexpr int L = batch_lanes;
+    for (int i = 0; i < n; ++i)
+        for (int r = i + 1; r < n; ++r)
+            batch_masked_swap(b, m, i, r, piv + i * ld, ld);
+    for (int i = 1; i < n; ++i)
+        for (int c = 0; c < m; ++c) {
+            T* bic = b + (i * m + c) * ld;
+            T acc[L];
+            for (int l = 0; l < L; ++l) acc[l] = bic[l];
+            for (int r = 0; r < i; ++r) {
+                T const* lir = lu + (i * n + r) * ld;
+                T const* brc = b + (r * m + c) * ld;
+                for (int l = 0; l < L; ++l) acc[l] -= lir[l] * brc[l];
+            }
+            for (int l = 0; l < L; ++l) bic[l] = acc[l];
+        }
+    for (int i = n - 1; i >= 0; --i)
+        for (int c = 0; c < m; ++c) {
+            T* bic = b + (i * m + c) * ld;
+            T acc[L];
+            for (int l = 0; l < L; ++l) acc[l] = bic[l];
+            for (int r = i + 1; r < n; ++r) {
+                T const* uir = lu + (i * n + r) * ld;
+                T const* brc = b + (r * m + c) * ld;
+                for (int l = 0; l < L; ++l) acc[l] -= uir[l] * brc[l];
+            }
+            T const* uii = lu + (i * n + i) * ld;
+            for (int l = 0; l < L; ++l) bic[l] = acc[l] / uii[l];
+        }
+}
+
+/*
+ A darabok (batch_lanes széles sávcsoportok) bejárása: f(sáveltolás)
+ Nagy kötegnél párhuzamosan, minden darab a kiválasztott utasításkészlettel.
+*/
+template<typename F>
+void for_each_batch_chunk(std::size_t ld, long long work_per_chunk, F const& f) {
+    int chunks = static_cast<int>(ld / batch_lanes);
+    int grain = static_cast<int>(std::max(1LL, (1LL << 15) / std::max(1LL, work_per_chunk)));
+    parallel_for(0, chunks, grain, [&](int c0, int c1) {
+        simd_dispatch([&] {
+            for (int c = c0; c < c1; ++c) f(static_cast<std::size_t>(c) * batch_lanes);
+        });
+    });
+}
+
+} // namespace matrix_kernels
+
+template<typename T>
+class MatrixBatch {
+    std::vector<T, default_matrix_allocator<T>> data_;
+    int count_, rows_, cols_;
+    std::size_t ld_;  // síkok távolsága: count_ felkerekítve batch_lanes többszörösére
+
+    static std::size_t padded(int count) {
+        constexpr int L = matrix_kernels::batch_lanes;
+        return static_cast<std::size_t>((count + L - 1) / L) * L;
+    }
+
+    // Még a data_ lefoglalása előtt fut (tagi inicializálóból): negatív méretre
+    // invalid_argument, ne a vector dobjon length_error-t / bad_alloc-ot
+    static std::size_t checked_size(int count, int rows, int cols) {
+        if (count < 0 || rows < 0 || cols < 0)
+            throw std::invalid_argument("Negative batch dimension");
+        return padded(count) * rows * cols;
+    }
+
+public:
+    using value_type = T;
+
+    // count darab rows x cols-os mátrix, val értékkel feltöltve
+    MatrixBatch(int count, int rows, int cols, T const& val = T{})
+        : data_(checked_size(count, rows, cols), val), count_(count), rows_(rows), cols_(cols),
+          ld_(padded(count)) {}
+
+    int count() const { return count_; }
+    int rows() const { return rows_; }
+    int cols() const { return cols_; }
+    std::size_t ld() const { return ld_; }
+
+    // A k. mátrix (i, j) eleme
+    T& operator()(int k, int i, int j) { return data_[(i * cols_ + j) * ld_ + k]; }
+    T const& operator()(int k, int i, int j) const { return data_[(i * cols_ + j) * ld_ + k]; }
+
+    // Az összes mátrix (i, j) eleme folytonosan (count() db érvényes)
+    T* plane(int i, int j) { return data_.data() + (i * cols_ + j) * ld_; }
+    T const* plane(int i, int j) const { return data_.data() + (i * cols_ + j) * ld_; }
+
+    T* data() { return data_.data(); }
+    T const* data() const { return data_.data(); }
+
+    Matrix<T> get(int k) const {
+        Matrix<T> m(rows_, cols_, T{});
+        for (int i = 0; i < rows_; ++i)
+            for (int j = 0; j < cols_; ++j)
+                m(i, j) = (*this)(k, i, j);
+        return m;
+    }
+
+    void set(int k, MatrixView<T> m) {
+        check_same_size(m.rows(), rows_);
+        check_same_size(m.cols(), cols_);
+        for (int i = 0; i < rows_; ++i)
+            for (int j = 0; j < cols_; ++j)
+                (*this)(k, i, j) = m(i, j);
+    }
+
+    // A kitöltő (count() utáni) sávokba egységmátrixot tesz, hogy ott se legyen nullával osztás
+    void pad_with_identity() {
+        for (int i = 0; i < rows_; ++i)
+            for (int j = 0; j < cols_; ++j)
+                std::fill(plane(i, j) + count_, plane(i, j) + ld_, i == j ? T{1} : T{});
+    }
+
+    // C_k = A_k * B_k minden k-ra
+    friend MatrixBatch operator*(MatrixBatch const& a, MatrixBatch const& b) {
+        check_same_size(a.count_, b.count_);
+        check_same_size(a.cols_, b.rows_);
+        MatrixBatch c(a.count_, a.rows_, b.cols_);
+        int m = a.rows_, n = b.cols_, p = a.cols_;
+        matrix_kernels::for_each_batch_chunk(a.ld_, 2LL * m * n * p * matrix_kernels::batch_lanes,
+            [&](std::size_t off) {
+                matrix_kernels::batch_gemm_chunk(m, n, p, a.data() + off, b.data() + off,
+                                                 c.data() + off, a.ld_);
+            });
+        return c;
+    }
+};
+
+// y_k = A_k * x_k, ahol x egy rows x 1-es vektorköteg
+template<typename T>
+MatrixBatch<T> matvec(MatrixBatch<T> const& a, MatrixBatch<T> const& x) {
+    if (x.cols() != 1) throw MatrixSizeMismatch();
+    return a * x;
+}
+
+/*
+ Kötegelt LU-felbontás: a kötegben minden mátrix egyszer bomlik fel,
+ utána a det(), solve() és inverse() ebből dolgozik (mint az LU<T>)
+*/
+template<typename T>
+class BatchLU {
+    MatrixBatch<T> lu_;
+    std::vector<T> piv_;   // n sík, mindegyik ld hosszú (sorindexek T-ként)
+    std::vector<T> sing_;  // sávonként: 1, ha szinguláris
+
+    void require_regular() const {
+        if (any_singular())
+            throw std::runtime_error("Matrix is singular");
+    }
+
+public:
+    explicit BatchLU(MatrixBatch<T> a)
+        : lu_(std::move(a)), piv_(static_cast<std::size_t>(lu_.rows()) * lu_.ld()), sing_(lu_.ld()) {
+        check_same_size(lu_.rows(), lu_.cols());
+        lu_.pad_with_identity();
+        int n = lu_.rows();
+        std::size_t ld = lu_.ld();
+        matrix_kernels::for_each_batch_chunk(ld, 2LL * n * n * n / 3 * matrix_kernels::batch_lanes + 1,
+            [&](std::size_t off) {
+                matrix_kernels::batch_lu_factor_chunk(n, lu_.data() + off, piv_.data() + off,
+                                                      sing_.data() + off, ld);
+            });
+    }
+
+    int count() const { return lu_.count(); }
+    int size() const { return lu_.rows(); }
+
+    bool singular(int k) const { return sing_[k] != T{}; }
+
+    bool any_singular() const {
+        for (int k = 0; k < count(); ++k)
+            if (singular(k)) return true;
+        return false;
+    }
+
+    MatrixBatch<T> const& factors() const { return lu_; }
+
+    // Determinánsok mátrixonként; szingulárisra 0
+    std::vector<T> det() const {
+        std::vector<T> d(count(), T{1});
+        int n = size();
+        for (int k = 0; k < n; ++k) {
+            T const* dk = lu_.plane(k, k);
+            T const* pk = piv_.data() + k * lu_.ld();
+            for (int l = 0; l < count(); ++l)
+                d[l] *= pk[l] != static_cast<T>(k) ? -dk[l] : dk[l];
+        }
+        for (int l = 0; l < count(); ++l)
+            if (singular(l)) d[l] = T{};
+        return d;
+    }
+
+    // A_k * X_k = B_k, ahol B n x m-es köteg
+    MatrixBatch<T> solve(MatrixBatch<T> b) const {
+        check_same_size(b.count(), count());
+        check_same_size(b.rows(), size());
+        require_regular();
+        int n = size(), m = b.cols();
+        std::size_t ld = lu_.ld();
+        matrix_kernels::for_each_batch_chunk(ld, 2LL * n * n * m * matrix_kernels::batch_lanes + 1,
+            [&](std::size_t off) {
+                matrix_kernels::batch_lu_solve_chunk(n, lu_.data() + off, piv_.data() + off,
+                                                     b.data() + off, m, ld);
+            });
+        return b;
+    }
+
+    MatrixBatch<T> inverse() const {
+        MatrixBatch<T> id(count(), size(), size());
+        for (int i = 0; i < size(); ++i)
+            std::fill(id.plane(i, i), id.plane(i, i) + id.ld(), T{1});
+        return solve(std::move(id));
+    }
+};
+
+// Kényelmi függvények (egyszeri felbontással)
+template<typename T>
+std::vector<T> determinant(MatrixBatch<T> const& a) { return BatchLU<T>(a).det(); }
+
+template<typename T>
+MatrixBatch<T> inverse(MatrixBatch<T> const& a) { return BatchLU<T>(a).inverse(); }
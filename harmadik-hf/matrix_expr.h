@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+/*
+ Kifejezéssablonok (expression templates) az elemenkénti műveletekhez
+
+ Az A + B - C * 2.0 alakú kifejezések nem számolódnak ki azonnal, hanem
+ egy kifejezésfát építenek; a fa a Matrix-ba íráskor (konstruktor,
+ értékadás, +=, -=) egyetlen ciklusban, ideiglenes mátrixok nélkül
+ értékelődik ki.
+
+ Egy kifejezéstípus (E) elvárásai:
+   value_type, int rows() const, int cols() const,
+   value_type operator()(int i, int j) const
+   bool aliases(expr_extent<value_type> const& dst) const
+
+ Figyelem: a levél mátrixokat referenciaként tároljuk, ezért a kifejezést
+ ne tegyük auto változóba, hanem rögtön rendeljük Matrix-hoz.
+*/
+template<typename T, typename Alloc>
+class Matrix;
+
+// Egy levél (mátrix vagy nézet) memóriája: kezdőcím, méret, sor- és oszloplépés
+template<typename T>
+struct expr_extent {
+    T const* data;
+    int rows, cols, rs, cs;
+};
+
+/*
+ Az src levél olvasása ütközik-e a dst-be írással. A helybeni, elemenkénti
+ kiértékelés csak akkor helyes, ha az (i, j) elemet ugyanonnan olvassuk, ahová
+ írjuk (A = A * 2.0); más kezdőcímmel vagy lépéssel a célba belelógó levél
+ (A = A.view().t(), egymásba csúszó blokkok) már felülírt elemet olvasna.
+ A címtartományok átfedését nézzük, ez óvatos (két szomszédos oszlop is ütközik).
+*/
+template<typename T>
+bool expr_overlaps(expr_extent<T> const& src, expr_extent<T> const& dst) {
+    if (src.rows == 0 || src.cols == 0 || dst.rows == 0 || dst.cols == 0) return false;
+    if (src.data == dst.data && src.rs == dst.rs && src.cs == dst.cs) return false;
+    auto lo = [](expr_extent<T> const& x) { return reinterpret_cast<std::uintptr_t>(x.data); };
+    auto hi = [](expr_extent<T> const& x) {
+        return reinterpret_cast<std::uintptr_t>(x.data + (x.rows - 1) * x.rs + (x.cols - 1) * x.cs + 1);
+    };
+    return lo(src) < hi(dst) && lo(dst) < hi(src);
+}
+
+template<typename E>
+struct MatrixExpr {
+    E const& self() const { return static_cast<E const&>(*this); }
+};
+
+// Levél mátrix referenciaként, a közbülső csomópontok érték szerint (kicsik)
+template<typename E>
+struct expr_storage { using type = E; };
+
+template<typename T, typename Alloc>
+struct expr_storage<Matrix<T, Alloc>> { using type = Matrix<T, Alloc> const&; };
+
+struct expr_add { template<typename T> static T apply(T const& a, T const& b) { return a + b; } };
+struct expr_sub { template<typename T> static T apply(T const& a, T const& b) { return a - b; } };
+struct expr_mul { template<typename T> static T apply(T const& a, T const& s) { return a * s; } };
+struct expr_div { template<typename T> static T apply(T const& a, T const& s) { return a / s; } };
+
+template<typename L, typename R, typename Op>
+class MatrixBinaryExpr : public MatrixExpr<MatrixBinaryExpr<L, R, Op>> {
+    typename expr_storage<L>::type a_;
+    typename expr_storage<R>::type b_;
+
+public:
+    using value_type = typename L::value_type;
+
+    MatrixBinaryExpr(L const& a, R const& b) : a_(a), b_(b) {
+        check_same_size(a.rows(), b.rows());
+        check_same_size(a.cols(), b.cols());
+    }
+
+    int rows() const { return a_.rows(); }
+    int cols() const { return a_.cols(); }
+    value_type operator()(int i, int j) const { return Op::apply(a_(i, j), b_(i, j)); }
+    bool aliases(expr_extent<value_type> const& dst) const { return a_.aliases(dst) || b_.aliases(dst); }
+};
+
+// Kifejezés és skalár (szorzás vagy osztás); a skalárt érték szerint tároljuk
+template<typename E, typename Op>
+class MatrixScalarExpr : public MatrixExpr<MatrixScalarExpr<E, Op>> {
+    typename expr_storage<E>::type e_;
+
+public:
+    using value_type = typename E::value_type;
+
+private:
+    value_type s_;
+
+public:
+    MatrixScalarExpr(E const& e, value_type s) : e_(e), s_(s) {}
+
+    int rows() const { return e_.rows(); }
+    int cols() const { return e_.cols(); }
+    value_type operator()(int i, int j) const { return Op::apply(e_(i, j), s_); }
+    bool aliases(expr_extent<value_type> const& dst) const { return e_.aliases(dst); }
+
+    // A += alpha * B felismeréséhez (lásd Matrix::operator+=)
+    typename expr_storage<E>::type operand() const { return e_; }
+    value_type scalar() const { return s_; }
+};
+
+template<typename E>
+class MatrixNegateExpr : public MatrixExpr<MatrixNegateExpr<E>> {
+    typename expr_storage<E>::type e_;
+
+public:
+    using value_type = typename E::value_type;
+
+    explicit MatrixNegateExpr(E const& e) : e_(e) {}
+
+    int rows() const { return e_.rows(); }
+    int cols() const { return e_.cols(); }
+    value_type operator()(int i, int j) const { return -e_(i, j); }
+    bool aliases(expr_extent<value_type> const& dst) const { return e_.aliases(dst); }
+};
+
+template<typename L, typename R>
+MatrixBinaryExpr<L, R, expr_add> operator+(MatrixExpr<L> const& a, MatrixExpr<R> const& b) {
+    return {a.self(), b.self()};
+}
+
+template<typename L, typename R>
+MatrixBinaryExpr<L, R, expr_sub> operator-(MatrixExpr<L> const& a, MatrixExpr<R> const& b) {
+    return {a.self(), b.self()};
+}
+
+template<typename E>
+MatrixNegateExpr<E> operator-(MatrixExpr<E> const& e) {
+    return MatrixNegateExpr<E>(e.self());
+}
+
+template<typename E>
+MatrixScalarExpr<E, expr_mul> operator*(MatrixExpr<E> const& e, typename E::value_type const& s) {
+    return {e.self(), s};
+}
+
+template<typename E>
+MatrixScalarExpr<E, expr_mul> operator*(typename E::value_type const& s, MatrixExpr<E> const& e) {
+    return {e.self(), s};
+}
+
+template<typename E>
+MatrixScalarExpr<E, expr_div> operator/(MatrixExpr<E> const& e, typename E::value_type const& s) {
+    return {e.self(), s};
+}
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "gemm.h"
+#include "thread_pool.h"
+#include "transpose.h"
+
+/*
+ Nem birtokló mátrixnézetek (másolás nélküli blokkok, sorok, oszlopok)
+
+ Egy nézet: kezdőcím, sorok és oszlopok száma, valamint a sorlépés
+ (leading dimension) és az oszloplépés (stride). Így egy mátrix bármely
+ téglalap alakú blokkja, egy sora, oszlopa vagy akár a transzponáltja
+ is leírható az adatok másolása nélkül.
+
+   MatrixView<T>: csak olvasható nézet
+   MatrixRef<T> : írható nézet (a MatrixView-ból származik)
+
+ A nézetek kifejezések is (matrix_expr.h), így pl. A.block(0, 0, 2, 2) + B
+ vagy C.block(...) += A.row(0) * 2.0 is működik.
+ Figyelem: a nézet nem tartja életben az alatta lévő mátrixot.
+*/
+template<typename T>
+class MatrixView : public MatrixExpr<MatrixView<T>> {
+protected:
+    T const* data_;
+    int rows_, cols_;
+    int rs_, cs_;  // sorlépés (leading dimension) és oszloplépés
+
+public:
+    using value_type = T;
+
+    MatrixView(T const* data, int rows, int cols, int ld, int stride = 1)
+        : data_(data), rows_(rows), cols_(cols), rs_(ld), cs_(stride) {}
+
+    int rows() const { return rows_; }
+    int cols() const { return cols_; }
+    int ld() const { return rs_; }
+    int stride() const { return cs_; }
+    T const* data() const { return data_; }
+
+    T const& operator()(int i, int j) const { return data_[i * rs_ + j * cs_]; }
+
+    expr_extent<T> extent() const { return {data_, rows_, cols_, rs_, cs_}; }
+    bool aliases(expr_extent<T> const& dst) const { return expr_overlaps(extent(), dst); }
+
+    // Sorfolytonos, hézag nélküli-e (ekkor egyetlen pufferként kezelhető)
+    bool contiguous() const { return cs_ == 1 && (rs_ == cols_ || rows_ <= 1); }
+
+    MatrixView<T> block(int r0, int c0, int rows, int cols) const {
+        check_block(r0, c0, rows, cols);
+        return MatrixView<T>(data_ + r0 * rs_ + c0 * cs_, rows, cols, rs_, cs_);
+    }
+
+    MatrixView<T> row(int i) const { return block(i, 0, 1, cols_); }
+    MatrixView<T> col(int j) const { return block(0, j, rows_, 1); }
+
+    // Transzponált nézet: csak a lépések cserélődnek
+    MatrixView<T> t() const { return MatrixView<T>(data_, cols_, rows_, cs_, rs_); }
+
+protected:
+    void check_block(int r0, int c0, int rows, int cols) const {
+        if (r0 < 0 || c0 < 0 || rows < 0 || cols < 0 || r0 + rows > rows_ || c0 + cols > cols_)
+            throw std::out_of_range("Matrix block out of range");
+    }
+};
+
+template<typename T>
+class MatrixRef : public MatrixView<T> {
+    using Base = MatrixView<T>;
+    using Base::rs_;
+    using Base::cs_;
+
+    /*
+     Elemenkénti menet a kifejezésen: (*this)(i, j) = op((*this)(i, j), e(i, j))
+     Ha a kifejezés más elrendezésben olvassa a célt (transzponált, eltolt
+     blokk), előbb egy ideiglenes tárolóba értékelünk.
+    */
+    template<typename E, typename Op>
+    void apply_expr(E const& e, Op op) const {
+        check_same_size(this->rows(), e.rows());
+        check_same_size(this->cols(), e.cols());
+        if (e.aliases(this->extent())) {
+            int cols = this->cols();
+            std::vector<T> tmp(static_cast<std::size_t>(this->rows()) * cols);
+            parallel_for(0, this->rows(), std::max(1, (1 << 15) / std::max(1, cols)), [&](int i0, int i1) {
+                for (int i = i0; i < i1; ++i)
+                    for (int j = 0; j < cols; ++j) tmp[static_cast<std::size_t>(i) * cols + j] = e(i, j);
+            });
+            apply_expr(MatrixView<T>(tmp.data(), this->rows(), cols, cols), op);
+            return;
+        }
+        T* d = data();
+        parallel_for(0, this->rows(), std::max(1, (1 << 15) / std::max(1, this->cols())), [&](int i0, int i1) {
+            for (int i = i0; i < i1; ++i) {
+                T* di = d + i * rs_;
+                for (int j = 0; j < this->cols(); ++j)
+                    di[j * cs_] = op(di[j * cs_], e(i, j));
+            }
+        });
+    }
+
+public:
+    MatrixRef(T* data, int rows, int cols, int ld, int stride = 1)
+        : Base(data, rows, cols, ld, stride) {}
+
+    MatrixRef(MatrixRef const&) = default;
+
+    // Írható nézetből épültünk, így a const eltávolítása itt biztonságos
+    T* data() const { return const_cast<T*>(this->data_); }
+
+    T& operator()(int i, int j) const { return data()[i * rs_ + j * cs_]; }
+
+    MatrixRef<T> block(int r0, int c0, int rows, int cols) const {
+        this->check_block(r0, c0, rows, cols);
+        return MatrixRef<T>(data() + r0 * rs_ + c0 * cs_, rows, cols, rs_, cs_);
+    }
+
+    MatrixRef<T> row(int i) const { return block(i, 0, 1, this->cols()); }
+    MatrixRef<T> col(int j) const { return block(0, j, this->rows(), 1); }
+    MatrixRef<T> t() const { return MatrixRef<T>(data(), this->cols(), this->rows(), cs_, rs_); }
+
+    // Értékadás a nézeten keresztül (a mögöttes mátrixba ír), a méretnek egyeznie kell
+    MatrixRef const& operator=(MatrixRef const& other) const {
+        apply_expr(static_cast<Base const&>(other), [](T const&, T const& x) { return x; });
+        return *this;
+    }
+
+    template<typename E>
+    MatrixRef const& operator=(MatrixExpr<E> const& e) const {
+        apply_expr(e.self(), [](T const&, T const& x) { return x; });
+        return *this;
+    }
+
+    template<typename E>
+    MatrixRef const& operator+=(MatrixExpr<E> const& e) const {
+        apply_expr(e.self(), [](T const& d, T const& x) { return d + x; });
+        return *this;
+    }
+
+    template<typename E>
+    MatrixRef const& operator-=(MatrixExpr<E> const& e) const {
+        apply_expr(e.self(), [](T const& d, T const& x) { return d - x; });
+        return *this;
+    }
+
+    MatrixRef const& operator*=(T const& s) const {
+        apply_expr(static_cast<Base const&>(*this), [s](T const& d, T const&) { return d * s; });
+        return *this;
+    }
+
+    void fill(T const& val) const {
+        apply_expr(static_cast<Base const&>(*this), [&val](T const&, T const&) { return val; });
+    }
+};
+
+/*
+ Nézeteken dolgozó kernelek
+*/
+
+// c += alpha * a * b (a blokkosított, párhuzamos GEMM-mel)
+template<typename T>
+void gemm(T alpha, MatrixView<T> a, MatrixView<T> b, MatrixRef<T> c) {
+    check_same_size(a.cols(), b.rows());
+    check_same_size(c.rows(), a.rows());
+    check_same_size(c.cols(), b.cols());
+    matrix_kernels::gemm(a.rows(), b.cols(), a.cols(), alpha,
+                         a.data(), a.ld(), a.stride(),
+                         b.data(), b.ld(), b.stride(),
+                         c.data(), c.ld(), c.stride());
+}
+
+// y += alpha * a * x, ahol x és y oszlop- vagy sornézet (1 x n vagy n x 1)
+template<typename T>
+void gemv(T alpha, MatrixView<T> a, MatrixView<T> x, MatrixRef<T> y) {
+    auto length = [](MatrixView<T> const& v) { return v.rows() == 1 ? v.cols() : v.rows(); };
+    auto step = [](MatrixView<T> const& v) { return v.rows() == 1 ? v.stride() : v.ld(); };
+    if ((x.rows() != 1 && x.cols() != 1) || (y.rows() != 1 && y.cols() != 1))
+        throw MatrixSizeMismatch();
+    check_same_size(a.cols(), length(x));
+    check_same_size(a.rows(), length(y));
+    int incx = step(x), incy = step(y);
+    T const* xp = x.data();
+    T* yp = y.data();
+    int n = a.cols();
+    parallel_for(0, a.rows(), std::max(1, (1 << 15) / std::max(1, n)), [&](int i0, int i1) {
+        for (int i = i0; i < i1; ++i) {
+            T const* ai = a.data() + i * a.ld();
+            T sum{};
+            for (int j = 0; j < n; ++j)
+                sum += ai[j * a.stride()] * xp[j * incx];
+            yp[i * incy] += alpha * sum;
+        }
+    });
+}
+
+/*
+ dst = src^T (méretek: dst.rows() == src.cols(), dst.cols() == src.rows())
+ Soronként folytonos nézetekre a blokkosított kernel fut (transpose.h),
+ ugyanarra a négyzetes területre helyben; egyébként elemenként.
+*/
+template<typename T>
+void transpose(MatrixView<T> src, MatrixRef<T> dst) {
+    check_same_size(dst.rows(), src.cols());
+    check_same_size(dst.cols(), src.rows());
+    if (src.stride() != 1 || dst.stride() != 1) {
+        dst = src.t();
+    } else if (src.data() == dst.data() && src.ld() == dst.ld() && src.rows() == src.cols()) {
+        matrix_kernels::transpose_inplace(src.rows(), dst.data(), dst.ld());
+    } else {
+        matrix_kernels::transpose(src.rows(), src.cols(), src.data(), src.ld(), dst.data(), dst.ld());
+    }
+}
+
+// dst += src
+template<typename T>
+void add(MatrixRef<T> dst, MatrixView<T> src) {
+    dst += src;
+}
@@ -0,0 +1,297 @@
+#include "numerics_c.h"
+
+#include <algorithm>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+#include "matrix.h"
+#include "../elso_hf/fastmath.h"
+#include "../elso_hf/integrate_batch.h"
+#include "../elso_hf/math_hw.h"
+#include "../elso_hf/quadrature.h"
+#include "../elso_hf/romberg.h"
+
+/*
+ A C felület megvalósítása (numerics_c.h)
+
+ Minden belépési pont egy guard()-on át fut: a C++ kivételeket itt
+ fordítjuk hibakódra, a határon semmi nem jut át. A mátrixfüggvények a
+ hívó pufferére állított nézetekkel (matrix_view.h) és a nyers
+ LU-kernelekkel (lu.h) dolgoznak, így nincs másolás.
+*/
+namespace {
+
+class SingularMatrix : public std::runtime_error {
+public:
+    SingularMatrix() : std::runtime_error("Matrix is singular") {}
+};
+
+template<typename F>
+int guard(F&& body) {
+    try {
+        body();
+        return NUMERICS_OK;
+    } catch (MatrixSizeMismatch const&) {
+        return NUMERICS_ERROR_ARGUMENT;
+    } catch (std::invalid_argument const&) {
+        return NUMERICS_ERROR_ARGUMENT;
+    } catch (SingularMatrix const&) {
+        return NUMERICS_ERROR_SINGULAR;
+    } catch (std::bad_alloc const&) {
+        return NUMERICS_ERROR_MEMORY;
+    } catch (...) {
+        return NUMERICS_ERROR_INTERNAL;
+    }
+}
+
+void require(bool ok) {
+    if (!ok) throw std::invalid_argument("numerics: invalid argument");
+}
+
+// rows x cols mátrix ld sorhosszal: a puffer létezik, ha nem üres
+void require_matrix(const void* p, int rows, int cols, int ld) {
+    require(rows >= 0 && cols >= 0 && ld >= std::max(1, cols));
+    require(p != nullptr || rows == 0 || cols == 0);
+}
+
+// Batched integrand a C visszahívásból
+struct Integrand {
+    numerics_integrand f;
+    void* user;
+    void operator()(const double* x, double* y, std::size_t n) const { f(x, y, n, user); }
+};
+
+QuadratureOptions options(const numerics_quadrature_options* opt) {
+    QuadratureOptions o;
+    if (opt) {
+        o.abs_tol = opt->abs_tol;
+        o.rel_tol = opt->rel_tol;
+        o.max_evaluations = opt->max_evaluations;
+        o.max_depth = opt->max_depth;
+    }
+    return o;
+}
+
+void store(QuadratureResult const& r, numerics_quadrature_result* out) {
+    out->value = r.value;
+    out->error = r.error;
+    out->evaluations = r.evaluations;
+    out->intervals = r.intervals;
+    out->converged = r.converged ? 1 : 0;
+}
+
+MathAccuracy accuracy(int a) {
+    require(a >= NUMERICS_ACCURACY_LOW && a <= NUMERICS_ACCURACY_FULL);
+    return static_cast<MathAccuracy>(a);
+}
+
+// y = beta * y (beta == 0 esetén a korábbi tartalom, pl. NaN, sem számít)
+void scale(double* y, int rows, int cols, int ld, double beta) {
+    if (beta == 1.0) return;
+    for (int i = 0; i < rows; ++i) {
+        double* yi = y + static_cast<std::size_t>(i) * ld;
+        if (beta == 0.0)
+            std::fill(yi, yi + cols, 0.0);
+        else
+            matrix_kernels::simd_scale(yi, beta, static_cast<std::size_t>(cols));
+    }
+}
+
+void factor(int n, double* a, int lda, int* piv) {
+    require_matrix(a, n, n, lda);
+    require(piv != nullptr || n == 0);
+    if (matrix_kernels::lu_factor(n, a, lda, piv) >= 0) throw SingularMatrix();
+}
+
+template<typename Q>
+int quadrature(numerics_integrand f, void* user, const numerics_quadrature_options* opt,
+               numerics_quadrature_result* result, Q q) {
+    return guard([&] {
+        require(f != nullptr && result != nullptr);
+        store(q(Integrand{f, user}, options(opt)), result);
+    });
+}
+
+} // namespace
+
+extern "C" {
+
+int numerics_abi_version(void) { return NUMERICS_ABI_VERSION; }
+
+const char* numerics_error_string(int status) {
+    switch (status) {
+    case NUMERICS_OK: return "ok";
+    case NUMERICS_ERROR_ARGUMENT: return "invalid argument";
+    case NUMERICS_ERROR_SINGULAR: return "matrix is singular";
+    case NUMERICS_ERROR_MEMORY: return "out of memory";
+    default: return "internal error";
+    }
+}
+
+int numerics_set_num_threads(int threads) {
+    return guard([&] {
+        require(threads > 0);
+        set_num_threads(static_cast<unsigned>(threads));
+    });
+}
+
+int numerics_get_num_threads(void) { return static_cast<int>(get_num_threads()); }
+
+void numerics_quadrature_defaults(numerics_quadrature_options* opt) {
+    if (!opt) return;
+    QuadratureOptions o;
+    opt->abs_tol = o.abs_tol;
+    opt->rel_tol = o.rel_tol;
+    opt->max_evaluations = o.max_evaluations;
+    opt->max_depth = o.max_depth;
+}
+
+int numerics_simpson(numerics_integrand f, void* user, double a, double b, long long n, double* value) {
+    return guard([&] {
+        require(f != nullptr && value != nullptr);
+        *value = integrate(Integrand{f, user}, a, b, n);
+    });
+}
+
+int numerics_simpson_batch(numerics_integrand f, void* user, size_t count, const double* a,
+                           const double* b, const long long* n, long long n_all, double* out) {
+    return guard([&] {
+        require(f != nullptr && (count == 0 || (a && b && out)));
+        if (n)
+            integrate_batch(Integrand{f, user}, a, b, n, out, count);
+        else
+            integrate_batch(Integrand{f, user}, a, b, n_all, out, count);
+    });
+}
+
+int numerics_adaptive_simpson(numerics_integrand f, void* user, double a, double b,
+                              const numerics_quadrature_options* opt, numerics_quadrature_result* result) {
+    return quadrature(f, user, opt, result, [&](Integrand g, QuadratureOptions const& o) {
+        return adaptive_simpson(g, a, b, o);
+    });
+}
+
+int numerics_gauss_kronrod(numerics_integrand f, void* user, double a, double b,
+                           const numerics_quadrature_options* opt, numerics_quadrature_result* result) {
+    return quadrature(f, user, opt, result, [&](Integrand g, QuadratureOptions const& o) {
+        return gauss_kronrod(g, a, b, o);
+    });
+}
+
+int numerics_romberg(numerics_integrand f, void* user, double a, double b,
+                     const numerics_quadrature_options* opt, numerics_quadrature_result* result) {
+    return quadrature(f, user, opt, result, [&](Integrand g, QuadratureOptions const& o) {
+        return Romberg<Integrand>(g, a, b).integrate_to(o);
+    });
+}
+
+int numerics_pade_exp(const double* x, double* y, size_t n) {
+    return guard([&] { require(n == 0 || (x && y)); my_exp(x, y, n); });
+}
+
+int numerics_pade_cos(const double* x, double* y, size_t n) {
+    return guard([&] { require(n == 0 || (x && y)); my_cos(x, y, n); });
+}
+
+int numerics_pade_gauss_cos(const double* x, double* y, size_t n) {
+    return guard([&] { require(n == 0 || (x && y)); my_gauss_cos(x, y, n); });
+}
+
+int numerics_exp(const double* x, double* y, size_t n, int acc) {
+    return guard([&] { require(n == 0 || (x && y)); fast_exp(x, y, n, accuracy(acc)); });
+}
+
+int numerics_cos(const double* x, double* y, size_t n, int acc) {
+    return guard([&] { require(n == 0 || (x && y)); fast_cos(x, y, n, accuracy(acc)); });
+}
+
+int numerics_gauss_cos(const double* x, double* y, size_t n, int acc) {
+    return guard([&] { require(n == 0 || (x && y)); fast_gauss_cos(x, y, n, accuracy(acc)); });
+}
+
+int numerics_dgemm(int trans_a, int trans_b, int m, int n, int k, double alpha,
+                   const double* a, int lda, const double* b, int ldb,
+                   double beta, double* c, int ldc) {
+    return guard([&] {
+        // Transzponált tárolásnál csak a lépések cserélődnek
+        require_matrix(a, trans_a ? k : m, trans_a ? m : k, lda);
+        require_matrix(b, trans_b ? n : k, trans_b ? k : n, ldb);
+        require_matrix(c, m, n, ldc);
+        scale(c, m, n, ldc, beta);
+        if (alpha == 0.0) return;
+        MatrixView<double> va = trans_a ? MatrixView<double>(a, m, k, 1, lda) : MatrixView<double>(a, m, k, lda);
+        MatrixView<double> vb = trans_b ? MatrixView<double>(b, k, n, 1, ldb) : MatrixView<double>(b, k, n, ldb);
+        gemm(alpha, va, vb, MatrixRef<double>(c, m, n, ldc));
+    });
+}
+
+int numerics_dgemv(int m, int n, double alpha, const double* a, int lda,
+                   const double* x, double beta, double* y) {
+    return guard([&] {
+        require_matrix(a, m, n, lda);
+        require((x != nullptr || n == 0) && (y != nullptr || m == 0));
+        scale(y, 1, m, std::max(1, m), beta);
+        if (alpha == 0.0 || m == 0 || n == 0) return;
+        gemv(alpha, MatrixView<double>(a, m, n, lda), MatrixView<double>(x, n, 1, 1),
+             MatrixRef<double>(y, m, 1, 1));
+    });
+}
+
+int numerics_dgetrf(int n, double* a, int lda, int* piv) {
+    return guard([&] { factor(n, a, lda, piv); });
+}
+
+int numerics_dgetrs(int n, const double* lu, int lda, const int* piv, double* b, int nrhs, int ldb) {
+    return guard([&] {
+        require_matrix(lu, n, n, lda);
+        require_matrix(b, n, nrhs, ldb);
+        require(piv != nullptr || n == 0);
+        matrix_kernels::lu_solve(n, lu, lda, piv, b, nrhs, ldb);
+    });
+}
+
+int numerics_dgesv(int n, double* a, int lda, int* piv, double* b, int nrhs, int ldb) {
+    return guard([&] {
+        require_matrix(b, n, nrhs, ldb);
+        std::vector<int> own;
+        if (!piv) {
+            own.resize(static_cast<std::size_t>(std::max(n, 0)));
+            piv = own.data();
+        }
+        factor(n, a, lda, piv);
+        matrix_kernels::lu_solve(n, a, lda, piv, b, nrhs, ldb);
+    });
+}
+
+int numerics_ddet(int n, double* a, int lda, double* det) {
+    return guard([&] {
+        require_matrix(a, n, n, lda);
+        require(det != nullptr);
+        std::vector<int> piv(static_cast<std::size_t>(n));
+        double d = 1.0;
+        if (matrix_kernels::lu_factor(n, a, lda, piv.data()) >= 0)
+            d = 0.0;
+        for (int i = 0; i < n && d != 0.0; ++i) {
+            d *= a[static_cast<std::size_t>(i) * lda + i];
+            if (piv[i] != i) d = -d;
+        }
+        *det = d;
+    });
+}
+
+int numerics_dinv(int n, double* a, int lda, double* inv, int ldinv) {
+    return guard([&] {
+        require_matrix(inv, n, n, ldinv);
+        std::vector<int> piv(static_cast<std::size_t>(std::max(n, 0)));
+        factor(n, a, lda, piv.data());
+        for (int i = 0; i < n; ++i) {
+            double* row = inv + static_cast<std::size_t>(i) * ldinv;
+            std::fill(row, row + n, 0.0);
+            row[i] = 1.0;
+        }
+        matrix_kernels::lu_solve(n, a, lda, piv.data(), inv, n, ldinv);
+    });
+}
+
+} // extern "C"
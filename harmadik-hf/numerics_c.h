@@ -0,0 +1,160 @@
+#pragma once
+
+/*
+ A numerikus könyvtár (libnumerics) C felülete
+
+ Szkriptnyelvekből (pl. Python ctypes) másolás nélkül hívható: minden
+ függvény a hívó pufferein dolgozik, semmit nem foglal a hívónak.
+   - Mátrixok: double, sorfolytonos, ld (sorhossz, leading dimension)
+     elemnyi lépéssel, tehát egy nagyobb tömb blokkja is átadható;
+     a transzponált elrendezés trans_a / trans_b jelzővel kérhető.
+   - Visszatérési érték: NUMERICS_OK vagy hibakód, kivétel nem jut át.
+   - Az integrandus kötegelt visszahívás: y[i] = f(x[i]), i < n.
+     A könyvtár szálkészlete több szálról, egyszerre is hívhatja
+     (numerics_set_num_threads(1) esetén csak a hívó szálról).
+
+ Változatkezelés: NUMERICS_ABI_VERSION a fejléc, numerics_abi_version()
+ a betöltött könyvtár változata; a kettő egyezését érdemes betöltéskor
+ ellenőrizni. Egy változaton belül a függvények és a struktúrák nem
+ változnak, új függvény csak hozzáadódhat (a .so főverziója
+ NUMERICS_ABI_VERSION).
+*/
+
+#include <stddef.h>
+
+/* NUMERICS_STATIC: a forrásokat közvetlenül fordítjuk be (pl. MatrixBench), nincs export */
+#if defined(NUMERICS_STATIC)
+#  define NUMERICS_API
+#elif defined(_WIN32)
+#  if defined(NUMERICS_BUILD)
+#    define NUMERICS_API __declspec(dllexport)
+#  else
+#    define NUMERICS_API __declspec(dllimport)
+#  endif
+#elif defined(__GNUC__)
+#  define NUMERICS_API __attribute__((visibility("default")))
+#else
+#  define NUMERICS_API
+#endif
+
+#define NUMERICS_ABI_VERSION 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Hibakódok */
+enum {
+    NUMERICS_OK = 0,
+    NUMERICS_ERROR_ARGUMENT = 1,   /* NULL puffer, negatív vagy nem illeszkedő méret */
+    NUMERICS_ERROR_SINGULAR = 2,   /* szinguláris mátrix */
+    NUMERICS_ERROR_MEMORY = 3,     /* sikertelen belső foglalás */
+    NUMERICS_ERROR_INTERNAL = 4
+};
+
+/* Pontossági szintek a gyors exp/cos-hoz (elso_hf/fastmath.h) */
+enum {
+    NUMERICS_ACCURACY_LOW = 0,     /* ~1e-4 relatív hiba */
+    NUMERICS_ACCURACY_MEDIUM = 1,  /* ~1e-8 */
+    NUMERICS_ACCURACY_FULL = 2     /* ~1 ulp */
+};
+
+NUMERICS_API int numerics_abi_version(void);
+NUMERICS_API const char* numerics_error_string(int status);
+
+/* A könyvtár szálkészlete (alapból MATRIX_NUM_THREADS vagy a hardveres szálak száma) */
+NUMERICS_API int numerics_set_num_threads(int threads);
+NUMERICS_API int numerics_get_num_threads(void);
+
+/*
+ Integrálás
+*/
+
+/* y[i] = f(x[i]), i < n; user a hívó saját adata */
+typedef void (*numerics_integrand)(const double* x, double* y, size_t n, void* user);
+
+typedef struct {
+    double abs_tol;
+    double rel_tol;
+    long long max_evaluations;
+    int max_depth;                 /* felezési szintek (adaptív Simpson) */
+} numerics_quadrature_options;
+
+typedef struct {
+    double value;
+    double error;                  /* becsült abszolút hiba */
+    long long evaluations;
+    int intervals;
+    int converged;                 /* 1, ha a kért pontosság teljesült */
+} numerics_quadrature_result;
+
+/* Az alapértelmezett beállítások (mint QuadratureOptions{}) */
+NUMERICS_API void numerics_quadrature_defaults(numerics_quadrature_options* opt);
+
+/* Simpson-szabály [a, b]-n n részintervallummal (páratlan n-t felfelé kerekítjük) */
+NUMERICS_API int numerics_simpson(numerics_integrand f, void* user, double a, double b, long long n, double* value);
+
+/* Simpson-szabály [a[k], b[k]]-n out[k]-ba, k < count; n[k] részintervallum, vagy n == NULL esetén mindegyikre n_all */
+NUMERICS_API int numerics_simpson_batch(numerics_integrand f, void* user, size_t count, const double* a,
+                                        const double* b, const long long* n, long long n_all, double* out);
+
+/* Adaptív Simpson, G7K15 és Romberg; opt == NULL: alapbeállítások */
+NUMERICS_API int numerics_adaptive_simpson(numerics_integrand f, void* user, double a, double b,
+                                           const numerics_quadrature_options* opt, numerics_quadrature_result* result);
+NUMERICS_API int numerics_gauss_kronrod(numerics_integrand f, void* user, double a, double b,
+                                        const numerics_quadrature_options* opt, numerics_quadrature_result* result);
+NUMERICS_API int numerics_romberg(numerics_integrand f, void* user, double a, double b,
+                                  const numerics_quadrature_options* opt, numerics_quadrature_result* result);
+
+/*
+ exp / cos tömbökre: y[i] = g(x[i]), i < n (x és y lehet ugyanaz)
+*/
+
+/* Padé-közelítések (elso_hf/math_hw.h) */
+NUMERICS_API int numerics_pade_exp(const double* x, double* y, size_t n);
+NUMERICS_API int numerics_pade_cos(const double* x, double* y, size_t n);
+NUMERICS_API int numerics_pade_gauss_cos(const double* x, double* y, size_t n);
+
+/* Tartományszűkítéses változatok pontossági szinttel (elso_hf/fastmath.h) */
+NUMERICS_API int numerics_exp(const double* x, double* y, size_t n, int accuracy);
+NUMERICS_API int numerics_cos(const double* x, double* y, size_t n, int accuracy);
+NUMERICS_API int numerics_gauss_cos(const double* x, double* y, size_t n, int accuracy);
+
+/*
+ Sűrű mátrixok (sorfolytonos double, Matrix<double> kernelei)
+*/
+
+/* C = alpha * op(A) * op(B) + beta * C, op(A): m x k, op(B): k x n; trans: 0 vagy 1 */
+NUMERICS_API int numerics_dgemm(int trans_a, int trans_b, int m, int n, int k, double alpha,
+                                const double* a, int lda, const double* b, int ldb,
+                                double beta, double* c, int ldc);
+
+/* y = alpha * A * x + beta * y, A: m x n */
+NUMERICS_API int numerics_dgemv(int m, int n, double alpha, const double* a, int lda,
+                                const double* x, double beta, double* y);
+
+/* LU-felbontás helyben (P * A = L * U), piv: n elem; szingulárisnál NUMERICS_ERROR_SINGULAR, a tényezők akkor is kiíródnak */
+NUMERICS_API int numerics_dgetrf(int n, double* a, int lda, int* piv);
+
+/* A * X = B a felbontásból, B (n x nrhs) helyén */
+NUMERICS_API int numerics_dgetrs(int n, const double* lu, int lda, const int* piv, double* b, int nrhs, int ldb);
+
+/* A * X = B megoldása: A helyére a felbontás, B helyére X kerül; piv lehet NULL */
+NUMERICS_API int numerics_dgesv(int n, double* a, int lda, int* piv, double* b, int nrhs, int ldb);
+
+/* Determináns; A helyére a felbontás kerül (szinguláris mátrixra 0) */
+NUMERICS_API int numerics_ddet(int n, double* a, int lda, double* det);
+
+/* Inverz inv-be; A helyére a felbontás kerül */
+NUMERICS_API int numerics_dinv(int n, double* a, int lda, double* inv, int ldinv);
+
+/*
+ Az első házi korábbi szimbólumai (elso_hf/fifth.cpp), változatlanul
+*/
+NUMERICS_API double func(double x_f);
+NUMERICS_API double integrate(int n, double x0, double x1);
+NUMERICS_API void integrate_batch(int count, const double* x0, const double* x1, const int* n, int n_all, double* out);
+
+#ifdef __cplusplus
+}
+#endif
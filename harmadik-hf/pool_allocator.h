@@ -0,0 +1,194 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+/*
+ 64 bájtra igazított, méretosztályos memóriakészlet a Matrix tárolójához
+
+ A kéréseket kettő-hatvány méretosztályokba kerekítjük (64 B ... 4 MiB).
+ Felszabadításkor a blokk a szál saját szabadlistájára kerül, és a következő
+ azonos osztályú foglalás onnan kapja meg, így egy ismétlődő számítási
+ ciklus bemelegedés után nem fordul a heaphez. A szabadlisták szálankéntiek
+ (nincs zár), a más szálon foglalt blokk a felszabadító szál listájára kerül.
+ A 4 MiB-nál nagyobb kérések (kerekítés nélkül) és a gyorsítótár-korlát
+ feletti blokkok közvetlenül a heapre mennek.
+
+ allocation_stats() mutatja, hányszor kellett ténylegesen a heaphez fordulni.
+ Visszatartott memória: szálanként legfeljebb 32 MiB, vagyis összesen
+ legfeljebb (munkásszálak + foglaló külső szálak) x 32 MiB. A
+ release_thread_cache() a hívó szál listáit üríti; a szálkészlet
+ átméretezéskor (set_num_threads) és leálláskor maga is meghívja.
+*/
+struct AllocationStats {
+    long long heap_allocations = 0;    // tényleges (igazított) operator new hívások
+    long long heap_deallocations = 0;  // tényleges operator delete hívások
+    long long pool_hits = 0;           // szabadlistáról kiszolgált foglalások
+    long long pool_returns = 0;        // szabadlistára visszatett blokkok
+};
+
+namespace pool_detail {
+
+constexpr std::size_t alignment = 64;
+constexpr int min_class_log2 = 6;   // 64 B
+constexpr int max_class_log2 = 22;  // 4 MiB; felette a kerekítés túl sokat pazarolna
+constexpr int class_count = max_class_log2 - min_class_log2 + 1;
+
+// Szálanként legfeljebb ennyi bájtot tartunk félre
+constexpr std::size_t max_cached_bytes = std::size_t(32) << 20;
+
+struct Counters {
+    std::atomic<long long> heap_allocations{0};
+    std::atomic<long long> heap_deallocations{0};
+    std::atomic<long long> pool_hits{0};
+    std::atomic<long long> pool_returns{0};
+};
+
+inline Counters& counters() {
+    static Counters c;
+    return c;
+}
+
+inline void* heap_allocate(std::size_t bytes) {
+    counters().heap_allocations.fetch_add(1, std::memory_order_relaxed);
+    return ::operator new(bytes, std::align_val_t{alignment});
+}
+
+inline void heap_deallocate(void* p) {
+    counters().heap_deallocations.fetch_add(1, std::memory_order_relaxed);
+    ::operator delete(p, std::align_val_t{alignment});
+}
+
+// A legkisebb osztály, amibe bytes belefér; -1, ha nagyobb a legnagyobbnál
+inline int size_class(std::size_t bytes) {
+    int c = 0;
+    std::size_t cap = std::size_t(1) << min_class_log2;
+    while (cap < bytes) {
+        cap <<= 1;
+        if (++c >= class_count) return -1;
+    }
+    return c;
+}
+
+inline std::size_t class_bytes(int c) { return std::size_t(1) << (c + min_class_log2); }
+
+// Szabad blokkok láncolt listája; a "következő" mutatót magában a blokkban tároljuk
+struct FreeBlock {
+    FreeBlock* next;
+};
+
+// A szál kilépése után (pl. statikus objektumok lebontásakor) már nem használható
+inline thread_local bool cache_destroyed = false;
+
+struct ThreadCache {
+    FreeBlock* heads[class_count] = {};
+    std::size_t cached_bytes = 0;
+
+    void release() {
+        for (FreeBlock*& head : heads)
+            while (head) {
+                FreeBlock* next = head->next;
+                heap_deallocate(head);
+                head = next;
+            }
+        cached_bytes = 0;
+    }
+
+    ~ThreadCache() {
+        release();
+        cache_destroyed = true;
+    }
+};
+
+inline ThreadCache* thread_cache() {
+    if (cache_destroyed) return nullptr;
+    static thread_local ThreadCache cache;
+    return &cache;
+}
+
+inline void* allocate(std::size_t bytes) {
+    int c = size_class(bytes);
+    if (c < 0) return heap_allocate(bytes);
+    if (ThreadCache* cache = thread_cache()) {
+        if (FreeBlock* block = cache->heads[c]) {
+            cache->heads[c] = block->next;
+            cache->cached_bytes -= class_bytes(c);
+            counters().pool_hits.fetch_add(1, std::memory_order_relaxed);
+            return block;
+        }
+    }
+    return heap_allocate(class_bytes(c));
+}
+
+inline void deallocate(void* p, std::size_t bytes) {
+    int c = size_class(bytes);
+    ThreadCache* cache = c < 0 ? nullptr : thread_cache();
+    if (!cache || cache->cached_bytes + class_bytes(c) > max_cached_bytes) {
+        heap_deallocate(p);
+        return;
+    }
+    FreeBlock* block = static_cast<FreeBlock*>(p);
+    block->next = cache->heads[c];
+    cache->heads[c] = block;
+    cache->cached_bytes += class_bytes(c);
+    counters().pool_returns.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace pool_detail
+
+inline AllocationStats allocation_stats() {
+    auto& c = pool_detail::counters();
+    AllocationStats s;
+    s.heap_allocations = c.heap_allocations.load();
+    s.heap_deallocations = c.heap_deallocations.load();
+    s.pool_hits = c.pool_hits.load();
+    s.pool_returns = c.pool_returns.load();
+    return s;
+}
+
+// A hívó szál félretett blokkjainak visszaadása a heapnek
+inline void release_thread_cache() {
+    if (pool_detail::ThreadCache* cache = pool_detail::thread_cache()) cache->release();
+}
+
+inline void reset_allocation_stats() {
+    auto& c = pool_detail::counters();
+    c.heap_allocations = 0;
+    c.heap_deallocations = 0;
+    c.pool_hits = 0;
+    c.pool_returns = 0;
+}
+
+// Állapotmentes, szabványos allokátor a fenti készlet fölött
+template<typename T>
+class PoolAllocator {
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    PoolAllocator() noexcept = default;
+    template<typename U>
+    PoolAllocator(PoolAllocator<U> const&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        if (n > static_cast<std::size_t>(-1) / sizeof(T)) throw std::bad_array_new_length();
+        return static_cast<T*>(pool_detail::allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+        pool_detail::deallocate(p, n * sizeof(T));
+    }
+
+    template<typename U>
+    bool operator==(PoolAllocator<U> const&) const noexcept { return true; }
+    template<typename U>
+    bool operator!=(PoolAllocator<U> const&) const noexcept { return false; }
+};
+
+// Számtípusokhoz a készlet az alapértelmezett, minden máshoz a std::allocator
+template<typename T>
+using default_matrix_allocator =
+    std::conditional_t<std::is_arithmetic_v<T>, PoolAllocator<T>, std::allocator<T>>;
@@ -0,0 +1,311 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+#include "cpu_features.h"
+
+/*
+ SIMD elemenkénti kernelek a Matrix összetett értékadásaihoz
+
+   simd_add  : d[i] += s[i]
+   simd_sub  : d[i] -= s[i]
+   simd_scale: d[i] *= alpha
+   simd_div  : d[i] /= alpha
+   simd_axpy : d[i] += alpha * s[i]
+
+ float, double és int elemekre SSE2 / AVX2 / AVX-512 változat közül a
+ simd_level() szerint választunk futásidőben, a maradék elemeket és minden
+ más típust skalár ciklus intéz. Nem igazított betöltést használunk, így
+ tetszőleges pufferen működik. Ami egy szinten nem létezik (int szorzás
+ SSE2-vel, int osztás), az skalárisan fut.
+*/
+namespace matrix_kernels {
+
+enum class ElemOp { add, sub, scale, div, axpy };
+
+template<ElemOp Op, typename T>
+inline void elem_scalar(T* d, T const* s, T alpha, std::size_t i0, std::size_t n) {
+    for (std::size_t i = i0; i < n; ++i) {
+        if constexpr (Op == ElemOp::add) d[i] += s[i];
+        else if constexpr (Op == ElemOp::sub) d[i] -= s[i];
+        else if constexpr (Op == ElemOp::scale) d[i] *= alpha;
+        else if constexpr (Op == ElemOp::div) d[i] /= alpha;
+        else d[i] += alpha * s[i];
+    }
+}
+
+#ifdef MATRIX_X86_DISPATCH
+
+#define MATRIX_TARGET_SSE2 __attribute__((target("sse2")))
+#define MATRIX_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define MATRIX_TARGET_AVX512 __attribute__((target("avx512f,avx2,fma")))
+
+/*
+ Vektortípus-jellemzők szintenként és elemtípusonként
+ has_mul / has_div / has_fma jelzi, mely műveletek vannak vektorosan;
+ sqrt, rsqrt, min és max csak a lebegőpontos típusokra létezik. Az rsqrt
+ közelítés: SSE2/AVX2-n float pontossággal ~12 bit (double-nél float-on
+ át), AVX-512-n ~14 bit. (AVX-512-n teljes
+ maszkkal: a maszk nélküli intrinsic-ekre a GCC 12 hamis "uninitialized"
+ figyelmeztetést ad).
+*/
+template<typename T> struct sse2_vec;
+template<typename T> struct avx2_vec;
+template<typename T> struct avx512_vec;
+
+template<> struct sse2_vec<double> {
+    using reg = __m128d;
+    static constexpr std::size_t width = 2;
+    static constexpr bool has_mul = true, has_div = true, has_fma = false;
+    MATRIX_TARGET_SSE2 static reg load(double const* p) { return _mm_loadu_pd(p); }
+    MATRIX_TARGET_SSE2 static void store(double* p, reg v) { _mm_storeu_pd(p, v); }
+    MATRIX_TARGET_SSE2 static reg set1(double s) { return _mm_set1_pd(s); }
+    MATRIX_TARGET_SSE2 static reg add(reg a, reg b) { return _mm_add_pd(a, b); }
+    MATRIX_TARGET_SSE2 static reg sub(reg a, reg b) { return _mm_sub_pd(a, b); }
+    MATRIX_TARGET_SSE2 static reg mul(reg a, reg b) { return _mm_mul_pd(a, b); }
+    MATRIX_TARGET_SSE2 static reg div(reg a, reg b) { return _mm_div_pd(a, b); }
+    MATRIX_TARGET_SSE2 static reg sqrt(reg a) { return _mm_sqrt_pd(a); }
+    MATRIX_TARGET_SSE2 static reg rsqrt(reg a) { return _mm_cvtps_pd(_mm_rsqrt_ps(_mm_cvtpd_ps(a))); }
+    MATRIX_TARGET_SSE2 static reg min(reg a, reg b) { return _mm_min_pd(a, b); }
+    MATRIX_TARGET_SSE2 static reg max(reg a, reg b) { return _mm_max_pd(a, b); }
+};
+
+template<> struct sse2_vec<float> {
+    using reg = __m128;
+    static constexpr std::size_t width = 4;
+    static constexpr bool has_mul = true, has_div = true, has_fma = false;
+    MATRIX_TARGET_SSE2 static reg load(float const* p) { return _mm_loadu_ps(p); }
+    MATRIX_TARGET_SSE2 static void store(float* p, reg v) { _mm_storeu_ps(p, v); }
+    MATRIX_TARGET_SSE2 static reg set1(float s) { return _mm_set1_ps(s); }
+    MATRIX_TARGET_SSE2 static reg add(reg a, reg b) { return _mm_add_ps(a, b); }
+    MATRIX_TARGET_SSE2 static reg sub(reg a, reg b) { return _mm_sub_ps(a, b); }
+    MATRIX_TARGET_SSE2 static reg mul(reg a, reg b) { return _mm_mul_ps(a, b); }
+    MATRIX_TARGET_SSE2 static reg div(reg a, reg b) { return _mm_div_ps(a, b); }
+    MATRIX_TARGET_SSE2 static reg sqrt(reg a) { return _mm_sqrt_ps(a); }
+    MATRIX_TARGET_SSE2 static reg rsqrt(reg a) { return _mm_rsqrt_ps(a); }
+    MATRIX_TARGET_SSE2 static reg min(reg a, reg b) { return _mm_min_ps(a, b); }
+    MATRIX_TARGET_SSE2 static reg max(reg a, reg b) { return _mm_max_ps(a, b); }
+};
+
+template<> struct sse2_vec<int> {
+    using reg = __m128i;
+    static constexpr std::size_t width = 4;
+    static constexpr bool has_mul = false, has_div = false, has_fma = false;  // mullo_epi32 csak SSE4.1-től
+    MATRIX_TARGET_SSE2 static reg load(int const* p) { return _mm_loadu_si128(reinterpret_cast<__m128i const*>(p)); }
+    MATRIX_TARGET_SSE2 static void store(int* p, reg v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+    MATRIX_TARGET_SSE2 static reg set1(int s) { return _mm_set1_epi32(s); }
+    MATRIX_TARGET_SSE2 static reg add(reg a, reg b) { return _mm_add_epi32(a, b); }
+    MATRIX_TARGET_SSE2 static reg sub(reg a, reg b) { return _mm_sub_epi32(a, b); }
+};
+
+template<> struct avx2_vec<double> {
+    using reg = __m256d;
+    static constexpr std::size_t width = 4;
+    static constexpr bool has_mul = true, has_div = true, has_fma = true;
+    MATRIX_TARGET_AVX2 static reg load(double const* p) { return _mm256_loadu_pd(p); }
+    MATRIX_TARGET_AVX2 static void store(double* p, reg v) { _mm256_storeu_pd(p, v); }
+    MATRIX_TARGET_AVX2 static reg set1(double s) { return _mm256_set1_pd(s); }
+    MATRIX_TARGET_AVX2 static reg add(reg a, reg b) { return _mm256_add_pd(a, b); }
+    MATRIX_TARGET_AVX2 static reg sub(reg a, reg b) { return _mm256_sub_pd(a, b); }
+    MATRIX_TARGET_AVX2 static reg mul(reg a, reg b) { return _mm256_mul_pd(a, b); }
+    MATRIX_TARGET_AVX2 static reg div(reg a, reg b) { return _mm256_div_pd(a, b); }
+    MATRIX_TARGET_AVX2 static reg sqrt(reg a) { return _mm256_sqrt_pd(a); }
+    MATRIX_TARGET_AVX2 static reg rsqrt(reg a) { return _mm256_cvtps_pd(_mm_rsqrt_ps(_mm256_cvtpd_ps(a))); }
+    MATRIX_TARGET_AVX2 static reg min(reg a, reg b) { return _mm256_min_pd(a, b); }
+    MATRIX_TARGET_AVX2 static reg max(reg a, reg b) { return _mm256_max_pd(a, b); }
+    MATRIX_TARGET_AVX2 static reg fmadd(reg a, reg b, reg c) { return _mm256_fmadd_pd(a, b, c); }
+};
+
+template<> struct avx2_vec<float> {
+    using reg = __m256;
+    static constexpr std::size_t width = 8;
+    static constexpr bool has_mul = true, has_div = true, has_fma = true;
+    MATRIX_TARGET_AVX2 static reg load(float const* p) { return _mm256_loadu_ps(p); }
+    MATRIX_TARGET_AVX2 static void store(float* p, reg v) { _mm256_storeu_ps(p, v); }
+    MATRIX_TARGET_AVX2 static reg set1(float s) { return _mm256_set1_ps(s); }
+    MATRIX_TARGET_AVX2 static reg add(reg a, reg b) { return _mm256_add_ps(a, b); }
+    MATRIX_TARGET_AVX2 static reg sub(reg a, reg b) { return _mm256_sub_ps(a, b); }
+    MATRIX_TARGET_AVX2 static reg mul(reg a, reg b) { return _mm256_mul_ps(a, b); }
+    MATRIX_TARGET_AVX2 static reg div(reg a, reg b) { return _mm256_div_ps(a, b); }
+    MATRIX_TARGET_AVX2 static reg sqrt(reg a) { return _mm256_sqrt_ps(a); }
+    MATRIX_TARGET_AVX2 static reg rsqrt(reg a) { return _mm256_rsqrt_ps(a); }
+    MATRIX_TARGET_AVX2 static reg min(reg a, reg b) { return _mm256_min_ps(a, b); }
+    MATRIX_TARGET_AVX2 static reg max(reg a, reg b) { return _mm256_max_ps(a, b); }
+    MATRIX_TARGET_AVX2 static reg fmadd(reg a, reg b, reg c) { return _mm256_fmadd_ps(a, b, c); }
+};
+
+template<> struct avx2_vec<int> {
+    using reg = __m256i;
+    static constexpr std::size_t width = 8;
+    static constexpr bool has_mul = true, has_div = false, has_fma = false;
+    MATRIX_TARGET_AVX2 static reg load(int const* p) { return _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p)); }
+    MATRIX_TARGET_AVX2 static void store(int* p, reg v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    MATRIX_TARGET_AVX2 static reg set1(int s) { return _mm256_set1_epi32(s); }
+    MATRIX_TARGET_AVX2 static reg add(reg a, reg b) { return _mm256_add_epi32(a, b); }
+    MATRIX_TARGET_AVX2 static reg sub(reg a, reg b) { return _mm256_sub_epi32(a, b); }
+    MATRIX_TARGET_AVX2 static reg mul(reg a, reg b) { return _mm256_mullo_epi32(a, b); }
+};
+
+template<> struct avx512_vec<double> {
+    using reg = __m512d;
+    static constexpr std::size_t width = 8;
+    static constexpr bool has_mul = true, has_div = true, has_fma = true;
+    MATRIX_TARGET_AVX512 static reg load(double const* p) { return _mm512_loadu_pd(p); }
+    MATRIX_TARGET_AVX512 static void store(double* p, reg v) { _mm512_storeu_pd(p, v); }
+    MATRIX_TARGET_AVX512 static reg set1(double s) { return _mm512_set1_pd(s); }
+    MATRIX_TARGET_AVX512 static reg add(reg a, reg b) { return _mm512_add_pd(a, b); }
+    MATRIX_TARGET_AVX512 static reg sub(reg a, reg b) { return _mm512_sub_pd(a, b); }
+    MATRIX_TARGET_AVX512 static reg mul(reg a, reg b) { return _mm512_mul_pd(a, b); }
+    MATRIX_TARGET_AVX512 static reg div(reg a, reg b) { return _mm512_div_pd(a, b); }
+    MATRIX_TARGET_AVX512 static reg sqrt(reg a) { return _mm512_maskz_sqrt_pd(__mmask8(-1), a); }
+    MATRIX_TARGET_AVX512 static reg rsqrt(reg a) { return _mm512_maskz_rsqrt14_pd(__mmask8(-1), a); }
+    MATRIX_TARGET_AVX512 static reg min(reg a, reg b) { return _mm512_maskz_min_pd(__mmask8(-1), a, b); }
+    MATRIX_TARGET_AVX512 static reg max(reg a, reg b) { return _mm512_maskz_max_pd(__mmask8(-1), a, b); }
+    MATRIX_TARGET_AVX512 static reg fmadd(reg a, reg b, reg c) { return _mm512_fmadd_pd(a, b, c); }
+};
+
+template<> struct avx512_vec<float> {
+    using reg = __m512;
+    static constexpr std::size_t width = 16;
+    static constexpr bool has_mul = true, has_div = true, has_fma = true;
+    MATRIX_TARGET_AVX512 static reg load(float const* p) { return _mm512_loadu_ps(p); }
+    MATRIX_TARGET_AVX512 static void store(float* p, reg v) { _mm512_storeu_ps(p, v); }
+    MATRIX_TARGET_AVX512 static reg set1(float s) { return _mm512_set1_ps(s); }
+    MATRIX_TARGET_AVX512 static reg add(reg a, reg b) { return _mm512_add_ps(a, b); }
+    MATRIX_TARGET_AVX512 static reg sub(reg a, reg b) { return _mm512_sub_ps(a, b); }
+    MATRIX_TARGET_AVX512 static reg mul(reg a, reg b) { return _mm512_mul_ps(a, b); }
+    MATRIX_TARGET_AVX512 static reg div(reg a, reg b) { return _mm512_div_ps(a, b); }
+    MATRIX_TARGET_AVX512 static reg sqrt(reg a) { return _mm512_maskz_sqrt_ps(__mmask16(-1), a); }
+    MATRIX_TARGET_AVX512 static reg rsqrt(reg a) { return _mm512_maskz_rsqrt14_ps(__mmask16(-1), a); }
+    MATRIX_TARGET_AVX512 static reg min(reg a, reg b) { return _mm512_maskz_min_ps(__mmask16(-1), a, b); }
+    MATRIX_TARGET_AVX512 static reg max(reg a, reg b) { return _mm512_maskz_max_ps(__mmask16(-1), a, b); }
+    MATRIX_TARGET_AVX512 static reg fmadd(reg a, reg b, reg c) { return _mm512_fmadd_ps(a, b, c); }
+};
+
+template<> struct avx512_vec<int> {
+    using reg = __m512i;
+    static constexpr std::size_t width = 16;
+    static constexpr bool has_mul = true, has_div = false, has_fma = false;
+    MATRIX_TARGET_AVX512 static reg load(int const* p) { return _mm512_loadu_si512(p); }
+    MATRIX_TARGET_AVX512 static void store(int* p, reg v) { _mm512_storeu_si512(p, v); }
+    MATRIX_TARGET_AVX512 static reg set1(int s) { return _mm512_set1_epi32(s); }
+    MATRIX_TARGET_AVX512 static reg add(reg a, reg b) { return _mm512_add_epi32(a, b); }
+    MATRIX_TARGET_AVX512 static reg sub(reg a, reg b) { return _mm512_sub_epi32(a, b); }
+    MATRIX_TARGET_AVX512 static reg mul(reg a, reg b) { return _mm512_mullo_epi32(a, b); }
+};
+
+// Támogatja-e V vektorosan az Op műveletet
+template<typename V, ElemOp Op>
+constexpr bool vec_supports() {
+    if constexpr (Op == ElemOp::scale) return V::has_mul;
+    else if constexpr (Op == ElemOp::div) return V::has_div;
+    else if constexpr (Op == ElemOp::axpy) return V::has_mul;
+    else return true;
+}
+
+/*
+ A vektoros ciklus törzse minden szinten azonos, csak a target attribútum
+ különbözik, ezért makróval példányosítjuk a három szintre.
+*/
+#define MATRIX_DEFINE_ELEM_LOOP(NAME, TARGET)                                   \
+    template<typename V, ElemOp Op, typename T>                                 \
+    TARGET void NAME(T* d, T const* s, T alpha, std::size_t n) {                \
+        constexpr std::size_t W = V::width;                                     \
+        typename V::reg va = V::set1(alpha);                                    \
+        (void)va;                                                               \
+        std::size_t i = 0;                                                      \
+        for (; i + W <= n; i += W) {                                            \
+            typename V::reg x = V::load(d + i);                                 \
+            if constexpr (Op == ElemOp::add) x = V::add(x, V::load(s + i));     \
+            else if constexpr (Op == ElemOp::sub) x = V::sub(x, V::load(s + i));\
+            else if constexpr (Op == ElemOp::scale) x = V::mul(x, va);          \
+            else if constexpr (Op == ElemOp::div) x = V::div(x, va);            \
+            else if constexpr (V::has_fma) x = V::fmadd(va, V::load(s + i), x); \
+            else x = V::add(x, V::mul(va, V::load(s + i)));                     \
+            V::store(d + i, x);                                                 \
+        }                                                                       \
+        elem_scalar<Op>(d, s, alpha, i, n);                                     \
+    }
+
+MATRIX_DEFINE_ELEM_LOOP(elem_loop_sse2, MATRIX_TARGET_SSE2)
+MATRIX_DEFINE_ELEM_LOOP(elem_loop_avx2, MATRIX_TARGET_AVX2)
+MATRIX_DEFINE_ELEM_LOOP(elem_loop_avx512, MATRIX_TARGET_AVX512)
+
+#undef MATRIX_DEFINE_ELEM_LOOP
+
+#endif // MATRIX_X86_DISPATCH
+
+template<typename T>
+constexpr bool simd_element_type() {
+    return std::is_same_v<T, float> || std::is_same_v<T, double> || std::is_same_v<T, int>;
+}
+
+// Futásidejű választás a szintek közül, a nem támogatott esetek skalárisan futnak
+template<ElemOp Op, typename T>
+void elementwise(T* d, T const* s, T alpha, std::size_t n) {
+#ifdef MATRIX_X86_DISPATCH
+    if constexpr (simd_element_type<T>()) {
+        switch (simd_level()) {
+        case SimdLevel::avx512:
+            if constexpr (vec_supports<avx512_vec<T>, Op>())
+                return elem_loop_avx512<avx512_vec<T>, Op>(d, s, alpha, n);
+            break;
+        case SimdLevel::avx2:
+            if constexpr (vec_supports<avx2_vec<T>, Op>())
+                return elem_loop_avx2<avx2_vec<T>, Op>(d, s, alpha, n);
+            break;
+        case SimdLevel::sse2:
+            if constexpr (vec_supports<sse2_vec<T>, Op>())
+                return elem_loop_sse2<sse2_vec<T>, Op>(d, s, alpha, n);
+            break;
+        default:
+            break;
+        }
+    }
+#endif
+    elem_scalar<Op>(d, s, alpha, 0, n);
+}
+
+template<typename T>
+void simd_add(T* d, T const* s, std::size_t n) { elementwise<ElemOp::add>(d, s, T{}, n); }
+
+template<typename T>
+void simd_sub(T* d, T const* s, std::size_t n) { elementwise<ElemOp::sub>(d, s, T{}, n); }
+
+template<typename T>
+void simd_scale(T* d, T alpha, std::size_t n) { elementwise<ElemOp::scale>(d, static_cast<T const*>(nullptr), alpha, n); }
+
+template<typename T>
+void simd_div(T* d, T alpha, std::size_t n) { elementwise<ElemOp::div>(d, static_cast<T const*>(nullptr), alpha, n); }
+
+template<typename T>
+void simd_axpy(T* d, T alpha, T const* s, std::size_t n) { elementwise<ElemOp::axpy>(d, s, alpha, n); }
+
+/*
+ Tetszőleges kódrészlet futtatása a kiválasztott utasításkészlettel
+ A flatten miatt f törzse (és az abból hívott függvények) a célzott
+ wrapperbe inline-olódnak, így a fordító ott vektorizálja a ciklusokat;
+ kézi intrinsic-ek nélküli kerneleknél (kötegek, SoA tömbök) használjuk.
+*/
+#ifdef MATRIX_X86_DISPATCH
+template<typename F>
+MATRIX_TARGET_AVX512 __attribute__((flatten)) void simd_run_avx512(F const& f) { f(); }
+
+template<typename F>
+MATRIX_TARGET_AVX2 __attribute__((flatten)) void simd_run_avx2(F const& f) { f(); }
+#endif
+
+template<typename F>
+void simd_dispatch(F const& f) {
+#ifdef MATRIX_X86_DISPATCH
+    switch (simd_level()) {
+    case SimdLevel::avx512: return simd_run_avx512(f);
+    case SimdLevel::avx2: return simd_run_avx2(f);
+    default: break;
+    }
+#endif
+    f();
+}
+
+} // namespace matrix_kernels
@@ -0,0 +1,356 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+#include "../masodik-hf/vector2.h"
+
+/*
+ Fordítási idejű méretű, kis négyzetes mátrix (2x2, 3x3, 4x4 transzformációk,
+ Jacobi-mátrixok): SmallMatrix<T, N>
+
+ A Matrix<T>-vel szemben nincs heapfoglalás és futásidejű méret: az elemek
+ std::array-ben vannak, minden művelet constexpr, a szorzás belső összegét
+ index_sequence-szel bontjuk ki, a determináns és az inverz N <= 4-re zárt
+ képlettel (aldeterminánsokkal) számolódik, nagyobb N-re Gauss-Jordan
+ eliminációval. A 2x2-es mátrixok Vector2<T>-vel (masodik-hf) szorozhatók.
+
+   constexpr SmallMatrix<double, 2> R{0, -1, 1, 0};
+   static_assert(R.determinant() == 1);
+   Vector2<double> w = R * v;
+*/
+namespace small_matrix_detail {
+
+/*
+ Szingularitási küszöb. N <= 4-re (zárt képlet) relatív: a determinánst a sorok
+ maximumnormáinak szorzatához mérjük (Hadamard-becslés), így egy jól kondicionált,
+ de kis skálájú mátrix (pl. 1e-5 * I) nem szinguláris. N > 4-re, mint az LU-ban,
+ a főelem abszolút értékére vonatkozik.
+*/
+constexpr double singular_tolerance = 1e-12;
+
+// std::abs C++17-ben nem constexpr
+template<typename T>
+constexpr T abs(T x) { return x < T{} ? -x : x; }
+
+// std::swap C++17-ben szintén nem constexpr
+template<typename T>
+constexpr void swap(T& a, T& b) {
+    T t = a;
+    a = b;
+    b = t;
+}
+
+} // namespace small_matrix_detail
+
+template<typename T, int N>
+class SmallMatrix {
+    static_assert(N >= 1, "SmallMatrix needs N >= 1");
+
+    std::array<T, N * N> data_{};  // sorfolytonos
+
+    // (A * B)(i, j) kibontva: a(i, 0) * b(0, j) + ... + a(i, N-1) * b(N-1, j)
+    template<std::size_t... K>
+    static constexpr T row_col(SmallMatrix const& a, SmallMatrix const& b, int i, int j,
+                               std::index_sequence<K...>) {
+        return ((a(i, K) * b(K, j)) + ...);
+    }
+
+    // |det| <= tol * prod_i max_j |a(i, j)| -> szinguláris (nullsor vagy NaN esetén is)
+    static constexpr void singular_check(SmallMatrix const& a, T det) {
+        T scale{1};
+        for (int i = 0; i < N; ++i) {
+            T row{};
+            for (int j = 0; j < N; ++j)
+                if (small_matrix_detail::abs(a(i, j)) > row) row = small_matrix_detail::abs(a(i, j));
+            scale *= row;
+        }
+        if (!(small_matrix_detail::abs(det) > small_matrix_detail::singular_tolerance * scale))
+            throw std::runtime_error("Matrix is singular");
+    }
+
+public:
+    using value_type = T;
+
+    // Nullmátrix
+    constexpr SmallMatrix() = default;
+
+    constexpr explicit SmallMatrix(T const& val) {
+        for (auto& x : data_) x = val;
+    }
+
+    // Sorfolytonos elemek, pl. SmallMatrix<double, 2> R{0, -1, 1, 0};
+    constexpr SmallMatrix(std::initializer_list<T> il) {
+        if (il.size() != data_.size())
+            throw std::runtime_error("Initializer list size mismatch");
+        std::size_t k = 0;
+        for (T const& x : il) data_[k++] = x;
+    }
+
+    static constexpr SmallMatrix identity() {
+        SmallMatrix id;
+        for (int i = 0; i < N; ++i) id(i, i) = T{1};
+        return id;
+    }
+
+    static constexpr int size() { return N; }
+    static constexpr int rows() { return N; }
+    static constexpr int cols() { return N; }
+
+    constexpr T& operator()(int i, int j) { return data_[i * N + j]; }
+    constexpr T const& operator()(int i, int j) const { return data_[i * N + j]; }
+
+    constexpr T* data() { return data_.data(); }
+    constexpr T const* data() const { return data_.data(); }
+
+    constexpr SmallMatrix& operator+=(SmallMatrix const& other) {
+        for (int k = 0; k < N * N; ++k) data_[k] += other.data_[k];
+        return *this;
+    }
+
+    constexpr SmallMatrix& operator-=(SmallMatrix const& other) {
+        for (int k = 0; k < N * N; ++k) data_[k] -= other.data_[k];
+        return *this;
+    }
+
+    constexpr SmallMatrix& operator*=(T const& s) {
+        for (auto& x : data_) x *= s;
+        return *this;
+    }
+
+    constexpr SmallMatrix& operator/=(T const& s) {
+        for (auto& x : data_) x /= s;
+        return *this;
+    }
+
+    constexpr SmallMatrix& operator*=(SmallMatrix const& other) {
+        return *this = *this * other;
+    }
+
+    constexpr SmallMatrix transpose() const {
+        SmallMatrix t;
+        for (int i = 0; i < N; ++i)
+            for (int j = 0; j < N; ++j)
+                t(j, i) = (*this)(i, j);
+        return t;
+    }
+
+    // N <= 4: zárt képlet, különben elimináció részleges főelemkiválasztással
+    constexpr T determinant() const {
+        auto const& a = *this;
+        if constexpr (N == 1) {
+            return a(0, 0);
+        } else if constexpr (N == 2) {
+            return a(0, 0) * a(1, 1) - a(0, 1) * a(1, 0);
+        } else if constexpr (N == 3) {
+            return a(0, 0) * (a(1, 1) * a(2, 2) - a(1, 2) * a(2, 1))
+                 - a(0, 1) * (a(1, 0) * a(2, 2) - a(1, 2) * a(2, 0))
+                 + a(0, 2) * (a(1, 0) * a(2, 1) - a(1, 1) * a(2, 0));
+        } else if constexpr (N == 4) {
+            // Az első két és az utolsó két sor 2x2-es aldeterminánsai (Laplace-kifejtés)
+            T s0 = a(0, 0) * a(1, 1) - a(1, 0) * a(0, 1);
+            T s1 = a(0, 0) * a(1, 2) - a(1, 0) * a(0, 2);
+            T s2 = a(0, 0) * a(1, 3) - a(1, 0) * a(0, 3);
+            T s3 = a(0, 1) * a(1, 2) - a(1, 1) * a(0, 2);
+            T s4 = a(0, 1) * a(1, 3) - a(1, 1) * a(0, 3);
+            T s5 = a(0, 2) * a(1, 3) - a(1, 2) * a(0, 3);
+            T c0 = a(2, 0) * a(3, 1) - a(3, 0) * a(2, 1);
+            T c1 = a(2, 0) * a(3, 2) - a(3, 0) * a(2, 2);
+            T c2 = a(2, 0) * a(3, 3) - a(3, 0) * a(2, 3);
+            T c3 = a(2, 1) * a(3, 2) - a(3, 1) * a(2, 2);
+            T c4 = a(2, 1) * a(3, 3) - a(3, 1) * a(2, 3);
+            T c5 = a(2, 2) * a(3, 3) - a(3, 2) * a(2, 3);
+            return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+        } else {
+            SmallMatrix m = a;
+            T det{1};
+            for (int k = 0; k < N; ++k) {
+                int p = k;
+                for (int i = k + 1; i < N; ++i)
+                    if (small_matrix_detail::abs(m(i, k)) > small_matrix_detail::abs(m(p, k))) p = i;
+                if (small_matrix_detail::abs(m(p, k)) < small_matrix_detail::singular_tolerance)
+                    return T{};
+                if (p != k) {
+                    for (int j = 0; j < N; ++j) small_matrix_detail::swap(m(k, j), m(p, j));
+                    det = -det;
+                }
+                det *= m(k, k);
+                for (int i = k + 1; i < N; ++i) {
+                    T l = m(i, k) / m(k, k);
+                    for (int j = k; j < N; ++j) m(i, j) -= l * m(k, j);
+                }
+            }
+            return det;
+        }
+    }
+
+    // Inverz; szinguláris mátrixra runtime_error, mint a Matrix::inv()
+    constexpr SmallMatrix inv() const {
+        auto const& a = *this;
+        if constexpr (N == 1) {
+            singular_check(a, a(0, 0));
+            return SmallMatrix{T{1} / a(0, 0)};
+        } else if constexpr (N == 2) {
+            T det = determinant();
+            singular_check(a, det);
+            return SmallMatrix{a(1, 1) / det, -a(0, 1) / det, -a(1, 0) / det, a(0, 0) / det};
+        } else if constexpr (N == 3) {
+            // Adjungált (a kofaktorok transzponáltja) / determináns
+            T c00 = a(1, 1) * a(2, 2) - a(1, 2) * a(2, 1);
+            T c01 = a(1, 2) * a(2, 0) - a(1, 0) * a(2, 2);
+            T c02 = a(1, 0) * a(2, 1) - a(1, 1) * a(2, 0);
+            T det = a(0, 0) * c00 + a(0, 1) * c01 + a(0, 2) * c02;
+            singular_check(a, det);
+            SmallMatrix r{
+                c00, a(0, 2) * a(2, 1) - a(0, 1) * a(2, 2), a(0, 1) * a(1, 2) - a(0, 2) * a(1, 1),
+                c01, a(0, 0) * a(2, 2) - a(0, 2) * a(2, 0), a(0, 2) * a(1, 0) - a(0, 0) * a(1, 2),
+                c02, a(0, 1) * a(2, 0) - a(0, 0) * a(2, 1), a(0, 0) * a(1, 1) - a(0, 1) * a(1, 0)};
+            return r /= det;
+        } else if constexpr (N == 4) {
+            // Ugyanazok a 2x2-es aldeterminánsok, mint a determinant()-ban
+            T s0 = a(0, 0) * a(1, 1) - a(1, 0) * a(0, 1);
+            T s1 = a(0, 0) * a(1, 2) - a(1, 0) * a(0, 2);
+            T s2 = a(0, 0) * a(1, 3) - a(1, 0) * a(0, 3);
+            T s3 = a(0, 1) * a(1, 2) - a(1, 1) * a(0, 2);
+            T s4 = a(0, 1) * a(1, 3) - a(1, 1) * a(0, 3);
+            T s5 = a(0, 2) * a(1, 3) - a(1, 2) * a(0, 3);
+            T c0 = a(2, 0) * a(3, 1) - a(3, 0) * a(2, 1);
+            T c1 = a(2, 0) * a(3, 2) - a(3, 0) * a(2, 2);
+            T c2 = a(2, 0) * a(3, 3) - a(3, 0) * a(2, 3);
+            T c3 = a(2, 1) * a(3, 2) - a(3, 1) * a(2, 2);
+            T c4 = a(2, 1) * a(3, 3) - a(3, 1) * a(2, 3);
+            T c5 = a(2, 2) * a(3, 3) - a(3, 2) * a(2, 3);
+            T det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+            singular_check(a, det);
+            SmallMatrix r{
+                 a(1, 1) * c5 - a(1, 2) * c4 + a(1, 3) * c3,
+                -a(0, 1) * c5 + a(0, 2) * c4 - a(0, 3) * c3,
+                 a(3, 1) * s5 - a(3, 2) * s4 + a(3, 3) * s3,
+                -a(2, 1) * s5 + a(2, 2) * s4 - a(2, 3) * s3,
+                -a(1, 0) * c5 + a(1, 2) * c2 - a(1, 3) * c1,
+                 a(0, 0) * c5 - a(0, 2) * c2 + a(0, 3) * c1,
+                -a(3, 0) * s5 + a(3, 2) * s2 - a(3, 3) * s1,
+                 a(2, 0) * s5 - a(2, 2) * s2 + a(2, 3) * s1,
+                 a(1, 0) * c4 - a(1, 1) * c2 + a(1, 3) * c0,
+                -a(0, 0) * c4 + a(0, 1) * c2 - a(0, 3) * c0,
+                 a(3, 0) * s4 - a(3, 1) * s2 + a(3, 3) * s0,
+                -a(2, 0) * s4 + a(2, 1) * s2 - a(2, 3) * s0,
+                -a(1, 0) * c3 + a(1, 1) * c1 - a(1, 2) * c0,
+                 a(0, 0) * c3 - a(0, 1) * c1 + a(0, 2) * c0,
+                -a(3, 0) * s3 + a(3, 1) * s1 - a(3, 2) * s0,
+                 a(2, 0) * s3 - a(2, 1) * s1 + a(2, 2) * s0};
+            return r /= det;
+        } else {
+            // Gauss-Jordan: [A | I] -> [I | A^-1]
+            SmallMatrix m = a, r = identity();
+            for (int k = 0; k < N; ++k) {
+                int p = k;
+                for (int i = k + 1; i < N; ++i)
+                    if (small_matrix_detail::abs(m(i, k)) > small_matrix_detail::abs(m(p, k))) p = i;
+                if (small_matrix_detail::abs(m(p, k)) < small_matrix_detail::singular_tolerance)
+                    throw std::runtime_error("Matrix is singular");
+                for (int j = 0; j < N; ++j) {
+                    small_matrix_detail::swap(m(k, j), m(p, j));
+                    small_matrix_detail::swap(r(k, j), r(p, j));
+                }
+                T d = m(k, k);
+                for (int j = 0; j < N; ++j) {
+                    m(k, j) /= d;
+                    r(k, j) /= d;
+                }
+                for (int i = 0; i < N; ++i) {
+                    if (i == k) continue;
+                    T l = m(i, k);
+                    for (int j = 0; j < N; ++j) {
+                        m(i, j) -= l * m(k, j);
+                        r(i, j) -= l * r(k, j);
+                    }
+                }
+            }
+            return r;
+        }
+    }
+
+    friend constexpr SmallMatrix operator+(SmallMatrix a, SmallMatrix const& b) { return a += b; }
+    friend constexpr SmallMatrix operator-(SmallMatrix a, SmallMatrix const& b) { return a -= b; }
+    friend constexpr SmallMatrix operator*(SmallMatrix a, T const& s) { return a *= s; }
+    friend constexpr SmallMatrix operator*(T const& s, SmallMatrix a) { return a *= s; }
+    friend constexpr SmallMatrix operator/(SmallMatrix a, T const& s) { return a /= s; }
+
+    friend constexpr SmallMatrix operator-(SmallMatrix a) {
+        for (auto& x : a.data_) x = -x;
+        return a;
+    }
+
+    friend constexpr SmallMatrix operator*(SmallMatrix const& a, SmallMatrix const& b) {
+        SmallMatrix c;
+        for (int i = 0; i < N; ++i)
+            for (int j = 0; j < N; ++j)
+                c(i, j) = row_col(a, b, i, j, std::make_index_sequence<N>{});
+        return c;
+    }
+
+    friend constexpr bool operator==(SmallMatrix const& a, SmallMatrix const& b) {
+        for (int k = 0; k < N * N; ++k)
+            if (!(a.data_[k] == b.data_[k])) return false;
+        return true;
+    }
+
+    friend constexpr bool operator!=(SmallMatrix const& a, SmallMatrix const& b) { return !(a == b); }
+
+    friend std::ostream& operator<<(std::ostream& os, SmallMatrix const& m) {
+        for (int i = 0; i < N; ++i) {
+            os << "|";
+            for (int j = 0; j < N; ++j) {
+                os << m(i, j);
+                if (j != N - 1) os << " ";
+            }
+            os << "|\n";
+        }
+        return os;
+    }
+};
+
+template<typename T>
+using SmallMatrix2 = SmallMatrix<T, 2>;
+template<typename T>
+using SmallMatrix3 = SmallMatrix<T, 3>;
+template<typename T>
+using SmallMatrix4 = SmallMatrix<T, 4>;
+
+/*
+ Együttműködés a Vector2<T>-vel (2x2-es mátrixok)
+*/
+
+// Mátrix * oszlopvektor
+template<typename T>
+constexpr Vector2<T> operator*(SmallMatrix<T, 2> const& m, Vector2<T> const& v) {
+    return Vector2<T>(m(0, 0) * v.x + m(0, 1) * v.y, m(1, 0) * v.x + m(1, 1) * v.y);
+}
+
+// Sorvektor * mátrix
+template<typename T>
+constexpr Vector2<T> operator*(Vector2<T> const& v, SmallMatrix<T, 2> const& m) {
+    return Vector2<T>(v.x * m(0, 0) + v.y * m(1, 0), v.x * m(0, 1) + v.y * m(1, 1));
+}
+
+// Diadikus szorzat mátrixként (a tensor_product csak kiírja)
+template<typename T>
+constexpr SmallMatrix<T, 2> outer(Vector2<T> const& a, Vector2<T> const& b) {
+    return SmallMatrix<T, 2>{a.x * b.x, a.x * b.y, a.y * b.x, a.y * b.y};
+}
+
+// Mátrix két oszlopvektorból, illetve egy oszlop vektorként
+template<typename T>
+constexpr SmallMatrix<T, 2> from_columns(Vector2<T> const& c0, Vector2<T> const& c1) {
+    return SmallMatrix<T, 2>{c0.x, c1.x, c0.y, c1.y};
+}
+
+template<typename T>
+constexpr Vector2<T> column(SmallMatrix<T, 2> const& m, int j) {
+    return Vector2<T>(m(0, j), m(1, j));
+}
@@ -0,0 +1,372 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "matrix.h"
+
+/*
+ Ritka mátrix tömörített sor- (CSR) vagy oszlopfolytonos (CSC) tárolással
+
+ Csak a nemnulla elemeket tároljuk: CSR-nél soronként az oszlopindexeket
+ és az értékeket egymás után, ptr[i] .. ptr[i + 1] az i. sor helye; CSC
+ ugyanez oszloponként (sorindexekkel). A memória és a műveletek ideje így
+ a nemnullák számával (nnz) arányos, nem n^2-tel.
+
+   std::vector<Triplet<double>> t = {{0, 0, 4.0}, {0, 1, -1.0}, {1, 1, 4.0}};
+   SparseMatrix<double> A(2, 2, t);               // CSR, az ismétlődők összeadódnak
+   std::vector<double> y = A * x;                 // SpMV
+   std::vector<double> z = A.transpose_multiply(x);
+   Matrix<double> C = A * B;                      // ritka * sűrű
+   SparseMatrix<double> Ac = A.to_csc();
+   Matrix<double> D = A.to_dense();
+
+ A kernelek a globális szálkészleten futnak: az "összegyűjtő" irányt
+ (CSR * x, CSC^T * x) a nemnullák szerint egyenlő darabokra bontjuk, így
+ egy sűrű sor sem terheli túl az egyik szálat; a "szétszóró" irányt
+ (CSC * x, CSR^T * x) szálanként külön gyűjtővektorba számoljuk, majd
+ összeadjuk. Az összegyűjtő irány eredménye a szálszámtól független, a
+ szétszórónál az összegzés sorrendje, így az utolsó bitek is, függhetnek
+ tőle.
+*/
+
+enum class SparseFormat { csr, csc };
+
+template<typename T>
+struct Triplet {
+    int row, col;
+    T value;
+};
+
+namespace matrix_kernels {
+
+// Ennyi nemnulla alatt mindent sorosan számolunk
+constexpr std::size_t sparse_parallel_nnz = 1 << 15;
+
+// A [0, outer) tartomány parts darabra osztva úgy, hogy mindegyikre ~ egyenlő nnz jusson
+inline int balanced_split(std::size_t const* ptr, int outer, int parts, int p) {
+    if (p <= 0) return 0;
+    if (p >= parts) return outer;
+    std::size_t target = ptr[outer] / static_cast<std::size_t>(parts) * p +
+                         ptr[outer] % static_cast<std::size_t>(parts) * p / parts;
+    return static_cast<int>(std::upper_bound(ptr, ptr + outer + 1, target) - ptr) - 1;
+}
+
+inline int sparse_parts(std::size_t nnz) {
+    if (nnz < sparse_parallel_nnz) return 1;
+    return static_cast<int>(std::min<std::size_t>(4 * get_num_threads(), nnz / sparse_parallel_nnz + 1));
+}
+
+// y[o] = sum a[o][k] * x[idx[k]], o < outer (CSR * x, CSC^T * x)
+template<typename T>
+void sparse_gather(int outer, std::size_t const* ptr, int const* idx, T const* val, T const* x, T* y) {
+    int parts = sparse_parts(ptr[outer]);
+    auto run = [&](int p0, int p1) {
+        int o1 = balanced_split(ptr, outer, parts, p1);
+        for (int o = balanced_split(ptr, outer, parts, p0); o < o1; ++o) {
+            T s{};
+            for (std::size_t k = ptr[o]; k < ptr[o + 1]; ++k) s += val[k] * x[idx[k]];
+            y[o] = s;
+        }
+    };
+    if (parts > 1)
+        parallel_for(0, parts, 1, run);
+    else
+        run(0, 1);
+}
+
+// y[idx[k]] += a[o][k] * x[o], y: inner hosszú, előtte nullázva (CSC * x, CSR^T * x)
+template<typename T>
+void sparse_scatter(int outer, int inner, std::size_t const* ptr, int const* idx, T const* val, T const* x, T* y) {
+    // Darabonként egy inner hosszú gyűjtő: legfeljebb szálanként egy
+    int parts = std::min<int>(sparse_parts(ptr[outer]), static_cast<int>(get_num_threads()));
+    auto scatter = [&](int o0, int o1, T* out) {
+        for (int o = o0; o < o1; ++o) {
+            T xo = x[o];
+            for (std::size_t k = ptr[o]; k < ptr[o + 1]; ++k) out[idx[k]] += val[k] * xo;
+        }
+    };
+    std::fill(y, y + inner, T{});
+    if (parts <= 1) {
+        scatter(0, outer, y);
+        return;
+    }
+    // Darabonként saját gyűjtő, majd oszlopdarabonként (párhuzamosan) összeadva, rögzített sorrendben
+    std::vector<std::vector<T>> partial(parts);
+    parallel_for(0, parts, 1, [&](int p0, int p1) {
+        for (int p = p0; p < p1; ++p) {
+            partial[p].assign(inner, T{});
+            scatter(balanced_split(ptr, outer, parts, p), balanced_split(ptr, outer, parts, p + 1), partial[p].data());
+        }
+    });
+    parallel_for(0, inner, 1 << 12, [&](int i0, int i1) {
+        for (auto const& part : partial)
+            for (int i = i0; i < i1; ++i) y[i] += part[i];
+    });
+}
+
+} // namespace matrix_kernels
+
+template<typename T>
+class SparseMatrix {
+    int rows_ = 0, cols_ = 0;
+    SparseFormat format_ = SparseFormat::csr;
+    std::vector<std::size_t> ptr_;  // outer() + 1 elem
+    std::vector<int> idx_;          // CSR: oszlopindexek, CSC: sorindexek
+    std::vector<T> val_;
+
+    int outer() const { return format_ == SparseFormat::csr ? rows_ : cols_; }
+    int inner() const { return format_ == SparseFormat::csr ? cols_ : rows_; }
+
+    static void check_dims(int rows, int cols) {
+        if (rows < 0 || cols < 0) throw std::invalid_argument("Negative sparse matrix dimension");
+    }
+
+    // Ugyanaz a tárolás a másik formátumban (számláló rendezés, O(nnz + n))
+    SparseMatrix converted() const {
+        SparseMatrix r(rows_, cols_, format_ == SparseFormat::csr ? SparseFormat::csc : SparseFormat::csr);
+        int out_n = inner();
+        r.ptr_.assign(out_n + 1, 0);
+        for (int i : idx_) ++r.ptr_[i + 1];
+        for (int i = 0; i < out_n; ++i) r.ptr_[i + 1] += r.ptr_[i];
+        r.idx_.resize(idx_.size());
+        r.val_.resize(val_.size());
+        std::vector<std::size_t> next(r.ptr_.begin(), r.ptr_.end() - 1);
+        for (int o = 0; o < outer(); ++o)
+            for (std::size_t k = ptr_[o]; k < ptr_[o + 1]; ++k) {
+                std::size_t d = next[idx_[k]]++;
+                r.idx_[d] = o;
+                r.val_[d] = val_[k];
+            }
+        return r;
+    }
+
+public:
+    using value_type = T;
+
+    // Üres (csupa nulla) rows x cols mátrix
+    SparseMatrix(int rows, int cols, SparseFormat format = SparseFormat::csr)
+        : rows_(rows), cols_(cols), format_(format) {
+        check_dims(rows, cols);
+        ptr_.assign(outer() + 1, 0);
+    }
+
+    /*
+     Hármasokból (sor, oszlop, érték) tetszőleges sorrendben; az azonos
+     helyű elemek a megadás sorrendjében összeadódnak, a vonalon belül
+     az indexek növekvők
+    */
+    SparseMatrix(int rows, int cols, std::vector<Triplet<T>> const& triplets,
+                 SparseFormat format = SparseFormat::csr)
+        : SparseMatrix(rows, cols, format) {
+        bool csr = format == SparseFormat::csr;
+        for (Triplet<T> const& t : triplets) {
+            if (t.row < 0 || t.row >= rows || t.col < 0 || t.col >= cols)
+                throw std::out_of_range("Sparse matrix entry out of range");
+            ++ptr_[(csr ? t.row : t.col) + 1];
+        }
+        for (int o = 0; o < outer(); ++o) ptr_[o + 1] += ptr_[o];
+        std::vector<std::size_t> next(ptr_.begin(), ptr_.end() - 1);
+        std::vector<int> idx(triplets.size());
+        std::vector<T> val(triplets.size());
+        for (Triplet<T> const& t : triplets) {
+            std::size_t d = next[csr ? t.row : t.col]++;
+            idx[d] = csr ? t.col : t.row;
+            val[d] = t.value;
+        }
+        // Vonalanként rendezés és az ismétlődők összevonása
+        idx_.reserve(idx.size());
+        val_.reserve(val.size());
+        std::vector<std::pair<int, T>> line;
+        std::size_t begin = 0;
+        for (int o = 0; o < outer(); ++o) {
+            std::size_t end = ptr_[o + 1];
+            line.clear();
+            for (std::size_t k = begin; k < end; ++k) line.emplace_back(idx[k], val[k]);
+            std::stable_sort(line.begin(), line.end(), [](auto const& a, auto const& b) { return a.first < b.first; });
+            for (auto const& e : line) {
+                if (idx_.size() > ptr_[o] && idx_.back() == e.first)
+                    val_.back() += e.second;
+                else {
+                    idx_.push_back(e.first);
+                    val_.push_back(e.second);
+                }
+            }
+            begin = end;
+            ptr_[o + 1] = idx_.size();
+        }
+    }
+
+    // Sűrű mátrixból: a drop_tol-nál nagyobb abszolút értékű elemek maradnak meg
+    explicit SparseMatrix(Matrix<T> const& dense, SparseFormat format = SparseFormat::csr, T drop_tol = T{})
+        : SparseMatrix(dense.rows(), dense.cols(), format) {
+        bool csr = format == SparseFormat::csr;
+        for (int o = 0; o < outer(); ++o) {
+            for (int i = 0; i < inner(); ++i) {
+                T v = csr ? dense(o, i) : dense(i, o);
+                if (std::abs(v) > drop_tol) {
+                    idx_.push_back(i);
+                    val_.push_back(v);
+                }
+            }
+            ptr_[o + 1] = idx_.size();
+        }
+    }
+
+    int rows() const { return rows_; }
+    int cols() const { return cols_; }
+    SparseFormat format() const { return format_; }
+    std::size_t nnz() const { return val_.size(); }
+
+    // A tárolás nyers tömbjei (pl. előkondicionálókhoz, C felülethez)
+    std::vector<std::size_t> const& outer_ptr() const { return ptr_; }
+    std::vector<int> const& inner_indices() const { return idx_; }
+    std::vector<T> const& values() const { return val_; }
+    std::vector<T>& values() { return val_; }
+
+    // Foglalt memória bájtban (a sűrű tárolás rows * cols * sizeof(T))
+    std::size_t memory_bytes() const {
+        return ptr_.size() * sizeof(std::size_t) + idx_.size() * sizeof(int) + val_.size() * sizeof(T);
+    }
+
+    // (i, j) eleme, bináris kereséssel a vonalán belül (nem tárolt elemre 0)
+    T operator()(int i, int j) const {
+        if (i < 0 || i >= rows_ || j < 0 || j >= cols_)
+            throw std::out_of_range("Sparse matrix index out of range");
+        int o = format_ == SparseFormat::csr ? i : j, in = format_ == SparseFormat::csr ? j : i;
+        auto first = idx_.begin() + ptr_[o], last = idx_.begin() + ptr_[o + 1];
+        auto it = std::lower_bound(first, last, in);
+        return it != last && *it == in ? val_[it - idx_.begin()] : T{};
+    }
+
+    SparseMatrix to_csr() const { return format_ == SparseFormat::csr ? *this : converted(); }
+    SparseMatrix to_csc() const { return format_ == SparseFormat::csc ? *this : converted(); }
+
+    // Transzponált: a CSR tömbök épp A^T CSC-alakja, így csak a méretek és a formátum cserélődnek
+    SparseMatrix transpose() const {
+        SparseMatrix t = *this;
+        std::swap(t.rows_, t.cols_);
+        t.format_ = format_ == SparseFormat::csr ? SparseFormat::csc : SparseFormat::csr;
+        return t;
+    }
+
+    Matrix<T> to_dense() const {
+        Matrix<T> d(rows_, cols_, T{});
+        for (int o = 0; o < outer(); ++o)
+            for (std::size_t k = ptr_[o]; k < ptr_[o + 1]; ++k) {
+                if (format_ == SparseFormat::csr)
+                    d(o, idx_[k]) += val_[k];
+                else
+                    d(idx_[k], o) += val_[k];
+            }
+        return d;
+    }
+
+    // y = A * x (SpMV), x és y a hívó pufferei
+    void multiply(T const* x, T* y) const {
+        if (format_ == SparseFormat::csr)
+            matrix_kernels::sparse_gather(rows_, ptr_.data(), idx_.data(), val_.data(), x, y);
+        else
+            matrix_kernels::sparse_scatter(cols_, rows_, ptr_.data(), idx_.data(), val_.data(), x, y);
+    }
+
+    // y = A^T * x, a transzponált előállítása nélkül
+    void transpose_multiply(T const* x, T* y) const {
+        if (format_ == SparseFormat::csc)
+            matrix_kernels::sparse_gather(cols_, ptr_.data(), idx_.data(), val_.data(), x, y);
+        else
+            matrix_kernels::sparse_scatter(rows_, cols_, ptr_.data(), idx_.data(), val_.data(), x, y);
+    }
+
+    std::vector<T> transpose_multiply(std::vector<T> const& x) const {
+        if (static_cast<int>(x.size()) != rows_)
+            throw MatrixSizeMismatch();
+        std::vector<T> y(cols_);
+        transpose_multiply(x.data(), y.data());
+        return y;
+    }
+
+    friend std::vector<T> operator*(SparseMatrix const& a, std::vector<T> const& x) {
+        if (static_cast<int>(x.size()) != a.cols_)
+            throw MatrixSizeMismatch();
+        std::vector<T> y(a.rows_);
+        a.multiply(x.data(), y.data());
+        return y;
+    }
+
+    /*
+     Ritka * sűrű: CSR-nél C minden sora A sorának nemnulláival súlyozott
+     B-sorok összege (soronként axpy, a nemnullák szerint szétosztva);
+     CSC-nél C oszlopsávjait osztjuk szét, így sem kell írási ütközéstől tartani
+    */
+    friend Matrix<T> operator*(SparseMatrix const& a, Matrix<T> const& b) {
+        check_same_size(a.cols_, b.rows());
+        int n = b.cols();
+        Matrix<T> c(a.rows_, n, T{});
+        std::size_t const* ptr = a.ptr_.data();
+        if (a.format_ == SparseFormat::csr) {
+            int parts = matrix_kernels::sparse_parts(a.nnz() * static_cast<std::size_t>(n));
+            auto run = [&](int p0, int p1) {
+                int r0 = matrix_kernels::balanced_split(ptr, a.rows_, parts, p0);
+                int r1 = matrix_kernels::balanced_split(ptr, a.rows_, parts, p1);
+                for (int i = r0; i < r1; ++i)
+                    for (std::size_t k = ptr[i]; k < ptr[i + 1]; ++k)
+                        matrix_kernels::simd_axpy(c.data() + static_cast<std::size_t>(i) * n, a.val_[k],
+                                                  b.data() + static_cast<std::size_t>(a.idx_[k]) * n,
+                                                  static_cast<std::size_t>(n));
+            };
+            if (parts > 1)
+                parallel_for(0, parts, 1, run);
+            else
+                run(0, 1);
+        } else {
+            std::size_t work = std::max<std::size_t>(1, a.nnz());
+            int grain = static_cast<int>(std::max<std::size_t>(1, matrix_kernels::sparse_parallel_nnz / work));
+            parallel_for(0, n, grain, [&](int j0, int j1) {
+                for (int p = 0; p < a.cols_; ++p) {
+                    T const* bp = b.data() + static_cast<std::size_t>(p) * n;
+                    for (std::size_t k = ptr[p]; k < ptr[p + 1]; ++k) {
+                        T* ci = c.data() + static_cast<std::size_t>(a.idx_[k]) * n;
+                        T v = a.val_[k];
+                        for (int j = j0; j < j1; ++j) ci[j] += v * bp[j];
+                    }
+                }
+            });
+        }
+        return c;
+    }
+
+    // Sűrű * ritka: C sorai B soraiból, párhuzamosan soronként
+    friend Matrix<T> operator*(Matrix<T> const& b, SparseMatrix const& a) {
+        check_same_size(b.cols(), a.rows_);
+        int m = b.rows(), n = a.cols_;
+        Matrix<T> c(m, n, T{});
+        std::size_t const* ptr = a.ptr_.data();
+        std::size_t work = std::max<std::size_t>(1, a.nnz());
+        int grain = static_cast<int>(std::max<std::size_t>(1, matrix_kernels::sparse_parallel_nnz / work));
+        parallel_for(0, m, grain, [&](int r0, int r1) {
+            for (int r = r0; r < r1; ++r) {
+                T const* br = b.data() + static_cast<std::size_t>(r) * b.cols();
+                T* cr = c.data() + static_cast<std::size_t>(r) * n;
+                if (a.format_ == SparseFormat::csr) {
+                    for (int p = 0; p < a.rows_; ++p) {
+                        T bp = br[p];
+                        if (bp == T{}) continue;
+                        for (std::size_t k = ptr[p]; k < ptr[p + 1]; ++k) cr[a.idx_[k]] += bp * a.val_[k];
+                    }
+                } else {
+                    for (int j = 0; j < n; ++j) {
+                        T s{};
+                        for (std::size_t k = ptr[j]; k < ptr[j + 1]; ++k) s += br[a.idx_[k]] * a.val_[k];
+                        cr[j] = s;
+                    }
+                }
+            }
+        });
+        return c;
+    }
+};
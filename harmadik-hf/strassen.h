@@ -0,0 +1,215 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "gemm.h"
+#include "pool_allocator.h"
+#include "thread_pool.h"
+
+/*
+ Strassen–Winograd-szorzás nagy mátrixokra: C = A * B, A: m x k, B: k x n
+
+ Minden szinten a 2 x 2-es blokkfelbontásból 8 helyett 7 félméretű
+ szorzat és 15 összeadás; a félméretű szorzatokra rekurzívan ugyanez,
+ amíg valamelyik méret a levágási határ (cutoff) kétszerese alá nem
+ esik, ott a klasszikus, csomagolt GEMM (gemm.h) számol. L szinttel a
+ műveletszám (7/8)^L-szerese a klasszikusnak.
+
+ Páratlan méretnél a páros részen fut a rekurzió, a maradék sort,
+ oszlopot és (páratlan k-nál) az utolsó rang-1 tagot a GEMM adja hozzá
+ (dinamikus lehántás), így nincs kitöltés nullákkal.
+
+ Munkaterület: szintenként egy A-, egy B- és egy C-negyednyi puffer;
+ ezek összmérete előre kiszámolható (~(mk + kn + mn) / 3), ezért egyetlen
+ foglalással, a szinteken veremszerűen továbbadva dolgozunk.
+
+ Pontosság: a hiba normában korlátos, de elemenként nagyobb lehet, mint
+ a klasszikus szorzásnál (szintenként kb. 3-4-szeres szorzó a kerekítési
+ hibában), ezért csak kérésre fut: set_multiply_algorithm(MultiplyAlgorithm::strassen)
+ után a Matrix szorzása float/double-ra és elég nagy méretekre ezt
+ használja; az eltérés a klasszikustól strassen_error()-ral mérhető (matrix.h).
+*/
+
+enum class MultiplyAlgorithm { classical, strassen };
+
+inline MultiplyAlgorithm& multiply_algorithm_slot() {
+    static MultiplyAlgorithm algorithm = MultiplyAlgorithm::classical;
+    return algorithm;
+}
+
+// A Matrix szorzásának algoritmusa (alapból klasszikus)
+inline MultiplyAlgorithm multiply_algorithm() { return multiply_algorithm_slot(); }
+
+inline void set_multiply_algorithm(MultiplyAlgorithm algorithm) { multiply_algorithm_slot() = algorithm; }
+
+inline int& strassen_cutoff_slot() {
+    // Mérés alapján (MatrixBench, bench_strassen): egy szálon 256 és 512 a zajon belül
+    // egyforma; 512-nél a levél-GEMM több szálat tud etetni, és eggyel kevesebb a szint
+    static int cutoff = 512;
+    return cutoff;
+}
+
+// Legkisebb blokkméret, amit még a klasszikus kernel kap
+inline int strassen_cutoff() { return strassen_cutoff_slot(); }
+
+inline void set_strassen_cutoff(int cutoff) {
+    if (cutoff < 16) throw std::invalid_argument("Strassen cutoff must be at least 16");
+    strassen_cutoff_slot() = cutoff;
+}
+
+namespace matrix_kernels {
+
+// Hány Strassen-szint fut az adott méretekre
+inline int strassen_levels(int m, int n, int k, int cutoff) {
+    int levels = 0;
+    while (std::min({m, n, k}) >= 2 * cutoff) {
+        m /= 2;
+        n /= 2;
+        k /= 2;
+        ++levels;
+    }
+    return levels;
+}
+
+// Munkaterület elemszáma: szintenként (m/2 x k/2) + (k/2 x n/2) + (m/2 x n/2)
+inline std::size_t strassen_workspace(int m, int n, int k, int cutoff) {
+    std::size_t total = 0;
+    while (std::min({m, n, k}) >= 2 * cutoff) {
+        m /= 2;
+        n /= 2;
+        k /= 2;
+        total += static_cast<std::size_t>(m) * k + static_cast<std::size_t>(k) * n + static_cast<std::size_t>(m) * n;
+    }
+    return total;
+}
+
+// Bekapcsolt Strassen-mód mellett a Matrix-szorzás ezt az utat választja-e
+template<typename T>
+bool use_strassen(int m, int n, int k) {
+    return gemm_is_packed<T>() && multiply_algorithm() == MultiplyAlgorithm::strassen &&
+           strassen_levels(m, n, k, strassen_cutoff()) > 0;
+}
+
+namespace detail {
+
+// z = x + sign * y (rows x cols, tetszőleges lépésekkel; z lehet x vagy y is), soronként párhuzamosan
+template<typename T>
+void strassen_combine(int rows, int cols, T const* x, int rs_x, int cs_x, T sign,
+                      T const* y, int rs_y, int cs_y, T* z, int rs_z, int cs_z) {
+    parallel_for(0, rows, std::max(1, (1 << 15) / std::max(1, cols)), [&](int i0, int i1) {
+        for (int i = i0; i < i1; ++i) {
+            T const* xi = x + static_cast<std::ptrdiff_t>(i) * rs_x;
+            T const* yi = y + static_cast<std::ptrdiff_t>(i) * rs_y;
+            T* zi = z + static_cast<std::ptrdiff_t>(i) * rs_z;
+            if (cs_x == 1 && cs_y == 1 && cs_z == 1) {
+                for (int j = 0; j < cols; ++j) zi[j] = xi[j] + sign * yi[j];
+            } else {
+                for (int j = 0; j < cols; ++j) zi[j * cs_z] = xi[j * cs_x] + sign * yi[j * cs_y];
+            }
+        }
+    });
+}
+
+template<typename T>
+void strassen_zero(int rows, int cols, T* c, int rs_c, int cs_c) {
+    for (int i = 0; i < rows; ++i)
+        for (int j = 0; j < cols; ++j) c[static_cast<std::ptrdiff_t>(i) * rs_c + j * cs_c] = T{};
+}
+
+template<typename T>
+void strassen_recurse(int m, int n, int k, T const* a, int rs_a, int cs_a, T const* b, int rs_b, int cs_b,
+                      T* c, int rs_c, int cs_c, int cutoff, T* ws) {
+    if (std::min({m, n, k}) < 2 * cutoff) {
+        strassen_zero(m, n, c, rs_c, cs_c);
+        gemm(m, n, k, T{1}, a, rs_a, cs_a, b, rs_b, cs_b, c, rs_c, cs_c);
+        return;
+    }
+    int m2 = m / 2, n2 = n / 2, k2 = k / 2;
+    auto qa = [&](int i, int j) { return a + static_cast<std::ptrdiff_t>(i) * m2 * rs_a + static_cast<std::ptrdiff_t>(j) * k2 * cs_a; };
+    auto qb = [&](int i, int j) { return b + static_cast<std::ptrdiff_t>(i) * k2 * rs_b + static_cast<std::ptrdiff_t>(j) * n2 * cs_b; };
+    auto qc = [&](int i, int j) { return c + static_cast<std::ptrdiff_t>(i) * m2 * rs_c + static_cast<std::ptrdiff_t>(j) * n2 * cs_c; };
+    T* x = ws;                                      // m2 x k2
+    T* y = x + static_cast<std::size_t>(m2) * k2;  // k2 x n2
+    T* z = y + static_cast<std::size_t>(k2) * n2;  // m2 x n2
+    T* next = z + static_cast<std::size_t>(m2) * n2;
+
+    // Rövidítések: A- és B-negyed összege X-be / Y-ba, C-negyedek összege, félméretű szorzat
+    auto a_comb = [&](T const* p, int rs_p, int cs_p, T sign, T const* q, int rs_q, int cs_q) {
+        strassen_combine(m2, k2, p, rs_p, cs_p, sign, q, rs_q, cs_q, x, k2, 1);
+    };
+    auto b_comb = [&](T const* p, int rs_p, int cs_p, T sign, T const* q, int rs_q, int cs_q) {
+        strassen_combine(k2, n2, p, rs_p, cs_p, sign, q, rs_q, cs_q, y, n2, 1);
+    };
+    auto c_add = [&](T* dst, T sign, T const* src, int rs_src, int cs_src) {
+        strassen_combine(m2, n2, dst, rs_c, cs_c, sign, src, rs_src, cs_src, dst, rs_c, cs_c);
+    };
+    auto mul = [&](T const* p, int rs_p, int cs_p, T const* q, int rs_q, int cs_q, T* r, int rs_r, int cs_r) {
+        strassen_recurse(m2, n2, k2, p, rs_p, cs_p, q, rs_q, cs_q, r, rs_r, cs_r, cutoff, next);
+    };
+
+    // Winograd-változat (7 szorzás, 15 összeadás), a negyedeket a C-ben tárolva:
+    //   P7 = (A11 - A21)(B22 - B12)  P5 = (A21 + A22)(B12 - B11)  P6 = (S1 - A11)(B22 - T1)
+    //   P3 = (A12 - S2) B22  P1 = A11 B11  P4 = A22 (T2 - B21)  P2 = A12 B21
+    a_comb(qa(0, 0), rs_a, cs_a, T{-1}, qa(1, 0), rs_a, cs_a);
+    b_comb(qb(1, 1), rs_b, cs_b, T{-1}, qb(0, 1), rs_b, cs_b);
+    mul(x, k2, 1, y, n2, 1, qc(1, 0), rs_c, cs_c);                 // C21 = P7
+    a_comb(qa(1, 0), rs_a, cs_a, T{1}, qa(1, 1), rs_a, cs_a);       // X = S1
+    b_comb(qb(0, 1), rs_b, cs_b, T{-1}, qb(0, 0), rs_b, cs_b);      // Y = T1
+    mul(x, k2, 1, y, n2, 1, qc(1, 1), rs_c, cs_c);                 // C22 = P5
+    a_comb(x, k2, 1, T{-1}, qa(0, 0), rs_a, cs_a);                  // X = S2 = S1 - A11
+    b_comb(qb(1, 1), rs_b, cs_b, T{-1}, y, n2, 1);                  // Y = T2 = B22 - T1
+    mul(x, k2, 1, y, n2, 1, qc(0, 1), rs_c, cs_c);                 // C12 = P6
+    a_comb(qa(0, 1), rs_a, cs_a, T{-1}, x, k2, 1);                  // X = S4 = A12 - S2
+    mul(x, k2, 1, qb(1, 1), rs_b, cs_b, qc(0, 0), rs_c, cs_c);     // C11 = P3
+    mul(qa(0, 0), rs_a, cs_a, qb(0, 0), rs_b, cs_b, z, n2, 1);     // Z = P1
+    c_add(qc(0, 1), T{1}, z, n2, 1);                                // C12 = U2 = P1 + P6
+    c_add(qc(1, 0), T{1}, qc(0, 1), rs_c, cs_c);                    // C21 = U3 = U2 + P7
+    c_add(qc(0, 1), T{1}, qc(1, 1), rs_c, cs_c);                    // C12 = U4 = U2 + P5
+    c_add(qc(1, 1), T{1}, qc(1, 0), rs_c, cs_c);                    // C22 = U7 = U3 + P5 (kész)
+    c_add(qc(0, 1), T{1}, qc(0, 0), rs_c, cs_c);                    // C12 = U5 = U4 + P3 (kész)
+    b_comb(y, n2, 1, T{-1}, qb(1, 0), rs_b, cs_b);                  // Y = T4 = T2 - B21
+    mul(qa(1, 1), rs_a, cs_a, y, n2, 1, qc(0, 0), rs_c, cs_c);     // C11 = P4
+    c_add(qc(1, 0), T{-1}, qc(0, 0), rs_c, cs_c);                   // C21 = U6 = U3 - P4 (kész)
+    mul(qa(0, 1), rs_a, cs_a, qb(1, 0), rs_b, cs_b, qc(0, 0), rs_c, cs_c);  // C11 = P2
+    c_add(qc(0, 0), T{1}, z, n2, 1);                                // C11 = U1 = P1 + P2 (kész)
+
+    // Lehántás: páratlan k-nál az utolsó rang-1 tag, páratlan n / m-nél az utolsó oszlop / sor
+    int me = 2 * m2, ne = 2 * n2;
+    if (k & 1)
+        gemm(me, ne, 1, T{1}, a + static_cast<std::ptrdiff_t>(k - 1) * cs_a, rs_a, cs_a,
+             b + static_cast<std::ptrdiff_t>(k - 1) * rs_b, rs_b, cs_b, c, rs_c, cs_c);
+    if (n & 1) {
+        T* c_col = c + static_cast<std::ptrdiff_t>(n - 1) * cs_c;
+        strassen_zero(m, 1, c_col, rs_c, cs_c);
+        gemm(m, 1, k, T{1}, a, rs_a, cs_a, b + static_cast<std::ptrdiff_t>(n - 1) * cs_b, rs_b, cs_b, c_col, rs_c, cs_c);
+    }
+    if (m & 1) {
+        T* c_row = c + static_cast<std::ptrdiff_t>(m - 1) * rs_c;
+        strassen_zero(1, ne, c_row, rs_c, cs_c);
+        gemm(1, ne, k, T{1}, a + static_cast<std::ptrdiff_t>(m - 1) * rs_a, rs_a, cs_a, b, rs_b, cs_b, c_row, rs_c, cs_c);
+    }
+}
+
+} // namespace detail
+
+/*
+ C = A * B Strassen–Winograd-rekurzióval (C korábbi tartalma elvész)
+ A lépések a gemm()-éhez hasonlóan sor- és oszloplépések; C nem fedheti
+ át A-t és B-t. cutoff alatti blokkokon a klasszikus kernel számol.
+*/
+template<typename T>
+void strassen_gemm(int m, int n, int k, T const* a, int rs_a, int cs_a, T const* b, int rs_b, int cs_b,
+                   T* c, int rs_c, int cs_c, int cutoff) {
+    if (m <= 0 || n <= 0) return;
+    if (k <= 0) {
+        detail::strassen_zero(m, n, c, rs_c, cs_c);
+        return;
+    }
+    std::vector<T, PoolAllocator<T>> ws(strassen_workspace(m, n, k, cutoff));
+    detail::strassen_recurse(m, n, k, a, rs_a, cs_a, b, rs_b, cs_b, c, rs_c, cs_c, cutoff, ws.data());
+}
+
+} // namespace matrix_kernels
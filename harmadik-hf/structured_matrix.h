@@ -0,0 +1,702 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "matrix.h"
+
+/*
+ Szerkezetes mátrixok tömör tárolással
+
+   PackedSymmetricMatrix  szimmetrikus, csak az alsó háromszög, soronként
+                          egymás után: n(n+1)/2 elem (~fele a sűrűnek)
+   TriangularMatrix       alsó vagy felső háromszög ugyanígy, háromszögű
+                          megoldóval (előre / vissza helyettesítés)
+   BandMatrix             kl alsó és ku felső mellékátlós sávmátrix a LAPACK
+                          sávos elrendezésében: (kl + ku + 1) * n elem
+   BandLU                 részleges főelemkiválasztású LU a sávon belül
+                          (dgbtrf), O(n * kl * (kl + ku)) lépés az O(n^3) helyett
+   TridiagonalMatrix      három átló, Thomas-algoritmus, O(n)
+
+   TridiagonalMatrix<double> T(n);  T.lower()[i] = ...;  auto x = T.solve(b);
+   BandMatrix<double> B(A, 2, 3);   auto y = B * x;      auto z = BandLU<double>(B).solve(b);
+   TriangularMatrix<double> L(A, Triangle::lower);        auto w = L.solve(b);
+
+ A sűrű Matrix-szal azonos a felület: (i, j) olvasás (a nem tárolt helyen
+ 0), at(i, j) írásra (a nem tárolt helyre kivételt dob), to_dense(),
+ mátrix * vektor és mátrix * Matrix. A szorzások soronként párhuzamosak,
+ minden szál csak a saját eredménysorait írja (a szimmetrikus mat-vec
+ rögzített sávonként külön gyűjtőbe), így az eredmény a szálszámtól
+ független.
+*/
+
+enum class Triangle { lower, upper };
+
+namespace matrix_kernels {
+
+// Soronként tömörített háromszög: az (i, j) elem helye (alsónál j <= i, felsőnél j >= i)
+inline std::size_t packed_lower_index(int i, int j) {
+    return static_cast<std::size_t>(i) * (i + 1) / 2 + j;
+}
+
+inline std::size_t packed_upper_index(int n, int i, int j) {
+    return static_cast<std::size_t>(i) * n - static_cast<std::size_t>(i) * (i - 1) / 2 + (j - i);
+}
+
+// Darabméret a soronkénti parallel_for-hoz: egy darab legalább ~32k elemet dolgozzon fel
+inline int structured_grain(std::size_t work_per_row) {
+    return static_cast<int>(std::max<std::size_t>(1, (std::size_t{1} << 15) / std::max<std::size_t>(1, work_per_row)));
+}
+
+/*
+ Háromszögű rendszer tömörített tárolásból: T * X = B, B helyén (n x nrhs, ldb sorhossz)
+ Alsónál előre, felsőnél visszafelé haladunk; T i. sora folytonos, a
+ jobb oldalak sorain axpy-val lépünk.
+*/
+template<typename T>
+void packed_triangular_solve(int n, T const* a, Triangle uplo, T* b, int nrhs, int ldb) {
+    bool lower = uplo == Triangle::lower;
+    for (int s = 0; s < n; ++s) {
+        int i = lower ? s : n - 1 - s;
+        T* bi = b + static_cast<std::size_t>(i) * ldb;
+        T const* row = a + (lower ? packed_lower_index(i, 0) : packed_upper_index(n, i, i));
+        int j0 = lower ? 0 : i + 1, j1 = lower ? i : n;
+        for (int j = j0; j < j1; ++j) {
+            T v = row[lower ? j : j - i];
+            if (v == T{}) continue;
+            T const* bj = b + static_cast<std::size_t>(j) * ldb;
+            for (int c = 0; c < nrhs; ++c) bi[c] -= v * bj[c];
+        }
+        T d = row[lower ? i : 0];
+        for (int c = 0; c < nrhs; ++c) bi[c] /= d;
+    }
+}
+
+/*
+ Sávos LU helyben, a LAPACK dgbtrf elrendezésében: az (i, j) elem
+ ab[j * ldab + kl + ku + i - j], ldab >= 2 * kl + ku + 1. A felső kl sor
+ a sorcserék miatti kitöltésnek kell (U felső sávszélessége kl + ku), a
+ szorzók (L) a főátló alatti kl helyre kerülnek.
+ Visszatérés: az első szinguláris oszlop indexe, vagy -1.
+*/
+template<typename T>
+int band_lu_factor(int n, int kl, int ku, T* ab, int ldab, int* piv) {
+    int kv = kl + ku;
+    auto at = [&](int i, int j) -> T& { return ab[static_cast<std::size_t>(j) * ldab + kv + i - j]; };
+    int singular_col = -1;
+    for (int k = 0; k < n; ++k) {
+        int last = std::min(n - 1, k + kl);
+        int p = k;
+        T best = std::abs(at(k, k));
+        for (int i = k + 1; i <= last; ++i)
+            if (std::abs(at(i, k)) > best) {
+                best = std::abs(at(i, k));
+                p = i;
+            }
+        piv[k] = p;
+        if (best < lu_singular_tolerance) {
+            if (singular_col < 0) singular_col = k;
+            continue;
+        }
+        int ju = std::min(n - 1, k + kv);
+        if (p != k)
+            for (int j = k; j <= ju; ++j) std::swap(at(k, j), at(p, j));
+        // Az oszlopok a sávon belül folytonosak: (i + 1, j) közvetlenül (i, j) után
+        T pivot = at(k, k);
+        T* lk = &at(k, k) + 1;
+        int m = last - k;
+        for (int i = 0; i < m; ++i) lk[i] /= pivot;
+        for (int j = k + 1; j <= ju; ++j) {
+            T u = at(k, j);
+            if (u == T{}) continue;
+            T* cj = &at(k, j) + 1;
+            for (int i = 0; i < m; ++i) cj[i] -= lk[i] * u;
+        }
+    }
+    return singular_col;
+}
+
+// A * X = B a band_lu_factor felbontásából, B helyén (n x nrhs, ldb sorhossz)
+template<typename T>
+void band_lu_solve(int n, int kl, int ku, T const* ab, int ldab, int const* piv, T* b, int nrhs, int ldb) {
+    int kv = kl + ku;
+    auto at = [&](int i, int j) { return ab[static_cast<std::size_t>(j) * ldab + kv + i - j]; };
+    auto row = [&](int i) { return b + static_cast<std::size_t>(i) * ldb; };
+    for (int k = 0; k < n; ++k) {
+        if (piv[k] != k) std::swap_ranges(row(k), row(k) + nrhs, row(piv[k]));
+        T const* bk = row(k);
+        for (int i = k + 1; i <= std::min(n - 1, k + kl); ++i) {
+            T l = at(i, k);
+            if (l == T{}) continue;
+            T* bi = row(i);
+            for (int c = 0; c < nrhs; ++c) bi[c] -= l * bk[c];
+        }
+    }
+    // U oszloponként visszafelé
+    for (int j = n - 1; j >= 0; --j) {
+        T* bj = row(j);
+        T d = at(j, j);
+        for (int c = 0; c < nrhs; ++c) bj[c] /= d;
+        for (int i = std::max(0, j - kv); i < j; ++i) {
+            T u = at(i, j);
+            if (u == T{}) continue;
+            T* bi = row(i);
+            for (int c = 0; c < nrhs; ++c) bi[c] -= u * bj[c];
+        }
+    }
+}
+
+/*
+ Thomas-algoritmus: háromátlós rendszer főelemcsere nélkül, B helyén
+ (n x nrhs, ldb sorhossz); sub[i] = A(i + 1, i), sup[i] = A(i, i + 1),
+ work n elemű. Diagonálisan domináns vagy SPD mátrixra stabil.
+ Visszatérés: az első (közel) nulla főelem sora, vagy -1.
+*/
+template<typename T>
+int thomas_solve(int n, T const* sub, T const* diag, T const* sup, T* b, int nrhs, int ldb, T* work) {
+    auto row = [&](int i) { return b + static_cast<std::size_t>(i) * ldb; };
+    for (int i = 0; i < n; ++i) {
+        T l = i > 0 ? sub[i - 1] : T{};
+        T d = diag[i] - (i > 0 ? l * work[i - 1] : T{});
+        if (std::abs(d) < lu_singular_tolerance) return i;
+        work[i] = i + 1 < n ? sup[i] / d : T{};
+        T* bi = row(i);
+        if (i > 0) {
+            T const* bp = row(i - 1);
+            for (int c = 0; c < nrhs; ++c) bi[c] -= l * bp[c];
+        }
+        for (int c = 0; c < nrhs; ++c) bi[c] /= d;
+    }
+    for (int i = n - 2; i >= 0; --i) {
+        T* bi = row(i);
+        T const* bn = row(i + 1);
+        for (int c = 0; c < nrhs; ++c) bi[c] -= work[i] * bn[c];
+    }
+    return -1;
+}
+
+} // namespace matrix_kernels
+
+/*
+ Szimmetrikus mátrix tömörítve: csak az alsó háromszöget tároljuk
+ (i, j) és (j, i) ugyanaz az elem, mindkettő írható.
+*/
+template<typename T>
+class PackedSymmetricMatrix {
+    int n_;
+    std::vector<T> data_;
+
+    static std::size_t index(int i, int j) {
+        return i >= j ? matrix_kernels::packed_lower_index(i, j) : matrix_kernels::packed_lower_index(j, i);
+    }
+
+public:
+    using value_type = T;
+
+    explicit PackedSymmetricMatrix(int n, T const& val = T{})
+        : n_(n), data_(static_cast<std::size_t>(std::max(n, 0)) * (std::max(n, 0) + 1) / 2, val) {
+        if (n < 0) throw std::invalid_argument("Negative matrix dimension");
+    }
+
+    // Sűrű mátrix alsó háromszögéből (a felső háromszöget nem olvassa, mint a Cholesky)
+    explicit PackedSymmetricMatrix(Matrix<T> const& a) : PackedSymmetricMatrix(a.rows()) {
+        check_same_size(a.rows(), a.cols());
+        for (int i = 0; i < n_; ++i)
+            std::copy(&a(i, 0), &a(i, 0) + i + 1, data_.data() + matrix_kernels::packed_lower_index(i, 0));
+    }
+
+    int size() const { return n_; }
+    int rows() const { return n_; }
+    int cols() const { return n_; }
+
+    T operator()(int i, int j) const { return data_[index(i, j)]; }
+    T& operator()(int i, int j) { return data_[index(i, j)]; }
+
+    // A tömörített tömb: az i. sor packed_lower_index(i, 0)-tól i + 1 elem
+    T* data() { return data_.data(); }
+    T const* data() const { return data_.data(); }
+
+    std::size_t memory_bytes() const { return data_.size() * sizeof(T); }
+
+    Matrix<T> to_dense() const {
+        Matrix<T> d(n_);
+        for (int i = 0; i < n_; ++i)
+            for (int j = 0; j <= i; ++j) d(i, j) = d(j, i) = (*this)(i, j);
+        return d;
+    }
+
+    /*
+     y = A * x egyetlen végigolvasással: az i. sor (folytonos) a skaláris
+     szorzattal y[i]-hez, axpy-val y[0 .. i)-hez (a felső háromszög) ad.
+     A sorokat rögzített számú, egyenlő elemszámú sávra bontjuk, sávonként
+     külön gyűjtővel; a sávok száma csak n-től függ, így az eredmény a
+     szálszámtól független.
+    */
+    void multiply(T const* x, T* y) const {
+        auto sweep = [&](int i0, int i1, T* out) {
+            for (int i = i0; i < i1; ++i) {
+                T const* row = data_.data() + matrix_kernels::packed_lower_index(i, 0);
+                T xi = x[i], s = row[i] * xi;
+                for (int j = 0; j < i; ++j) {
+                    s += row[j] * x[j];
+                    out[j] += row[j] * xi;
+                }
+                out[i] += s;
+            }
+        };
+        std::fill(y, y + n_, T{});
+        int parts = static_cast<int>(std::clamp<std::size_t>(data_.size() >> 17, 1, 8));
+        if (parts == 1) {
+            sweep(0, n_, y);
+            return;
+        }
+        // A p. sáv kezdősora: az első p / parts rész a háromszög elemeinek p / parts hányada
+        auto bound = [&](int p) { return static_cast<int>(n_ * std::sqrt(static_cast<double>(p) / parts)); };
+        std::vector<std::vector<T>> partial(parts - 1);
+        parallel_for(0, parts, 1, [&](int p0, int p1) {
+            for (int p = p0; p < p1; ++p) {
+                int i1 = p + 1 == parts ? n_ : bound(p + 1);
+                T* out = y;
+                if (p > 0) {
+                    partial[p - 1].assign(i1, T{});
+                    out = partial[p - 1].data();
+                }
+                sweep(bound(p), i1, out);
+            }
+        });
+        for (auto const& part : partial)
+            for (std::size_t i = 0; i < part.size(); ++i) y[i] += part[i];
+    }
+
+    friend std::vector<T> operator*(PackedSymmetricMatrix const& a, std::vector<T> const& x) {
+        if (static_cast<int>(x.size()) != a.n_)
+            throw MatrixSizeMismatch();
+        std::vector<T> y(a.n_);
+        a.multiply(x.data(), y.data());
+        return y;
+    }
+
+    // A * B: C i. sora a B-sorok A(i, j)-vel súlyozott összege, soronként axpy
+    friend Matrix<T> operator*(PackedSymmetricMatrix const& a, Matrix<T> const& b) {
+        check_same_size(a.n_, b.rows());
+        int n = a.n_, m = b.cols();
+        Matrix<T> c(n, m, T{});
+        parallel_for(0, n, matrix_kernels::structured_grain(static_cast<std::size_t>(n) * m), [&](int r0, int r1) {
+            for (int i = r0; i < r1; ++i) {
+                T* ci = c.data() + static_cast<std::size_t>(i) * m;
+                for (int j = 0; j < n; ++j) {
+                    T v = a(i, j);
+                    if (v == T{}) continue;
+                    matrix_kernels::simd_axpy(ci, v, b.data() + static_cast<std::size_t>(j) * m, static_cast<std::size_t>(m));
+                }
+            }
+        });
+        return c;
+    }
+};
+
+/*
+ Alsó vagy felső háromszögmátrix tömörítve (soronként, a főátlóval együtt)
+ A nem tárolt háromszög elemei nullák.
+*/
+template<typename T>
+class TriangularMatrix {
+    int n_;
+    Triangle uplo_;
+    std::vector<T> data_;
+
+    bool stored(int i, int j) const { return uplo_ == Triangle::lower ? j <= i : j >= i; }
+
+    std::size_t index(int i, int j) const {
+        return uplo_ == Triangle::lower ? matrix_kernels::packed_lower_index(i, j)
+                                        : matrix_kernels::packed_upper_index(n_, i, j);
+    }
+
+    // Az i. sor tárolt része: [first, last) oszlopok a row_data(i)-től
+    int first(int i) const { return uplo_ == Triangle::lower ? 0 : i; }
+    int last(int i) const { return uplo_ == Triangle::lower ? i + 1 : n_; }
+    T const* row_data(int i) const { return data_.data() + index(i, first(i)); }
+
+public:
+    using value_type = T;
+
+    TriangularMatrix(int n, Triangle uplo, T const& val = T{})
+        : n_(n), uplo_(uplo), data_(static_cast<std::size_t>(std::max(n, 0)) * (std::max(n, 0) + 1) / 2, val) {
+        if (n < 0) throw std::invalid_argument("Negative matrix dimension");
+    }
+
+    // Sűrű mátrix megfelelő háromszögéből, a másikat nem olvassa
+    TriangularMatrix(Matrix<T> const& a, Triangle uplo) : TriangularMatrix(a.rows(), uplo) {
+        check_same_size(a.rows(), a.cols());
+        for (int i = 0; i < n_; ++i)
+            std::copy(&a(i, 0) + first(i), &a(i, 0) + last(i), data_.data() + index(i, first(i)));
+    }
+
+    int size() const { return n_; }
+    int rows() const { return n_; }
+    int cols() const { return n_; }
+    Triangle triangle() const { return uplo_; }
+
+    T operator()(int i, int j) const { return stored(i, j) ? data_[index(i, j)] : T{}; }
+
+    T& at(int i, int j) {
+        if (i < 0 || i >= n_ || j < 0 || j >= n_ || !stored(i, j))
+            throw std::out_of_range("Triangular matrix index outside the stored triangle");
+        return data_[index(i, j)];
+    }
+
+    T* data() { return data_.data(); }
+    T const* data() const { return data_.data(); }
+
+    std::size_t memory_bytes() const { return data_.size() * sizeof(T); }
+
+    Matrix<T> to_dense() const {
+        Matrix<T> d(n_, n_, T{});
+        for (int i = 0; i < n_; ++i) std::copy(row_data(i), row_data(i) + (last(i) - first(i)), &d(i, first(i)));
+        return d;
+    }
+
+    // A főátló szorzata
+    T det() const {
+        T d = 1;
+        for (int i = 0; i < n_; ++i) d *= (*this)(i, i);
+        return d;
+    }
+
+    bool singular() const {
+        for (int i = 0; i < n_; ++i)
+            if (std::abs((*this)(i, i)) < matrix_kernels::lu_singular_tolerance) return true;
+        return false;
+    }
+
+    // y = A * x, soronként a tárolt (folytonos) rész skaláris szorzata
+    void multiply(T const* x, T* y) const {
+        parallel_for(0, n_, matrix_kernels::structured_grain(n_ / 2 + 1), [&](int r0, int r1) {
+            for (int i = r0; i < r1; ++i) {
+                T const* row = row_data(i);
+                T const* xi = x + first(i);
+                T s{};
+                for (int j = 0, m = last(i) - first(i); j < m; ++j) s += row[j] * xi[j];
+                y[i] = s;
+            }
+        });
+    }
+
+    friend std::vector<T> operator*(TriangularMatrix const& a, std::vector<T> const& x) {
+        if (static_cast<int>(x.size()) != a.n_)
+            throw MatrixSizeMismatch();
+        std::vector<T> y(a.n_);
+        a.multiply(x.data(), y.data());
+        return y;
+    }
+
+    friend Matrix<T> operator*(TriangularMatrix const& a, Matrix<T> const& b) {
+        check_same_size(a.n_, b.rows());
+        int n = a.n_, m = b.cols();
+        Matrix<T> c(n, m, T{});
+        parallel_for(0, n, matrix_kernels::structured_grain(static_cast<std::size_t>(n / 2 + 1) * m), [&](int r0, int r1) {
+            for (int i = r0; i < r1; ++i) {
+                T* ci = c.data() + static_cast<std::size_t>(i) * m;
+                T const* row = a.row_data(i);
+                for (int j = a.first(i); j < a.last(i); ++j) {
+                    T v = row[j - a.first(i)];
+                    if (v == T{}) continue;
+                    matrix_kernels::simd_axpy(ci, v, b.data() + static_cast<std::size_t>(j) * m, static_cast<std::size_t>(m));
+                }
+            }
+        });
+        return c;
+    }
+
+    // A * x = b előre / vissza helyettesítéssel, O(n^2)
+    std::vector<T> solve(std::vector<T> b) const {
+        if (static_cast<int>(b.size()) != n_)
+            throw MatrixSizeMismatch();
+        if (singular()) throw std::runtime_error("Matrix is singular");
+        matrix_kernels::packed_triangular_solve(n_, data_.data(), uplo_, b.data(), 1, 1);
+        return b;
+    }
+
+    Matrix<T> solve(Matrix<T> B) const {
+        check_same_size(B.rows(), n_);
+        if (singular()) throw std::runtime_error("Matrix is singular");
+        matrix_kernels::packed_triangular_solve(n_, data_.data(), uplo_, B.data(), B.cols(), B.cols());
+        return B;
+    }
+};
+
+/*
+ Sávmátrix: A(i, j) == 0, ha i - j > kl vagy j - i > ku
+ Tárolás a LAPACK sávos elrendezésében (oszloponként, dgbmv / dgbsv):
+ az (i, j) elem data()[j * ld() + ku + i - j], ld() = kl + ku + 1; a
+ bal felső és jobb alsó sarokba lógó helyek kihasználatlanok (nullák).
+*/
+template<typename T>
+class BandMatrix {
+    int n_, kl_, ku_;
+    std::vector<T> data_;
+
+    std::size_t index(int i, int j) const { return static_cast<std::size_t>(j) * ld() + ku_ + i - j; }
+
+public:
+    using value_type = T;
+
+    BandMatrix(int n, int kl, int ku, T const& val = T{})
+        : n_(n), kl_(kl), ku_(ku) {
+        if (n < 0 || kl < 0 || ku < 0) throw std::invalid_argument("Negative band matrix dimension");
+        data_.assign(static_cast<std::size_t>(n) * ld(), T{});
+        for (int j = 0; j < n; ++j)
+            for (int i = std::max(0, j - ku); i <= std::min(n - 1, j + kl); ++i) data_[index(i, j)] = val;
+    }
+
+    // Sűrű mátrix sávja (a sávon kívüli elemeket elhagyja)
+    BandMatrix(Matrix<T> const& a, int kl, int ku) : BandMatrix(a.rows(), kl, ku) {
+        check_same_size(a.rows(), a.cols());
+        for (int j = 0; j < n_; ++j)
+            for (int i = std::max(0, j - ku_); i <= std::min(n_ - 1, j + kl_); ++i) data_[index(i, j)] = a(i, j);
+    }
+
+    int size() const { return n_; }
+    int rows() const { return n_; }
+    int cols() const { return n_; }
+    int lower_bandwidth() const { return kl_; }
+    int upper_bandwidth() const { return ku_; }
+    int ld() const { return kl_ + ku_ + 1; }
+
+    bool in_band(int i, int j) const { return i - j <= kl_ && j - i <= ku_; }
+
+    T operator()(int i, int j) const { return in_band(i, j) ? data_[index(i, j)] : T{}; }
+
+    T& at(int i, int j) {
+        if (i < 0 || i >= n_ || j < 0 || j >= n_ || !in_band(i, j))
+            throw std::out_of_range("Band matrix index outside the band");
+        return data_[index(i, j)];
+    }
+
+    // A LAPACK-elrendezésű tömb, ld() lépéssel
+    T* data() { return data_.data(); }
+    T const* data() const { return data_.data(); }
+
+    std::size_t memory_bytes() const { return data_.size() * sizeof(T); }
+
+    Matrix<T> to_dense() const {
+        Matrix<T> d(n_, n_, T{});
+        for (int j = 0; j < n_; ++j)
+            for (int i = std::max(0, j - ku_); i <= std::min(n_ - 1, j + kl_); ++i) d(i, j) = data_[index(i, j)];
+        return d;
+    }
+
+    // y = A * x; soronként összegyűjtve (a sor elemei ld() - 1 lépésre vannak), O(n * (kl + ku))
+    void multiply(T const* x, T* y) const {
+        std::size_t step = static_cast<std::size_t>(ld()) - 1;
+        parallel_for(0, n_, matrix_kernels::structured_grain(static_cast<std::size_t>(ld())), [&](int r0, int r1) {
+            for (int i = r0; i < r1; ++i) {
+                int j0 = std::max(0, i - kl_), j1 = std::min(n_ - 1, i + ku_);
+                T const* a = data_.data() + index(i, j0);
+                T s{};
+                for (int j = j0; j <= j1; ++j, a += step) s += *a * x[j];
+                y[i] = s;
+            }
+        });
+    }
+
+    friend std::vector<T> operator*(BandMatrix const& a, std::vector<T> const& x) {
+        if (static_cast<int>(x.size()) != a.n_)
+            throw MatrixSizeMismatch();
+        std::vector<T> y(a.n_);
+        a.multiply(x.data(), y.data());
+        return y;
+    }
+
+    // A * B: C i. sora legfeljebb kl + ku + 1 B-sor axpy-ja
+    friend Matrix<T> operator*(BandMatrix const& a, Matrix<T> const& b) {
+        check_same_size(a.n_, b.rows());
+        int n = a.n_, m = b.cols();
+        Matrix<T> c(n, m, T{});
+        parallel_for(0, n, matrix_kernels::structured_grain(static_cast<std::size_t>(a.ld()) * m), [&](int r0, int r1) {
+            for (int i = r0; i < r1; ++i) {
+                T* ci = c.data() + static_cast<std::size_t>(i) * m;
+                for (int j = std::max(0, i - a.kl_); j <= std::min(n - 1, i + a.ku_); ++j) {
+                    T v = a.data_[a.index(i, j)];
+                    if (v == T{}) continue;
+                    matrix_kernels::simd_axpy(ci, v, b.data() + static_cast<std::size_t>(j) * m, static_cast<std::size_t>(m));
+                }
+            }
+        });
+        return c;
+    }
+};
+
+/*
+ Sávmátrix LU-felbontása részleges főelemkiválasztással (dgbtrf)
+ A sorcserék miatt U felső sávszélessége kl + ku lesz, ezért a
+ felbontás 2 * kl + ku + 1 hosszú oszlopokban tárol; L nem nő túl a sávon.
+*/
+template<typename T>
+class BandLU {
+    int n_, kl_, ku_, ldab_;
+    std::vector<T> ab_;
+    std::vector<int> piv_;
+    int singular_col_;
+
+    void require_regular() const {
+        if (singular_col_ >= 0)
+            throw std::runtime_error("Matrix is singular");
+    }
+
+public:
+    explicit BandLU(BandMatrix<T> const& a)
+        : n_(a.size()), kl_(a.lower_bandwidth()), ku_(a.upper_bandwidth()), ldab_(2 * kl_ + ku_ + 1),
+          ab_(static_cast<std::size_t>(n_) * ldab_, T{}), piv_(n_) {
+        for (int j = 0; j < n_; ++j)
+            std::copy(a.data() + static_cast<std::size_t>(j) * a.ld(), a.data() + static_cast<std::size_t>(j + 1) * a.ld(),
+                      ab_.data() + static_cast<std::size_t>(j) * ldab_ + kl_);
+        singular_col_ = matrix_kernels::band_lu_factor(n_, kl_, ku_, ab_.data(), ldab_, piv_.data());
+    }
+
+    int size() const { return n_; }
+    bool singular() const { return singular_col_ >= 0; }
+
+    // A felbontás a dgbtrf elrendezésében (ldab = 2 * kl + ku + 1) és a sorcserék
+    std::vector<T> const& factors() const { return ab_; }
+    std::vector<int> const& pivots() const { return piv_; }
+
+    T det() const {
+        if (singular()) return T{};
+        T d = 1;
+        for (int i = 0; i < n_; ++i) {
+            d *= ab_[static_cast<std::size_t>(i) * ldab_ + kl_ + ku_];
+            if (piv_[i] != i) d = -d;
+        }
+        return d;
+    }
+
+    std::vector<T> solve(std::vector<T> b) const {
+        if (static_cast<int>(b.size()) != n_)
+            throw MatrixSizeMismatch();
+        require_regular();
+        matrix_kernels::band_lu_solve(n_, kl_, ku_, ab_.data(), ldab_, piv_.data(), b.data(), 1, 1);
+        return b;
+    }
+
+    Matrix<T> solve(Matrix<T> B) const {
+        check_same_size(B.rows(), n_);
+        require_regular();
+        matrix_kernels::band_lu_solve(n_, kl_, ku_, ab_.data(), ldab_, piv_.data(), B.data(), B.cols(), B.cols());
+        return B;
+    }
+};
+
+/*
+ Háromátlós mátrix: lower()[i] = A(i + 1, i), diagonal()[i] = A(i, i),
+ upper()[i] = A(i, i + 1)
+ A solve() a Thomas-algoritmus (főelemcsere nélkül, 8n lépés); ha nulla
+ főelembe fut, kivételt dob; ilyenkor a to_band() és a BandLU segít.
+*/
+template<typename T>
+class TridiagonalMatrix {
+    int n_;
+    std::vector<T> sub_, diag_, sup_;
+
+    template<typename B>
+    void thomas(B& b, int nrhs) const {
+        std::vector<T> work(n_);
+        if (matrix_kernels::thomas_solve(n_, sub_.data(), diag_.data(), sup_.data(), b.data(), nrhs, nrhs, work.data()) >= 0)
+            throw std::runtime_error("Matrix is singular or needs pivoting");
+    }
+
+public:
+    using value_type = T;
+
+    explicit TridiagonalMatrix(int n, T const& val = T{})
+        : n_(n), sub_(std::max(n - 1, 0), val), diag_(std::max(n, 0), val), sup_(std::max(n - 1, 0), val) {
+        if (n < 0) throw std::invalid_argument("Negative matrix dimension");
+    }
+
+    TridiagonalMatrix(std::vector<T> sub, std::vector<T> diag, std::vector<T> sup)
+        : n_(static_cast<int>(diag.size())), sub_(std::move(sub)), diag_(std::move(diag)), sup_(std::move(sup)) {
+        std::size_t off = diag_.empty() ? 0 : diag_.size() - 1;
+        if (sub_.size() != off || sup_.size() != off)
+            throw MatrixSizeMismatch();
+    }
+
+    int size() const { return n_; }
+    int rows() const { return n_; }
+    int cols() const { return n_; }
+
+    std::vector<T>& lower() { return sub_; }
+    std::vector<T> const& lower() const { return sub_; }
+    std::vector<T>& diagonal() { return diag_; }
+    std::vector<T> const& diagonal() const { return diag_; }
+    std::vector<T>& upper() { return sup_; }
+    std::vector<T> const& upper() const { return sup_; }
+
+    T operator()(int i, int j) const {
+        if (i == j) return diag_[i];
+        if (i == j + 1) return sub_[j];
+        if (j == i + 1) return sup_[i];
+        return T{};
+    }
+
+    std::size_t memory_bytes() const { return (sub_.size() + diag_.size() + sup_.size()) * sizeof(T); }
+
+    Matrix<T> to_dense() const {
+        Matrix<T> d(n_, n_, T{});
+        for (int i = 0; i < n_; ++i) {
+            d(i, i) = diag_[i];
+            if (i + 1 < n_) {
+                d(i + 1, i) = sub_[i];
+                d(i, i + 1) = sup_[i];
+            }
+        }
+        return d;
+    }
+
+    BandMatrix<T> to_band() const {
+        BandMatrix<T> b(n_, 1, 1);
+        for (int i = 0; i < n_; ++i) {
+            b.at(i, i) = diag_[i];
+            if (i + 1 < n_) {
+                b.at(i + 1, i) = sub_[i];
+                b.at(i, i + 1) = sup_[i];
+            }
+        }
+        return b;
+    }
+
+    void multiply(T const* x, T* y) const {
+        parallel_for(0, n_, matrix_kernels::structured_grain(3), [&](int r0, int r1) {
+            for (int i = r0; i < r1; ++i) {
+                T s = diag_[i] * x[i];
+                if (i > 0) s += sub_[i - 1] * x[i - 1];
+                if (i + 1 < n_) s += sup_[i] * x[i + 1];
+                y[i] = s;
+            }
+        });
+    }
+
+    friend std::vector<T> operator*(TridiagonalMatrix const& a, std::vector<T> const& x) {
+        if (static_cast<int>(x.size()) != a.n_)
+            throw MatrixSizeMismatch();
+        std::vector<T> y(a.n_);
+        a.multiply(x.data(), y.data());
+        return y;
+    }
+
+    std::vector<T> solve(std::vector<T> b) const {
+        if (static_cast<int>(b.size()) != n_)
+            throw MatrixSizeMismatch();
+        thomas(b, 1);
+        return b;
+    }
+
+    Matrix<T> solve(Matrix<T> B) const {
+        check_same_size(B.rows(), n_);
+        thomas(B, B.cols());
+        return B;
+    }
+};
@@ -1,8 +1,22 @@
 #include "matrix.h"
+#include "small_matrix.h"
+#include "matrix_batch.h"
+#include "sparse_matrix.h"
+#include "krylov.h"
+#include "cholesky.h"
+#include "structured_matrix.h"
+#include "../masodik-hf/vector2_array.h"
+#include "../elso_hf/quadrature.h"
+#include "../elso_hf/romberg.h"
+#include "../elso_hf/integrate_batch.h"
+#include "../elso_hf/fastmath.h"
+#include "numerics_c.h"
 #include <iostream>
 #include <cmath>
 #include <cassert>
 #include <iomanip>
+#include <cstdint>
+#include <array>
 
 void print_side_by_side(const Matrix<double>& A, const Matrix<double>& B, const std::string& op) {
     int n = A.size();
@@ -71,6 +85,20 @@ void test_all() {
         if (A(2, 2) != 42.0) throw std::runtime_error("Write index operator failed");
     });
 
+    run("Négyzetes és téglalap alakú konstruktorok", [] {
+        // Két argumentum: n x n-es, val értékkel kitöltve (mint eddig), elemtípustól függetlenül
+        Matrix<int> S(3, 7);
+        Matrix<double> Z(4, 0), O(2, 1);
+        if (S.rows() != 3 || S.cols() != 3 || S(2, 2) != 7 || Z.rows() != 4 || Z.cols() != 4 ||
+            O.rows() != 2 || O.cols() != 2 || O(1, 0) != 1.0)
+            throw std::runtime_error("Square fill constructor built the wrong shape");
+        // Téglalap alak csak három argumentummal vagy névvel
+        Matrix<double> R = Matrix<double>::zeros(3, 5);
+        Matrix<float> C(2, 7, 1.5f);
+        if (R.rows() != 3 || R.cols() != 5 || R(2, 4) != 0.0 || C.rows() != 2 || C.cols() != 7 || C(1, 6) != 1.5f)
+            throw std::runtime_error("Rectangular constructor built the wrong shape");
+    });
+
     run("Összeadás", [] {
         Matrix<double> A(2, {1, 2, 3, 4});
         Matrix<double> B(2, {4, 3, 2, 1});
@@ -198,6 +226,1262 @@ void test_all() {
         if (T.size() != 4) throw std::runtime_error("Tensor product size incorrect");
         if (T(0, 1) != 5 || T(3, 3) != 28) throw std::runtime_error("Tensor product values incorrect");
     });
+
+    run("Párhuzamos szorzás (4 szál, soros referenciával)", [] {
+        unsigned old_threads = get_num_threads();
+        set_num_threads(4);
+        int n = 301;
+        Matrix<double> A(n), B(n);
+        for (int i = 0; i < n; ++i)
+            for (int j = 0; j < n; ++j) {
+                A(i, j) = std::sin(i + 2.0 * j);
+                B(i, j) = std::cos(3.0 * i - j);
+            }
+        Matrix<double> C = A * B;
+        Matrix<double> ref(n);
+        for (int i = 0; i < n; ++i)
+            for (int k = 0; k < n; ++k)
+                for (int j = 0; j < n; ++j)
+                    ref(i, j) += A(i, k) * B(k, j);
+        for (int i = 0; i < n; ++i)
+            for (int j = 0; j < n; ++j)
+                if (std::abs(C(i, j) - ref(i, j)) > 1e-9)
+                    throw std::runtime_error("Parallel matrix multiplication incorrect");
+
+        std::vector<double> v(n, 1.0);
+        std::vector<double> Av = A * v, vA = v * A;
+        for (int i = 0; i < n; ++i) {
+            double row = 0, col = 0;
+            for (int j = 0; j < n; ++j) { row += A(i, j); col += A(j, i); }
+            if (std::abs(Av[i] - row) > 1e-9 || std::abs(vA[i] - col) > 1e-9)
+                throw std::runtime_error("Parallel matrix-vector product incorrect");
+        }
+
+        Matrix<int> I(160, 1), J(160, 2);
+        Matrix<int> K = I * J;
+        if (K(0, 0) != 320 || K(159, 159) != 320) throw std::runtime_error("Parallel int multiplication incorrect");
+
+        Matrix<double> T = tensor(A, Matrix<double>(3, 2.0));
+        if (T(3 * 7 + 1, 3 * 5 + 2) != 2.0 * A(7, 5)) throw std::runtime_error("Parallel tensor product incorrect");
+        set_num_threads(old_threads);
+    });
+
+    run("LU-felbontás (főelemcsere, megoldás, inverz)", [] {
+        // A(0, 0) = 0: főelemcsere nélkül a régi inv() itt hibát dobott
+        Matrix<double> A(3, {0, 2, 1, 1, 1, 1, 2, 1, 3});
+        A.print();
+        LU<double> lu(A);
+        std::cout << "det(A) = " << lu.det() << "\n";
+        if (std::abs(lu.det() - (-3.0)) > 1e-12) throw std::runtime_error("LU determinant incorrect");
+        if (std::abs(A.determinant() - lu.det()) > 1e-12) throw std::runtime_error("determinant() incorrect");
+
+        std::vector<double> x = lu.solve(std::vector<double>{5, 6, 13});
+        std::cout << "A x = [5, 6, 13] => x = "; print_vector(x); std::cout << "\n";
+        std::vector<double> Ax = A * x;
+        if (std::abs(Ax[0] - 5) > 1e-12 || std::abs(Ax[1] - 6) > 1e-12 || std::abs(Ax[2] - 13) > 1e-12)
+            throw std::runtime_error("LU solve incorrect");
+
+        Matrix<double> I = A * A.inv();
+        std::cout << "A * A^-1:\n"; I.print();
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 3; ++j)
+                if (std::abs(I(i, j) - (i == j ? 1.0 : 0.0)) > 1e-12)
+                    throw std::runtime_error("Pivoted inverse incorrect");
+
+        Matrix<double> S(2, {1, 2, 2, 4});
+        if (!LU<double>(S).singular() || S.determinant() != 0.0)
+            throw std::runtime_error("Singular matrix not detected");
+        bool thrown = false;
+        try { S.inv(); } catch (const std::runtime_error&) { thrown = true; }
+        if (!thrown) throw std::runtime_error("inv() of singular matrix did not throw");
+    });
+
+    run("Kifejezéssablonok (egy menetes kiértékelés)", [] {
+        Matrix<double> A(2, {1, 2, 3, 4});
+        Matrix<double> B(2, {4, 3, 2, 1});
+        Matrix<double> C(2, {1, 1, 1, 1});
+        Matrix<double> D = A + B - C * 2.0 + A / 2.0 - (-B);
+        std::cout << "D = A + B - C * 2 + A / 2 - (-B):\n"; D.print();
+        if (D(0, 0) != 7.5 || D(1, 1) != 6.0) throw std::runtime_error("Fused expression incorrect");
+
+        A = 2.0 * (A + B) - A;  // A önmagára hivatkozik a jobb oldalon
+        if (A(0, 0) != 9.0 || A(1, 1) != 6.0) throw std::runtime_error("Aliased expression assignment incorrect");
+
+        A += B * 0.5 - C;
+        A -= C / 4.0;
+        if (A(0, 0) != 9.75 || A(1, 1) != 5.25) throw std::runtime_error("Compound expression assignment incorrect");
+
+        Matrix<double> P = (A + B) * (C - C / 2.0);
+        if (P(0, 0) != 0.5 * (A(0, 0) + B(0, 0) + A(0, 1) + B(0, 1)))
+            throw std::runtime_error("Product of expressions incorrect");
+
+        Matrix<int> I(2, {1, 2, 3, 4});
+        Matrix<int> J = I * 3 - I / 2;
+        if (J(0, 0) != 3 || J(1, 1) != 10) throw std::runtime_error("Integer expression incorrect");
+    });
+
+    run("SIMD elemenkénti kernelek minden szinten", [] {
+        auto check_type = [](auto zero) {
+            using T = decltype(zero);
+            const std::size_t n = 37;  // nem osztható a vektorszélességgel: a maradék is tesztelve
+            std::vector<T> a(n), b(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                a[i] = static_cast<T>(i % 7 + 1);
+                b[i] = static_cast<T>(i % 5 + 2);
+            }
+            std::vector<T> d = a;
+            matrix_kernels::simd_add(d.data(), b.data(), n);
+            matrix_kernels::simd_sub(d.data(), a.data(), n);
+            matrix_kernels::simd_scale(d.data(), T(3), n);
+            matrix_kernels::simd_axpy(d.data(), T(2), a.data(), n);
+            matrix_kernels::simd_div(d.data(), T(2), n);
+            for (std::size_t i = 0; i < n; ++i)
+                if (d[i] != (b[i] * T(3) + T(2) * a[i]) / T(2))
+                    throw std::runtime_error("SIMD kernel result incorrect");
+        };
+        SimdLevel detected = detect_simd_level();
+        for (int l = 0; l <= static_cast<int>(detected); ++l) {
+            set_simd_level(static_cast<SimdLevel>(l));
+            check_type(0.0);
+            check_type(0.0f);
+            check_type(0);
+        }
+        set_simd_level(detected);
+        std::cout << "Ellenőrzött szintek: 0.." << static_cast<int>(detected) << "\n";
+
+        Matrix<double> A(5, 1.0), B(5, 2.0);
+        A += 3.0 * B;
+        A -= B * 0.5;
+        if (A(4, 4) != 6.0) throw std::runtime_error("Matrix axpy incorrect");
+    });
+
+    run("Téglalap alakú mátrixok", [] {
+        Matrix<double> A(2, 3, {1, 2, 3, 4, 5, 6});
+        Matrix<double> B(3, 2, {7, 8, 9, 10, 11, 12});
+        print_side_by_side(A, B, "*");
+        Matrix<double> C = A * B;
+        std::cout << "C = A * B (2x2):\n"; C.print();
+        if (C.rows() != 2 || C.cols() != 2 || C(0, 0) != 58 || C(1, 1) != 154)
+            throw std::runtime_error("Rectangular multiplication incorrect");
+
+        Matrix<double> At = A.transpose();
+        if (At.rows() != 3 || At.cols() != 2 || At(2, 1) != 6) throw std::runtime_error("Rectangular transpose incorrect");
+
+        std::vector<double> v = A * std::vector<double>{1, 1, 1};
+        std::vector<double> w = std::vector<double>{1, 1} * A;
+        if (v.size() != 2 || v[1] != 15 || w.size() != 3 || w[2] != 9)
+            throw std::runtime_error("Rectangular matrix-vector product incorrect");
+
+        Matrix<double> K = tensor(A, Matrix<double>(1, 2, {1, -1}));
+        if (K.rows() != 2 || K.cols() != 6 || K(1, 5) != -6) throw std::runtime_error("Rectangular tensor incorrect");
+
+        bool thrown = false;
+        try { A.determinant(); } catch (const MatrixSizeMismatch&) { thrown = true; }
+        if (!thrown) throw std::runtime_error("Determinant of non-square matrix did not throw");
+    });
+
+    run("Mátrixnézetek (blokk, sor, oszlop, transzponált)", [] {
+        Matrix<double> A(4, {1, 2, 3, 4,
+                             5, 6, 7, 8,
+                             9, 10, 11, 12,
+                             13, 14, 15, 16});
+        MatrixView<double> blk = static_cast<Matrix<double> const&>(A).block(1, 1, 2, 2);
+        Matrix<double> copy = blk;
+        std::cout << "A[1..2, 1..2]:\n"; copy.print();
+        if (copy(0, 0) != 6 || copy(1, 1) != 11) throw std::runtime_error("Block view incorrect");
+
+        // Blokkszorzás másolás nélkül: bal felső 2x2 * jobb alsó 2x2
+        Matrix<double> P = multiply(A.block(0, 0, 2, 2), A.block(2, 2, 2, 2));
+        if (P(0, 0) != 1 * 11 + 2 * 15 || P(1, 1) != 5 * 12 + 6 * 16) throw std::runtime_error("Block product incorrect");
+
+        // Írás nézeten keresztül
+        A.block(0, 2, 2, 2) += A.block(2, 0, 2, 2) * 2.0;
+        if (A(0, 2) != 3 + 18 || A(1, 3) != 8 + 28) throw std::runtime_error("Block update incorrect");
+        A.col(0).fill(0.0);
+        if (A(3, 0) != 0 || A(3, 1) != 14) throw std::runtime_error("Column fill incorrect");
+
+        Matrix<double> Rt = A.row(1).t();
+        if (Rt.rows() != 4 || Rt.cols() != 1 || Rt(1, 0) != 6) throw std::runtime_error("Row transpose view incorrect");
+
+        Matrix<double> y(4, 1, 0.0);
+        gemv(1.0, A.view(), A.view().col(1), y.view());
+        if (y(0, 0) != A(0, 0) * 2 + A(0, 1) * 6 + A(0, 2) * 10 + A(0, 3) * 14) throw std::runtime_error("View gemv incorrect");
+
+        Matrix<double> T(4, 4, 0.0);
+        transpose(A.view(), T.view());
+        if (T(2, 0) != A(0, 2)) throw std::runtime_error("View transpose incorrect");
+
+        // Önmagába író, más elrendezésben olvasó kifejezés: ideiglenesen át kell mennie
+        auto same = [](Matrix<double> const& a, Matrix<double> const& b) {
+            if (a.rows() != b.rows() || a.cols() != b.cols()) return false;
+            for (int i = 0; i < a.rows(); ++i)
+                for (int j = 0; j < a.cols(); ++j)
+                    if (a(i, j) != b(i, j)) return false;
+            return true;
+        };
+        Matrix<double> S(3, {1, 2, 3, 4, 5, 6, 7, 8, 9});
+        S = S.view().t();
+        if (!same(S, Matrix<double>(3, {1, 4, 7, 2, 5, 8, 3, 6, 9}))) throw std::runtime_error("A = A.view().t() aliased");
+        S.view() = S.view().t() * 2.0;
+        if (!same(S, Matrix<double>(3, {2, 4, 6, 8, 10, 12, 14, 16, 18}))) throw std::runtime_error("View self-transpose aliased");
+        Matrix<double> C(3, {1, 2, 3, 4, 5, 6, 7, 8, 9});
+        C.block(0, 1, 3, 2) = C.view().block(0, 0, 3, 2);
+        if (!same(C, Matrix<double>(3, {1, 1, 2, 4, 4, 5, 7, 7, 8}))) throw std::runtime_error("Overlapping block copy aliased");
+
+        // Nagy mátrixon (párhuzamos menet) is
+        int n = 300;
+        Matrix<double> L(n), Lt(n);
+        for (int i = 0; i < n; ++i)
+            for (int j = 0; j < n; ++j) L(i, j) = i * n + j;
+        transpose(L.view(), Lt.view());
+        L = L.view().t() + L.view().t();
+        if (!same(L, Lt * 2.0)) throw std::runtime_error("Large self-transpose aliased");
+    });
+
+    run("Blokkosított LU és mátrixosztás (n = 150)", [] {
+        int n = 150;
+        Matrix<double> A(n), B(n);
+        for (int i = 0; i < n; ++i)
+            for (int j = 0; j < n; ++j) {
+                A(i, j) = std::sin(1.0 + i * 7.0 + j * 3.0);
+                B(i, j) = std::cos(2.0 * i + 5.0 * j) + (i == j ? 4.0 : 0.0);
+            }
+        Matrix<double> X = A / B;
+        Matrix<double> R = X * B;
+        LU<double> lu(B);
+        Matrix<double> Y = lu.solve(A);
+        Matrix<double> BY = B * Y;
+        for (int i = 0; i < n; ++i)
+            for (int j = 0; j < n; ++j)
+                if (std::abs(R(i, j) - A(i, j)) > 1e-9 || std::abs(BY(i, j) - A(i, j)) > 1e-9)
+                    throw std::runtime_error("Blocked LU solve incorrect");
+    });
+
+    run("Igazított, készletből foglaló tároló", [] {
+        Matrix<double> A(64, 1.0), B(64, 2.0);
+        if (reinterpret_cast<std::uintptr_t>(A.data()) % 64 != 0)
+            throw std::runtime_error("Matrix storage not 64-byte aligned");
+
+        // Bemelegítés után az ismétlődő ciklus már csak a készletből foglal
+        auto step = [&] {
+            Matrix<double> C = A * B;
+            Matrix<double> D = C + A * 2.0;
+            A = D.transpose() / 64.0;
+        };
+        step();
+        reset_allocation_stats();
+        for (int it = 0; it < 10; ++it) step();
+        AllocationStats st = allocation_stats();
+        std::cout << "Heap foglalás: " << st.heap_allocations
+                  << ", készletből: " << st.pool_hits << "\n";
+        if (st.heap_allocations != 0 || st.pool_hits == 0)
+            throw std::runtime_error("Steady-state loop allocated from heap");
+
+        // A félretett blokkok visszaadhatók, utána újra a heapről foglalunk
+        reset_allocation_stats();
+        release_thread_cache();
+        { Matrix<double> E(64, 0.0); }
+        st = allocation_stats();
+        if (st.heap_deallocations == 0 || st.heap_allocations != 1 || st.pool_hits != 0)
+            throw std::runtime_error("release_thread_cache did not empty the cache");
+
+        // 4 MiB felett nincs kerekítés és gyorsítótár: közvetlenül a heapre
+        { Matrix<double> Big(1100, 0.0); }
+        reset_allocation_stats();
+        { Matrix<double> Big(1100, 0.0); }
+        st = allocation_stats();
+        if (st.heap_allocations != 1 || st.heap_deallocations != 1 || st.pool_hits != 0 || st.pool_returns != 0)
+            throw std::runtime_error("Large block went through the pool cache");
+
+        Matrix<double, std::allocator<double>> S(2, {1, 2, 3, 4});
+        Matrix<double, std::allocator<double>> P = S * S + S;
+        if (P(0, 0) != 8 || P(1, 1) != 26 || std::abs(S.inv()(0, 0) + 2) > 1e-12)
+            throw std::runtime_error("std::allocator Matrix incorrect");
+    });
+
+    run("Blokkosított és helyben transzponálás", [] {
+        auto check_type = [](auto zero) {
+            using T = decltype(zero);
+            // Mikroblokk- és levélméretre nem osztható méretek is
+            int sizes[][2] = {{1, 1}, {3, 5}, {8, 8}, {37, 70}, {129, 67}, {300, 300}, {301, 301}};
+            for (auto& sz : sizes) {
+                int r = sz[0], c = sz[1];
+                Matrix<T> A(r, c, T{});
+                for (int i = 0; i < r; ++i)
+                    for (int j = 0; j < c; ++j)
+                        A(i, j) = static_cast<T>(i * 1000 + j);
+                Matrix<T> At = A.transpose();
+                for (int i = 0; i < r; ++i)
+                    for (int j = 0; j < c; ++j)
+                        if (At(j, i) != A(i, j)) throw std::runtime_error("Blocked transpose incorrect");
+                if (r != c) continue;
+                Matrix<T> B = A;
+                B.transpose_inplace();
+                for (int i = 0; i < r; ++i)
+                    for (int j = 0; j < c; ++j)
+                        if (B(j, i) != A(i, j)) throw std::runtime_error("In-place transpose incorrect");
+            }
+        };
+        SimdLevel detected = detect_simd_level();
+        for (SimdLevel l : {SimdLevel::scalar, detected}) {
+            set_simd_level(l);
+            check_type(0.0);
+            check_type(0.0f);
+            check_type(0);
+        }
+        set_simd_level(detected);
+
+        // Nézeten keresztül, ugyanarra a blokkra: helyben
+        Matrix<double> M(6, 6, 0.0);
+        for (int i = 0; i < 6; ++i)
+            for (int j = 0; j < 6; ++j)
+                M(i, j) = i * 6 + j;
+        transpose(M.block(1, 1, 4, 4), M.block(1, 1, 4, 4));
+        if (M(1, 2) != 13 || M(2, 1) != 8 || M(0, 1) != 1 || M(4, 1) != 10)
+            throw std::runtime_error("In-place view transpose incorrect");
+
+        reset_allocation_stats();
+        M.transpose_inplace();
+        if (allocation_stats().heap_allocations != 0 || allocation_stats().pool_hits != 0)
+            throw std::runtime_error("transpose_inplace allocated");
+    });
+
+    run("Fix méretű kis mátrixok (SmallMatrix)", [] {
+        // Fordítási időben kiértékelve
+        constexpr SmallMatrix<double, 2> R{0, -1, 1, 0};
+        static_assert(R.determinant() == 1);
+        static_assert(R * R.transpose() == SmallMatrix<double, 2>::identity());
+        static_assert((R * Vector2<double>(1, 0)).y == 1);
+        constexpr SmallMatrix<int, 3> P{2, 0, 1, 1, 3, 2, 1, 1, 2};
+        static_assert(P.determinant() == 6);
+        static_assert(sizeof(SmallMatrix<double, 4>) == 16 * sizeof(double));
+
+        auto check_inverse = [](auto const& a) {
+            auto i = a * a.inv();
+            for (int r = 0; r < a.size(); ++r)
+                for (int c = 0; c < a.size(); ++c)
+                    if (std::abs(i(r, c) - (r == c ? 1.0 : 0.0)) > 1e-12)
+                        throw std::runtime_error("SmallMatrix inverse incorrect");
+        };
+        SmallMatrix<double, 3> A3{4, 7, 2, 3, 6, 1, 2, 5, 3};
+        SmallMatrix<double, 4> A4{4, 7, 2, 1, 3, 6, 1, 5, 2, 5, 3, 8, 1, 0, 2, 9};
+        SmallMatrix<double, 5> A5;
+        for (int i = 0; i < 5; ++i)
+            for (int j = 0; j < 5; ++j)
+                A5(i, j) = std::sin(1.0 + i * 5 + j) + (i == j ? 3.0 : 0.0);
+        check_inverse(R);
+        check_inverse(A3);
+        check_inverse(A4);
+        check_inverse(A5);
+
+        // A zárt képletek egyeznek a dinamikus mátrix LU-alapú eredményével
+        Matrix<double> M4(4, 4, 0.0);
+        for (int i = 0; i < 4; ++i)
+            for (int j = 0; j < 4; ++j)
+                M4(i, j) = A4(i, j);
+        if (std::abs(M4.determinant() - A4.determinant()) > 1e-9 || std::abs(A3.determinant() - 9) > 1e-12)
+            throw std::runtime_error("SmallMatrix determinant incorrect");
+
+        Vector2<double> u(1, 2), v(3, -1);
+        SmallMatrix<double, 2> O = outer(u, v);
+        Vector2<double> w = O * v;
+        Vector2<double> z = u * from_columns(u, v);
+        if (w.x != 10 || w.y != 20 || z.x != 5 || z.y != 1 || column(O, 1).y != -2)
+            throw std::runtime_error("SmallMatrix and Vector2 interop incorrect");
+
+        bool thrown = false;
+        try { SmallMatrix<double, 2>{1, 2, 2, 4}.inv(); } catch (std::runtime_error const&) { thrown = true; }
+        if (!thrown) throw std::runtime_error("Singular SmallMatrix not detected");
+
+        // Kis skálájú, de jól kondicionált mátrix nem szinguláris (relatív küszöb)
+        SmallMatrix<double, 3> D3 = SmallMatrix<double, 3>::identity();
+        D3 *= 1e-5;
+        SmallMatrix<double, 4> S4 = A4;
+        S4 *= 1e-3;
+        SmallMatrix<double, 3> D3i = D3.inv();
+        SmallMatrix<double, 4> S4i = S4.inv();
+        if (std::abs(D3i(1, 1) - 1e5) > 1e-6 || std::abs((S4 * S4i)(2, 2) - 1.0) > 1e-12 ||
+            std::abs((S4 * S4i)(0, 3)) > 1e-12)
+            throw std::runtime_error("Small-scale SmallMatrix rejected as singular");
+        thrown = false;
+        try { SmallMatrix<double, 3>{1e-3, 2e-3, 3e-3, 2e-3, 4e-3, 6e-3, 1, 0, 1}.inv(); }
+        catch (std::runtime_error const&) { thrown = true; }
+        if (!thrown) throw std::runtime_error("Scaled singular SmallMatrix not detected");
+    });
+
+    run("Kötegelt kis mátrixok (MatrixBatch, BatchLU)", [] {
+        const int count = 37;  // nem osztható a sávszámmal: a kitöltés is tesztelve
+        for (int n : {2, 3, 5}) {
+            MatrixBatch<double> A(count, n, n), B(count, n, 2), x(count, n, 1);
+            for (int k = 0; k < count; ++k)
+                for (int i = 0; i < n; ++i) {
+                    for (int j = 0; j < n; ++j)
+                        A(k, i, j) = std::sin(1.0 + k * 31 + i * 7 + j * 3) + (i == j ? 0.5 : 0.0);
+                    B(k, i, 0) = std::cos(k + i);
+                    B(k, i, 1) = i - k;
+                    x(k, i, 0) = 1.0 + i;
+                }
+            SimdLevel detected = detect_simd_level();
+            for (SimdLevel l : {SimdLevel::scalar, detected}) {
+                set_simd_level(l);
+                MatrixBatch<double> C = A * B;
+                MatrixBatch<double> y = matvec(A, x);
+                BatchLU<double> lu(A);
+                std::vector<double> d = lu.det();
+                MatrixBatch<double> X = lu.solve(B);
+                MatrixBatch<double> Ai = lu.inverse();
+                for (int k = 0; k < count; ++k) {
+                    Matrix<double> Ak = A.get(k), Bk = B.get(k);
+                    Matrix<double> Ck = Ak * Bk;
+                    Matrix<double> Rk = Ak * X.get(k) - Bk;
+                    Matrix<double> Ik = Ak * Ai.get(k) - Matrix<double>::identity(n);
+                    for (int i = 0; i < n; ++i) {
+                        double yi = 0;
+                        for (int j = 0; j < n; ++j) yi += Ak(i, j) * (1.0 + j);
+                        if (std::abs(y(k, i, 0) - yi) > 1e-12) throw std::runtime_error("Batched matvec incorrect");
+                        for (int j = 0; j < 2; ++j)
+                            if (std::abs(C(k, i, j) - Ck(i, j)) > 1e-12 || std::abs(Rk(i, j)) > 1e-9)
+                                throw std::runtime_error("Batched multiply or solve incorrect");
+                        for (int j = 0; j < n; ++j)
+                            if (std::abs(Ik(i, j)) > 1e-9) throw std::runtime_error("Batched inverse incorrect");
+                    }
+                    if (std::abs(d[k] - Ak.determinant()) > 1e-9 * std::max(1.0, std::abs(d[k])))
+                        throw std::runtime_error("Batched determinant incorrect");
+                }
+            }
+            set_simd_level(detected);
+        }
+
+        // Szinguláris tag: det 0, a megoldás kivételt dob
+        MatrixBatch<float> S(3, 2, 2, 1.0f);
+        S(0, 0, 1) = 0.0f;
+        BatchLU<float> slu(S);
+        if (slu.singular(0) || !slu.singular(1) || slu.det()[0] != 1.0f || slu.det()[2] != 0.0f)
+            throw std::runtime_error("Batched singular detection incorrect");
+        bool thrown = false;
+        try { slu.inverse(); } catch (std::runtime_error const&) { thrown = true; }
+        if (!thrown) throw std::runtime_error("Batched singular inverse not rejected");
+
+        // Negatív méret: invalid_argument még a foglalás előtt (nem length_error / bad_alloc)
+        for (auto dims : {std::array<int, 3>{4, -1, 3}, std::array<int, 3>{-5, 2, 2}, std::array<int, 3>{8, 2, -2}}) {
+            thrown = false;
+            try { MatrixBatch<double>(dims[0], dims[1], dims[2]); } catch (std::invalid_argument const&) { thrown = true; }
+            if (!thrown) throw std::runtime_error("Negative MatrixBatch dimension not rejected");
+        }
+    });
+    run("Vector2 tömb (Vector2Array, Vector2Span)", [] {
+        const std::size_t n = 1003;  // nem osztható a vektorszélességgel, és több AoS blokk
+        std::vector<Vector2<double>> pts(n);
+        for (std::size_t i = 0; i < n; ++i)
+            pts[i] = Vector2<double>(std::sin(0.1 * i) * 3 + 1, std::cos(0.37 * i) - 2);
+        Vector2<double> shift(0.5, -1.0);
+
+        SimdLevel detected = detect_simd_level();
+        for (SimdLevel l : {SimdLevel::scalar, detected}) {
+            set_simd_level(l);
+            Vector2Array<double> a(pts.data(), n);
+            Vector2Span<double const> aos(pts.data(), n);
+            Vector2Array<double> b = (a + aos) * 0.5 - shift;
+            auto d = dot(a, b);
+            auto dm = dot(aos, b.span());  // vegyes elrendezés
+            auto len = length(aos);
+            Vector2Array<double> u = normalize(a);
+            Vector2<double> s, lo = pts[0], hi = pts[0];
+            for (std::size_t i = 0; i < n; ++i) {
+                Vector2<double> bi = pts[i] - shift;
+                if (std::abs(b[i].x - bi.x) > 1e-12 || std::abs(b[i].y - bi.y) > 1e-12)
+                    throw std::runtime_error("Vector2Array arithmetic incorrect");
+                if (std::abs(d[i] - dot(pts[i], bi)) > 1e-12 || std::abs(dm[i] - d[i]) > 1e-12 || std::abs(len[i] - length(pts[i])) > 1e-12)
+                    throw std::runtime_error("Vector2Array dot or length incorrect");
+                Vector2<double> ui = normalize(pts[i]);
+                if (std::abs(u[i].x - ui.x) > 1e-12 || std::abs(u[i].y - ui.y) > 1e-12)
+                    throw std::runtime_error("Vector2Array normalize incorrect");
+                s += pts[i];
+                lo = Vector2<double>(std::min(lo.x, pts[i].x), std::min(lo.y, pts[i].y));
+                hi = Vector2<double>(std::max(hi.x, pts[i].x), std::max(hi.y, pts[i].y));
+            }
+            Vector2<double> sa = sum(a), so = sum(aos), c = centroid(a);
+            Vector2Bounds<double> ba = bounds(a), bo = bounds(aos);
+            if (std::abs(sa.x - s.x) > 1e-9 || std::abs(so.y - s.y) > 1e-9 ||
+                std::abs(c.x - s.x / n) > 1e-12 || std::abs(c.y - s.y / n) > 1e-12)
+                throw std::runtime_error("Vector2Array sum or centroid incorrect");
+            if (ba.min.x != lo.x || ba.max.y != hi.y || bo.min.y != lo.y || bo.max.x != hi.x)
+                throw std::runtime_error("Vector2Array bounds incorrect");
+
+            // Helyben, közvetlenül a Vector2 tömbön (másolás nélkül)
+            std::vector<Vector2<float>> fp = {{3, 4}, {0, -2}, {1, 1}};
+            normalize_inplace(Vector2Span<float>(fp.data(), fp.size()));
+            if (std::abs(fp[0].x - 0.6f) > 1e-6f || fp[1].y != -1.0f || std::abs(fp[2].x - std::sqrt(0.5f)) > 1e-6f)
+                throw std::runtime_error("Vector2Span normalize_inplace incorrect");
+            Vector2Array<float> back(fp.data(), fp.size());
+            if (back.to_vector()[0].y != fp[0].y) throw std::runtime_error("Vector2Array round trip incorrect");
+        }
+        set_simd_level(detected);
+
+        bool thrown = false;
+        try { Vector2Array<double>(3) += Vector2Array<double>(4); } catch (std::runtime_error const&) { thrown = true; }
+        if (!thrown) throw std::runtime_error("Vector2Array size mismatch not detected");
+        thrown = false;
+        try { centroid(Vector2Array<double>()); } catch (std::runtime_error const&) { thrown = true; }
+        if (!thrown) throw std::runtime_error("Empty Vector2Array centroid not rejected");
+    });
+    run("Gyors és pontos normalizálás (Precision)", [] {
+        Vector2<double> zero;
+        if (normalize(zero).x != 0 || normalize(zero, Precision::fast).y != 0 ||
+            std::abs(length(Vector2<float>(3, 4), Precision::fast) - 5.0f) > 5.0f * 4e-7f)
+            throw std::runtime_error("Scalar fast/precise normalize incorrect");
+
+        auto check = [](auto tag) {
+            using T = decltype(tag);
+            const std::size_t n = 517;
+            std::vector<Vector2<T>> pts(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                T scale = static_cast<T>(std::pow(10.0, static_cast<double>(i % 17) - 8));  // 1e-8 ... 1e8
+                pts[i] = Vector2<T>(static_cast<T>(std::sin(0.3 * i)) * scale, static_cast<T>(std::cos(0.7 * i)) * scale);
+            }
+            pts[5] = Vector2<T>();
+            // float elemnél a pontos eredmény is csak float-pontosságú
+            double tol = fast_rsqrt_rel_error + (std::is_same_v<T, float> ? 4e-7 : 0.0);
+            SimdLevel detected = detect_simd_level();
+            for (int l = 0; l <= static_cast<int>(detected); ++l) {
+                set_simd_level(static_cast<SimdLevel>(l));
+                Vector2Array<T> a(pts.data(), n);
+                Vector2Array<T> fast = normalize(a, Precision::fast), precise = normalize(a);
+                auto fl = length(a, Precision::fast);
+                Vector2Array<T> inplace = a;
+                inplace.normalize_inplace(Precision::fast);
+                for (std::size_t i = 0; i < n; ++i) {
+                    Vector2<double> e(pts[i].x, pts[i].y);
+                    double len = length(e);
+                    if (i == 5) {
+                        if (fast[i].x != 0 || fast[i].y != 0 || precise[i].x != 0 || fl[i] != 0)
+                            throw std::runtime_error("Zero vector not preserved by normalize");
+                        continue;
+                    }
+                    Vector2<double> u = e / len;
+                    Vector2<T> si = normalize(pts[i], Precision::fast);
+                    Vector2<double> f(fast[i].x, fast[i].y), pr(precise[i].x, precise[i].y), sc(si.x, si.y);
+                    if (length(f - u) > tol || length(sc - u) > tol || std::abs(fl[i] - len) > tol * len ||
+                        inplace[i].x != fast[i].x)
+                        throw std::runtime_error("Fast normalize error bound exceeded");
+                    if (length(pr - u) > (std::is_same_v<T, float> ? 4e-7 : 1e-15))
+                        throw std::runtime_error("Precise normalize incorrect");
+                }
+            }
+            set_simd_level(detected);
+        };
+        check(0.0);
+        check(0.0f);
+    });
+    run("Simpson-integrálás (integrate, IntegrationPolicy)", [] {
+        // Harmadfokú polinomra pontos
+        double cubic = integrate([](double x) { return x * x * x - 2 * x + 1; }, -1.0, 3.0, 10);
+        if (std::abs(cubic - 16.0) > 1e-12) throw std::runtime_error("Simpson not exact for cubic");
+
+        auto f = [](double x) { return std::exp(-x * x) * std::cos(x); };
+        auto fb = [&](const double* x, double* y, std::size_t n) {
+            for (std::size_t k = 0; k < n; ++k) y[k] = f(x[k]);
+        };
+        const double exact = 1.346387956803450;  // lásd korszam_01korr
+        double r = integrate(f, -1.0, 3.0, 1000000);
+        if (std::abs(r - exact) > 1e-13) throw std::runtime_error("Simpson integral inaccurate");
+
+        // Kis darabokkal sok feladat: szálszámtól és kötegelt integrandustól független, bitre azonos
+        IntegrationPolicy small;
+        small.chunk_nodes = 1000;
+        IntegrationPolicy serial = small;
+        serial.parallel = false;
+        unsigned threads = get_num_threads();
+        double rs = integrate(f, -1.0, 3.0, 100001, serial);
+        set_num_threads(4);
+        double rp = integrate(f, -1.0, 3.0, 100001, small);
+        double rb = integrate(fb, -1.0, 3.0, 100001, small);
+        set_num_threads(threads);
+        if (rs != rp || rs != rb) throw std::runtime_error("Simpson result depends on threads or batching");
+        if (std::abs(integrate(f, -1.0, 3.0, 3) - integrate(f, -1.0, 3.0, 4)) != 0)
+            throw std::runtime_error("Odd interval count not rounded up");
+    });
+    run("Sok intervallum egyszerre (integrate_batch)", [] {
+        auto f = [](double x) { return std::exp(-x * x) * std::cos(x); };
+        auto fb = [&](const double* x, double* y, std::size_t n) {
+            for (std::size_t k = 0; k < n; ++k) y[k] = f(x[k]);
+        };
+        // Több csoport, eltérő (páratlan, 0 és a darabméretnél nagyobb) n-ek
+        const std::size_t count = 300;
+        std::vector<double> a(count), b(count), r(count), rb(count), rs(count);
+        std::vector<long long> n(count);
+        for (std::size_t k = 0; k < count; ++k) {
+            a[k] = -3.0 + 0.01 * static_cast<double>(k);
+            b[k] = a[k] + 0.1 + 0.02 * static_cast<double>(k % 37);
+            n[k] = static_cast<long long>((k * 7919) % 500);
+        }
+        n[3] = 5000;
+        IntegrationPolicy small;
+        small.chunk_nodes = 1000;
+        IntegrationPolicy serial = small;
+        serial.parallel = false;
+        unsigned threads = get_num_threads();
+        set_num_threads(4);
+        integrate_batch(f, a.data(), b.data(), n.data(), r.data(), count, small);
+        integrate_batch(fb, a.data(), b.data(), n.data(), rb.data(), count, small);
+        set_num_threads(threads);
+        integrate_batch(f, a.data(), b.data(), n.data(), rs.data(), count, serial);
+        for (std::size_t k = 0; k < count; ++k) {
+            double one = integrate(f, a[k], b[k], n[k], serial);
+            if (std::abs(r[k] - one) > 1e-15 * std::max(1.0, std::abs(one)))
+                throw std::runtime_error("integrate_batch differs from integrate");
+            if (r[k] != rb[k] || r[k] != rs[k])
+                throw std::runtime_error("integrate_batch depends on threads or batching");
+        }
+        if (r[3] != integrate(f, a[3], b[3], n[3], small))
+            throw std::runtime_error("Long interval not delegated to integrate");
+
+        // Közös n, üres köteg
+        std::vector<double> u(count);
+        integrate_batch(f, a.data(), b.data(), 100, u.data(), count);
+        if (std::abs(u[count - 1] - integrate(f, a[count - 1], b[count - 1], 100)) > 1e-15)
+            throw std::runtime_error("integrate_batch with common n wrong");
+        integrate_batch(f, a.data(), b.data(), 100, u.data(), 0);
+    });
+    run("Adaptív kvadratúra (adaptive_simpson, gauss_kronrod)", [] {
+        long long calls = 0;
+        auto f = [&](double x) { ++calls; return std::exp(-x * x) * std::cos(x); };
+        const double exact = 1.346387956803450;
+        QuadratureOptions opt;
+        opt.abs_tol = 0.0;
+        opt.rel_tol = 1e-11;
+        for (int method = 0; method < 2; ++method) {
+            calls = 0;
+            QuadratureResult r = method == 0 ? adaptive_simpson(f, -1.0, 3.0, opt) : gauss_kronrod(f, -1.0, 3.0, opt);
+            if (!r.converged || std::abs(r.value - exact) > 1e-11 * exact || r.evaluations != calls)
+                throw std::runtime_error("Adaptive quadrature inaccurate or miscounted");
+            if (r.error > 1e-11 * exact || r.evaluations > 20000)
+                throw std::runtime_error("Adaptive quadrature error estimate or cost too large");
+        }
+
+        // Végponti gyökszingularitás: int_0^1 sqrt(x) dx = 2/3
+        auto g = [](double x) { return std::sqrt(x); };
+        QuadratureResult k = gauss_kronrod(g, 0.0, 1.0, opt);
+        if (!k.converged || std::abs(k.value - 2.0 / 3.0) > 1e-10 || k.intervals < 2)
+            throw std::runtime_error("G7K15 fails on endpoint singularity");
+
+        // A 3 pontos Simpson-becslés itt 0: a relatív tűrés mégis az 5 pontosra vonatkozik
+        auto h = [](double x) { double s = std::sin(3.14159265358979323846 * x); return s * s; };
+        QuadratureResult z = adaptive_simpson(h, 0.0, 2.0, opt);
+        if (!z.converged || std::abs(z.value - 1.0) > 1e-10 || z.evaluations > 20000)
+            throw std::runtime_error("adaptive_simpson stalls when the first estimate vanishes");
+
+        // Kifogyó keret: nem konvergált, de a becslés érvényes
+        opt.max_evaluations = 100;
+        QuadratureResult lim = adaptive_simpson(g, 0.0, 1.0, opt);
+        if (lim.converged || lim.evaluations > 100 || std::abs(lim.value - 2.0 / 3.0) > 1e-2)
+            throw std::runtime_error("Evaluation budget not respected");
+    });
+    run("Romberg-integrálás (Romberg, integrate_to)", [] {
+        long long calls = 0;
+        auto f = [&](double x) { ++calls; return std::exp(-x * x) * std::cos(x); };
+        const double exact = 1.346387956803450;
+        IntegrationPolicy serial;
+        serial.parallel = false;  // a számláló nem atomi
+        QuadratureOptions opt;
+        opt.abs_tol = 0.0;
+        opt.rel_tol = 1e-6;
+
+        Romberg r(f, -1.0, 3.0, serial);
+        QuadratureResult coarse = r.integrate_to(opt);
+        if (!coarse.converged || std::abs(coarse.value - exact) > 1e-6 * exact || coarse.evaluations != calls)
+            throw std::runtime_error("Romberg inaccurate or miscounted");
+        // Minden szinten csak az új felezőpontok: 2^k + 1 kiértékelés
+        if (coarse.evaluations != r.intervals() + 1)
+            throw std::runtime_error("Romberg re-evaluates old nodes");
+
+        // Folytatás szigorúbb tűréssel: a korábbi értékek újrahasznosulnak
+        opt.rel_tol = 1e-12;
+        QuadratureResult fine = r.integrate_to(opt);
+        if (!fine.converged || std::abs(fine.value - exact) > 1e-12 * exact || fine.evaluations != calls)
+            throw std::runtime_error("Resumed Romberg inaccurate");
+        long long resumed = calls;
+        calls = 0;
+        Romberg fresh(f, -1.0, 3.0, serial);
+        QuadratureResult direct = fresh.integrate_to(opt);
+        if (direct.value != fine.value || direct.evaluations != resumed)
+            throw std::runtime_error("Resumed Romberg differs from a direct run");
+
+        // Az első oszlop a trapéz-, a második a Simpson-szabály: köbös polinomra pontos
+        auto cubic = [](double x) { return x * x * x - 2.0 * x + 1.0; };
+        Romberg c(cubic, 0.0, 2.0);
+        c.refine();
+        c.refine();
+        if (std::abs(c.value() - 2.0) > 1e-14)
+            throw std::runtime_error("Romberg not exact for cubic");
+
+        // Kifogyó keret: megáll, nem konvergált
+        opt.max_evaluations = 100;
+        Romberg g([](double x) { return std::sqrt(x); }, 0.0, 1.0);
+        QuadratureResult lim = g.integrate_to(opt);
+        if (lim.converged || lim.evaluations > 100 || std::abs(lim.value - 2.0 / 3.0) > 1e-2)
+            throw std::runtime_error("Romberg evaluation budget not respected");
+    });
+    run("Padé exp/cos tömbökre (my_exp, my_cos, my_gauss_cos)", [] {
+        // Az eredeti (hatványokat újraszámoló) képletek
+        auto exp_ref = [](double z) {
+            return (1.0+0.5*z+0.1*z*z+(1.0/120.0)*z*z*z)/(1.0-0.5*z+0.1*z*z-(1.0/120.0)*z*z*z);
+        };
+        auto cos_ref = [](double w) {
+            return (1.0-w*w*(115.0/252.0)+w*w*w*w*(313.0/15120.0))/(1+w*w*(11.0/252.0)+w*w*w*w*(13.0/15120.0));
+        };
+        auto close = [](double a, double b) { return std::abs(a - b) <= 1e-14 * std::max(1.0, std::abs(b)); };
+        const std::size_t n = 1003;  // nem osztható a vektorszélességgel
+        std::vector<double> x(n), e(n), c(n), g(n);
+        for (std::size_t i = 0; i < n; ++i) x[i] = -3.0 + 6.0 * static_cast<double>(i) / (n - 1);
+        SimdLevel saved = simd_level();
+        for (SimdLevel lvl : {SimdLevel::scalar, SimdLevel::sse2, SimdLevel::avx2, SimdLevel::avx512}) {
+            if (lvl > detect_simd_level()) continue;
+            set_simd_level(lvl);
+            my_exp(x.data(), e.data(), n);
+            my_cos(x.data(), c.data(), n);
+            my_gauss_cos(x.data(), g.data(), n);
+            for (std::size_t i = 0; i < n; ++i) {
+                if (!close(e[i], exp_ref(x[i])) || !close(c[i], cos_ref(x[i])) ||
+                    !close(e[i], my_exp(x[i])) || !close(c[i], my_cos(x[i])))
+                    throw std::runtime_error("Padé array kernel differs from the scalar formula");
+                if (!close(g[i], exp_ref(-x[i] * x[i]) * cos_ref(x[i])) || !close(g[i], my_gauss_cos(x[i])))
+                    throw std::runtime_error("Fused exp(-x^2)cos(x) kernel wrong");
+            }
+        }
+        set_simd_level(saved);
+
+        // Helyben is működik
+        std::vector<double> inplace = x;
+        my_exp(inplace.data(), inplace.data(), n);
+        for (std::size_t i = 0; i < n; ++i)
+            if (!close(inplace[i], e[i])) throw std::runtime_error("In-place my_exp differs");
+
+        // Kis |x|-re a közelítés jó
+        if (std::abs(my_exp(0.1) - std::exp(0.1)) > 1e-9 || std::abs(my_cos(0.5) - std::cos(0.5)) > 1e-6)
+            throw std::runtime_error("Padé approximation inaccurate near 0");
+    });
+    run("Gyors exp/cos pontossági szintekkel (fastmath)", [] {
+        auto exp_ref = [](long double x) { return std::exp(x); };
+        auto cos_ref = [](long double x) { return std::cos(x); };
+        auto gc_ref = [](long double x) { return std::exp(-x * x) * std::cos(x); };
+        SimdLevel saved = simd_level();
+        for (SimdLevel lvl : {SimdLevel::scalar, SimdLevel::avx2, SimdLevel::avx512}) {
+            if (lvl > detect_simd_level()) continue;
+            set_simd_level(lvl);
+            for (MathAccuracy a : {MathAccuracy::low, MathAccuracy::medium, MathAccuracy::full}) {
+                double bound = math_accuracy_bound(a);
+                auto fe = [a](const double* x, double* y, std::size_t n) { fast_exp(x, y, n, a); };
+                auto fc = [a](const double* x, double* y, std::size_t n) { fast_cos(x, y, n, a); };
+                auto fg = [a](const double* x, double* y, std::size_t n) { fast_gauss_cos(x, y, n, a); };
+                MathErrorStats e = measure_error(fe, exp_ref, -745.0, 712.0, 20001, 20000);
+                MathErrorStats c = measure_error(fc, cos_ref, -1e3, 1e3, 20001, 20000);
+                MathErrorStats cl = measure_error(fc, cos_ref, -1e8, 1e8, 201, 200);  // std::cos ág is
+                MathErrorStats g = measure_error(fg, gc_ref, -1.0, 3.0, 20001, 20000);
+                if (e.max_rel_error > bound || e.mismatches || c.max_rel_error > bound || cl.max_rel_error > bound)
+                    throw std::runtime_error("fast_exp / fast_cos above the accuracy bound of the tier");
+                if (g.max_rel_error > 2.0 * bound)
+                    throw std::runtime_error("fast_gauss_cos above the accuracy bound of the tier");
+                // A skalár változat ugyanaz a közelítés
+                for (double x : {-700.0, -3.5, -0.2, 0.0, 1e-3, 2.5, 100.0, 700.0})
+                    if (std::abs(fast_exp(x, a) - std::exp(x)) > bound * std::exp(x) ||
+                        std::abs(fast_cos(x, a) - std::cos(x)) > bound ||
+                        std::abs(fast_gauss_cos(x, a) - std::exp(-x * x) * std::cos(x)) > 2.0 * bound)
+                        throw std::runtime_error("Scalar fast_exp / fast_cos wrong");
+            }
+        }
+        set_simd_level(saved);
+        MathErrorStats full = measure_error([](double x) { return fast_exp(x); }, exp_ref, -700.0, 700.0, 10001, 10000);
+        if (full.max_ulp_error > 2.0)
+            throw std::runtime_error("fast_exp (full) is not ~1 ulp");
+
+        // Speciális értékek, helyben számolás
+        double inf = std::numeric_limits<double>::infinity();
+        std::vector<double> v = {std::nan(""), inf, -inf, 710.0, -746.0, 1e300, -1e7};
+        std::vector<double> ye(v.size()), yc = v;
+        fast_exp(v.data(), ye.data(), v.size());
+        fast_cos(yc.data(), yc.data(), yc.size());
+        if (!std::isnan(ye[0]) || ye[1] != inf || ye[2] != 0.0 || ye[3] != inf || ye[4] != 0.0)
+            throw std::runtime_error("fast_exp special values wrong");
+        if (!std::isnan(yc[0]) || !std::isnan(yc[1]) || yc[5] != std::cos(1e300) || yc[6] != std::cos(-1e7))
+            throw std::runtime_error("fast_cos special values wrong");
+    });
+    run("C felület (libnumerics)", [] {
+        if (numerics_abi_version() != NUMERICS_ABI_VERSION)
+            throw std::runtime_error("ABI version mismatch");
+
+        // Szorzás a hívó pufferein: egy 5 x 6-os tömb 3 x 4-es blokkja, transzponált B
+        std::vector<double> big(30), bt(4 * 2), c(3 * 2, 7.0);
+        for (int i = 0; i < 30; ++i) big[i] = 0.5 * i - 3.0;
+        for (int i = 0; i < 8; ++i) bt[i] = 1.0 + i;
+        if (numerics_dgemm(0, 1, 3, 2, 4, 2.0, big.data() + 7, 6, bt.data(), 4, 0.5, c.data(), 2) != NUMERICS_OK)
+            throw std::runtime_error("numerics_dgemm failed");
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 2; ++j) {
+                double s = 0.5 * 7.0;
+                for (int p = 0; p < 4; ++p) s += 2.0 * big[(i + 1) * 6 + 1 + p] * bt[j * 4 + p];
+                if (std::abs(c[i * 2 + j] - s) > 1e-12) throw std::runtime_error("numerics_dgemm wrong");
+            }
+
+        // Megoldás, determináns, inverz: egyezik a Matrix<double> eredményével
+        Matrix<double> A(3, {2, -1, 0, -1, 2, -1, 0, -1, 2});
+        std::vector<double> a(A.data(), A.data() + 9), b = {1, 0, 1};
+        double det = 0;
+        std::vector<double> inv(9), lu = a;
+        if (numerics_ddet(3, lu.data(), 3, &det) != NUMERICS_OK || std::abs(det - A.determinant()) > 1e-12)
+            throw std::runtime_error("numerics_ddet wrong");
+        lu = a;
+        if (numerics_dinv(3, lu.data(), 3, inv.data(), 3) != NUMERICS_OK)
+            throw std::runtime_error("numerics_dinv failed");
+        Matrix<double> Ainv = A.inv();
+        for (int i = 0; i < 9; ++i)
+            if (std::abs(inv[i] - Ainv.data()[i]) > 1e-12) throw std::runtime_error("numerics_dinv wrong");
+        lu = a;
+        if (numerics_dgesv(3, lu.data(), 3, nullptr, b.data(), 1, 1) != NUMERICS_OK ||
+            std::abs(b[0] - 1) > 1e-12 || std::abs(b[1] - 1) > 1e-12 || std::abs(b[2] - 1) > 1e-12)
+            throw std::runtime_error("numerics_dgesv wrong");
+        std::vector<double> y(3, 1.0), x = {1, 1, 1};
+        if (numerics_dgemv(3, 3, 1.0, a.data(), 3, x.data(), -1.0, y.data()) != NUMERICS_OK ||
+            y[0] != 0.0 || y[1] != -1.0 || y[2] != 0.0)
+            throw std::runtime_error("numerics_dgemv wrong");
+
+        // Hibakódok
+        std::vector<double> sing = {1, 2, 2, 4};
+        std::vector<int> piv(2);
+        if (numerics_dgetrf(2, sing.data(), 2, piv.data()) != NUMERICS_ERROR_SINGULAR ||
+            numerics_dinv(2, sing.data(), 2, inv.data(), 1) != NUMERICS_ERROR_ARGUMENT ||
+            numerics_exp(x.data(), y.data(), 3, 7) != NUMERICS_ERROR_ARGUMENT ||
+            numerics_simpson(nullptr, nullptr, 0.0, 1.0, 10, &det) != NUMERICS_ERROR_ARGUMENT)
+            throw std::runtime_error("numerics error codes wrong");
+
+        // Integrálás C visszahívással; a user mutató eljut az integrandushoz
+        auto gauss_cos = [](const double* x, double* y, size_t n, void* user) {
+            double scale = *static_cast<double*>(user);
+            for (size_t k = 0; k < n; ++k) y[k] = scale * std::exp(-x[k] * x[k]) * std::cos(x[k]);
+        };
+        const double exact = 1.346387956803450;
+        double two = 2.0, v = 0;
+        numerics_quadrature_result r;
+        if (numerics_simpson(gauss_cos, &two, -1.0, 3.0, 1000000, &v) != NUMERICS_OK ||
+            std::abs(v - 2 * exact) > 1e-12 || std::abs(integrate(1000000, -1.0, 3.0) - exact) > 1e-12)
+            throw std::runtime_error("numerics_simpson wrong");
+        if (numerics_gauss_kronrod(gauss_cos, &two, -1.0, 3.0, nullptr, &r) != NUMERICS_OK || !r.converged ||
+            std::abs(r.value - 2 * exact) > 1e-9)
+            throw std::runtime_error("numerics_gauss_kronrod wrong");
+        numerics_quadrature_options opt;
+        numerics_quadrature_defaults(&opt);
+        if (numerics_romberg(gauss_cos, &two, -1.0, 3.0, &opt, &r) != NUMERICS_OK || !r.converged ||
+            numerics_adaptive_simpson(gauss_cos, &two, -1.0, 3.0, &opt, &r) != NUMERICS_OK ||
+            std::abs(r.value - 2 * exact) > 1e-9)
+            throw std::runtime_error("numerics_romberg / numerics_adaptive_simpson wrong");
+        std::vector<double> lo = {-1.0, 0.0}, hi = {3.0, 1.0}, out(2);
+        std::vector<int> nodes = {1000, 10};
+        integrate_batch(2, lo.data(), hi.data(), nodes.data(), 0, out.data());
+        if (std::abs(out[0] - integrate(1000, -1.0, 3.0)) > 1e-15 || std::abs(out[1] - integrate(10, 0.0, 1.0)) > 1e-15)
+            throw std::runtime_error("Legacy integrate_batch wrong");
+        if (numerics_simpson_batch(gauss_cos, &two, 2, lo.data(), hi.data(), nullptr, 1000, out.data()) != NUMERICS_OK ||
+            std::abs(out[0] - 2 * integrate(1000, -1.0, 3.0)) > 1e-14)
+            throw std::runtime_error("numerics_simpson_batch wrong");
+
+        // exp/cos tömbökre, ugyanazok a kernelek
+        std::vector<double> t = {-2.0, 0.1, 1.5}, e(3);
+        numerics_pade_exp(t.data(), e.data(), 3);
+        numerics_gauss_cos(t.data(), y.data(), 3, NUMERICS_ACCURACY_FULL);
+        for (int i = 0; i < 3; ++i)
+            if (std::abs(e[i] - my_exp(t[i])) > 1e-14 * std::abs(e[i]) || y[i] != fast_gauss_cos(t[i]))
+                throw std::runtime_error("numerics math kernels differ");
+    });
+    run("Ritka mátrixok (SparseMatrix, CSR / CSC)", [] {
+        // Hármasokból, ismétlődő és rendezetlen elemekkel
+        std::vector<Triplet<double>> t = {{1, 2, 3.0}, {0, 0, 1.0}, {1, 2, 0.5}, {2, 1, -2.0}, {0, 3, 4.0}, {2, 0, 5.0}};
+        for (SparseFormat f : {SparseFormat::csr, SparseFormat::csc}) {
+            SparseMatrix<double> A(3, 4, t, f);
+            if (A.nnz() != 5 || A(1, 2) != 3.5 || A(2, 1) != -2.0 || A(1, 1) != 0.0)
+                throw std::runtime_error("Sparse matrix from triplets wrong");
+            Matrix<double> D = A.to_dense();
+            SparseMatrix<double> back(D, f);
+            if (back.nnz() != 5 || back.values() != A.values() || back.inner_indices() != A.inner_indices())
+                throw std::runtime_error("Dense round trip changed the sparse structure");
+            SparseMatrix<double> other = f == SparseFormat::csr ? A.to_csc() : A.to_csr();
+            Matrix<double> T = A.transpose().to_dense(), Dt = D.transpose();
+            for (int i = 0; i < 3; ++i)
+                for (int j = 0; j < 4; ++j)
+                    if (other(i, j) != D(i, j) || T(j, i) != D(i, j))
+                        throw std::runtime_error("CSR / CSC conversion or transpose wrong");
+            std::vector<double> x = {1, -2, 3, 0.5}, xt = {2, 1, -1};
+            std::vector<double> y = A * x, yd = D * x, z = A.transpose_multiply(xt), zd = xt * D;
+            for (int i = 0; i < 3; ++i)
+                if (std::abs(y[i] - yd[i]) > 1e-14) throw std::runtime_error("SpMV wrong");
+            for (int j = 0; j < 4; ++j)
+                if (std::abs(z[j] - zd[j]) > 1e-14) throw std::runtime_error("Transpose SpMV wrong");
+            Matrix<double> B(4, 2, {1, 2, 3, 4, 5, 6, 7, 8}), L(2, 3, {1, 0, 2, -1, 3, 1});
+            Matrix<double> C = A * B, Cd = D * B, E = L * A, Ed = L * D;
+            for (int i = 0; i < 3; ++i)
+                for (int j = 0; j < 2; ++j)
+                    if (std::abs(C(i, j) - Cd(i, j)) > 1e-14) throw std::runtime_error("Sparse * dense wrong");
+            for (int i = 0; i < 2; ++i)
+                for (int j = 0; j < 4; ++j)
+                    if (std::abs(E(i, j) - Ed(i, j)) > 1e-14) throw std::runtime_error("Dense * sparse wrong");
+        }
+        bool thrown = false;
+        try { SparseMatrix<double>(2, 2, std::vector<Triplet<double>>{{2, 0, 1.0}}); } catch (std::out_of_range const&) { thrown = true; }
+        if (!thrown) throw std::runtime_error("Out-of-range triplet not rejected");
+        thrown = false;
+        try { SparseMatrix<double>(2, 3) * std::vector<double>(2); } catch (MatrixSizeMismatch const&) { thrown = true; }
+        if (!thrown) throw std::runtime_error("SpMV size mismatch not rejected");
+
+        // Nagy sávos + véletlen minta több szálon: egyezik a soros és a sűrű eredménnyel
+        const int n = 3000;
+        std::vector<Triplet<double>> big;
+        for (int i = 0; i < n; ++i) {
+            for (int j = std::max(0, i - 3); j <= std::min(n - 1, i + 3); ++j) big.push_back({i, j, std::sin(i + 0.3 * j)});
+            for (int k = 0; k < (i % 97 == 0 ? 400 : 5); ++k)  // néhány sűrű sor
+                big.push_back({i, static_cast<int>((i * 7919LL + k * 104729LL) % n), std::cos(0.7 * i - k)});
+        }
+        std::vector<double> x(n);
+        for (int i = 0; i < n; ++i) x[i] = std::sin(1.3 * i);
+        Matrix<double> D = SparseMatrix<double>(n, n, big).to_dense();
+        std::vector<double> yd = D * x, zd = x * D;
+        unsigned threads = get_num_threads();
+        for (SparseFormat f : {SparseFormat::csr, SparseFormat::csc}) {
+            SparseMatrix<double> A(n, n, big, f);
+            set_num_threads(1);
+            std::vector<double> y1 = A * x;
+            set_num_threads(4);
+            std::vector<double> y4 = A * x, z4 = A.transpose_multiply(x);
+            Matrix<double> B(n, 3, 1.0);
+            for (int i = 0; i < n; ++i) B(i, 1) = x[i];
+            Matrix<double> C = A * B;
+            set_num_threads(threads);
+            for (int i = 0; i < n; ++i) {
+                if (std::abs(y4[i] - yd[i]) > 1e-12 || std::abs(z4[i] - zd[i]) > 1e-12 || std::abs(C(i, 1) - yd[i]) > 1e-12)
+                    throw std::runtime_error("Parallel sparse kernels wrong");
+                if (f == SparseFormat::csr && y1[i] != y4[i])
+                    throw std::runtime_error("CSR SpMV depends on the thread count");
+            }
+            if (A.memory_bytes() * 20 > static_cast<std::size_t>(n) * n * sizeof(double))
+                throw std::runtime_error("Sparse storage not proportional to nnz");
+        }
+    });
+    run("Krylov-módszerek (cg, bicgstab, gmres, előkondicionálás)", [] {
+        // 2D Poisson (5 pontos) m x m rácson, és konvekcióval (nem szimmetrikus) változata
+        auto grid = [](int m, double convection) {
+            std::vector<Triplet<double>> t;
+            for (int i = 0; i < m; ++i)
+                for (int j = 0; j < m; ++j) {
+                    int k = i * m + j;
+                    t.push_back({k, k, 4.0});
+                    if (i > 0) t.push_back({k, k - m, -1.0 - convection});
+                    if (i + 1 < m) t.push_back({k, k + m, -1.0 + convection});
+                    if (j > 0) t.push_back({k, k - 1, -1.0});
+                    if (j + 1 < m) t.push_back({k, k + 1, -1.0});
+                }
+            return SparseMatrix<double>(m * m, m * m, t);
+        };
+        const int m = 40, n = m * m;
+        std::vector<double> x_exact(n);
+        for (int i = 0; i < n; ++i) x_exact[i] = std::sin(0.01 * i) + 1.0;
+        auto error = [&](std::vector<double> const& x) {
+            double e = 0;
+            for (int i = 0; i < n; ++i) e = std::max(e, std::abs(x[i] - x_exact[i]));
+            return e;
+        };
+        KrylovOptions<double> opt;
+        opt.rel_tol = 1e-10;
+        opt.record_history = true;
+
+        SparseMatrix<double> A = grid(m, 0.0);
+        std::vector<double> b = A * x_exact;
+        std::vector<double> x(n, 0.0);
+        KrylovResult<double> plain = cg(A, b, x, opt);
+        if (!plain.converged() || plain.relative_residual > 1e-10 || error(x) > 1e-7 ||
+            static_cast<int>(plain.history.size()) != plain.iterations || plain.matvecs != plain.iterations + 2)
+            throw std::runtime_error("CG on 2D Poisson wrong");
+        x.assign(n, 0.0);
+        KrylovResult<double> ilu = cg(A, b, x, opt, ILU0Preconditioner<double>(A));
+        if (!ilu.converged() || error(x) > 1e-7 || ilu.iterations >= plain.iterations)
+            throw std::runtime_error("ILU(0)-preconditioned CG not better");
+
+        // Sűrű mátrixon és mátrixmentes operátorral ugyanaz
+        Matrix<double> D = A.to_dense();
+        auto op = [&](double const* in, double* out) { A.multiply(in, out); };
+        std::vector<double> xd(n, 0.0), xf(n, 0.0);
+        KrylovResult<double> rd = cg(D, b, xd, opt, JacobiPreconditioner<double>(D));
+        KrylovResult<double> rf = cg(op, b, xf, opt, JacobiPreconditioner<double>(A));
+        if (!rd.converged() || !rf.converged() || error(xd) > 1e-7 || error(xf) > 1e-7)
+            throw std::runtime_error("CG on dense / matrix-free operator wrong");
+
+        // Nem szimmetrikus: BiCGSTAB és GMRES, előkondicionálással kevesebb lépés
+        SparseMatrix<double> C = grid(m, 0.4);
+        std::vector<double> c = C * x_exact;
+        for (int method = 0; method < 2; ++method) {
+            std::vector<double> x0(n, 0.0), x1(n, 0.0);
+            KrylovResult<double> r0 = method == 0 ? bicgstab(C, c, x0, opt) : gmres(C, c, x0, opt);
+            KrylovResult<double> r1 = method == 0 ? bicgstab(C, c, x1, opt, ILU0Preconditioner<double>(C))
+                                                  : gmres(C, c, x1, opt, ILU0Preconditioner<double>(C));
+            if (!r0.converged() || !r1.converged() || r0.relative_residual > 1e-9 || error(x0) > 1e-6 || error(x1) > 1e-6)
+                throw std::runtime_error("BiCGSTAB / GMRES on convection-diffusion wrong");
+            if (r1.iterations >= r0.iterations)
+                throw std::runtime_error("ILU(0) does not reduce BiCGSTAB / GMRES iterations");
+        }
+        // GMRES: a maradék nem nő, újraindítás után sem
+        std::vector<double> xg(n, 0.0);
+        opt.restart = 10;
+        KrylovResult<double> rg = gmres(C, c, xg, opt);
+        for (std::size_t i = 1; i < rg.history.size(); ++i)
+            if (rg.history[i] > rg.history[i - 1] * (1 + 1e-12) && i % 10 != 0)
+                throw std::runtime_error("GMRES residual increased within a cycle");
+        if (!rg.converged()) throw std::runtime_error("Restarted GMRES did not converge");
+
+        // Visszahívással leállítva, illetve a lépésszám elfogyásakor
+        int calls = 0;
+        opt.callback = [&](int it, double) { ++calls; return it < 5; };
+        x.assign(n, 0.0);
+        KrylovResult<double> st = cg(A, b, x, opt);
+        if (st.status != KrylovStatus::stopped || st.iterations != 5 || calls != 5)
+            throw std::runtime_error("Krylov callback did not stop the iteration");
+        opt.callback = nullptr;
+        opt.max_iterations = 3;
+        x.assign(n, 0.0);
+        if (bicgstab(C, c, x, opt).status != KrylovStatus::max_iterations)
+            throw std::runtime_error("Krylov max_iterations not respected");
+
+        bool thrown = false;
+        try { std::vector<double> bad(3); cg(A, b, bad, opt); } catch (MatrixSizeMismatch const&) { thrown = true; }
+        if (!thrown) throw std::runtime_error("Krylov size mismatch not rejected");
+    });
+    run("Cholesky- és LDL^T-felbontás (Cholesky, LDLT)", [] {
+        // SPD: B * B^T + n * I, több blokknyi méret; a felső háromszögbe szemetet írunk
+        const int n = 150;
+        Matrix<double> B(n), A(n);
+        for (int i = 0; i < n; ++i)
+            for (int j = 0; j < n; ++j) B(i, j) = std::sin(1.0 + i * 0.7 + j * 1.3);
+        A = B * B.transpose();
+        for (int i = 0; i < n; ++i) A(i, i) += n;
+        Matrix<double> lower_only = A;
+        for (int i = 0; i < n; ++i)
+            for (int j = i + 1; j < n; ++j) lower_only(i, j) = 1e300;
+        unsigned threads = get_num_threads();
+        set_num_threads(4);
+        Cholesky<double> ch(lower_only);
+        set_num_threads(threads);
+        if (!ch.positive_definite()) throw std::runtime_error("SPD matrix rejected by Cholesky");
+        if (ch.factors()(0, n - 1) != 1e300) throw std::runtime_error("Cholesky touched the upper triangle");
+
+        Matrix<double> L = ch.lower(), LLt = L * L.transpose();
+        for (int i = 0; i < n; ++i)
+            for (int j = 0; j < n; ++j)
+                if (std::abs(LLt(i, j) - A(i, j)) > 1e-10 * n) throw std::runtime_error("L * L^T != A");
+        std::vector<double> b(n);
+        for (int i = 0; i < n; ++i) b[i] = std::cos(0.1 * i);
+        std::vector<double> x = ch.solve(b), xl = LU<double>(A).solve(b);
+        for (int i = 0; i < n; ++i)
+            if (std::abs(x[i] - xl[i]) > 1e-12) throw std::runtime_error("Cholesky solve differs from LU");
+        // A det() itt túlcsordulna: log |det| az LU főátlójából
+        auto lu_log_det = [](Matrix<double> const& M) {
+            LU<double> f(M);
+            double s = 0;
+            for (int i = 0; i < M.rows(); ++i) s += std::log(std::abs(f.factors()(i, i)));
+            return s;
+        };
+        if (std::abs(ch.log_det() - lu_log_det(A)) > 1e-12 * std::abs(ch.log_det()))
+            throw std::runtime_error("Cholesky log_det wrong");
+        Matrix<double> I = ch.inverse() * A;
+        for (int i = 0; i < n; ++i)
+            for (int j = 0; j < n; ++j)
+                if (std::abs(I(i, j) - (i == j ? 1.0 : 0.0)) > 1e-10) throw std::runtime_error("Cholesky inverse wrong");
+
+        // Nem SPD: felismeri, a megoldó kivételt dob
+        Matrix<double> indef(3, {2, 1, 0, 1, -3, 1, 0, 1, 4});
+        Cholesky<double> bad(indef);
+        bool thrown = false;
+        try { bad.solve(std::vector<double>(3, 1.0)); } catch (std::runtime_error const&) { thrown = true; }
+        if (bad.positive_definite() || !thrown) throw std::runtime_error("Non-SPD matrix not detected");
+        thrown = false;
+        try { bad.det(); } catch (std::runtime_error const&) { thrown = true; }
+        if (!thrown) throw std::runtime_error("Cholesky det() of a non-SPD matrix not rejected");
+
+        // LDL^T indefinit mátrixra: megoldás, determináns, tehetetlenség
+        LDLT<double> ld(indef);
+        std::vector<double> y = ld.solve(std::vector<double>{1, 2, 3}), r = indef * y;
+        if (std::abs(r[0] - 1) > 1e-12 || std::abs(r[1] - 2) > 1e-12 || std::abs(r[2] - 3) > 1e-12)
+            throw std::runtime_error("LDL^T solve wrong");
+        if (std::abs(ld.det() - indef.determinant()) > 1e-12 || ld.inertia() != std::make_pair(2, 1) || ld.det_sign() != -1)
+            throw std::runtime_error("LDL^T det or inertia wrong");
+
+        // Nagy, blokkosított indefinit eset: a páros főátlóelemekből 3n-t levonva negatív sajátértékek is lesznek
+        Matrix<double> S = A;
+        for (int i = 0; i < n; i += 2) S(i, i) -= 3.0 * n;
+        LDLT<double> big(S);
+        Matrix<double> X = big.inverse() * S;
+        for (int i = 0; i < n; ++i)
+            for (int j = 0; j < n; ++j)
+                if (std::abs(X(i, j) - (i == j ? 1.0 : 0.0)) > 1e-8) throw std::runtime_error("Blocked LDL^T inverse wrong");
+        if (std::abs(big.log_abs_det() - lu_log_det(S)) > 1e-12 * std::abs(big.log_abs_det()))
+            throw std::runtime_error("LDL^T log_abs_det wrong");
+        if (!LDLT<double>(Matrix<double>(2, {0, 1, 1, 0})).singular())
+            throw std::runtime_error("LDL^T zero pivot not reported");
+    });
+    run("Szimmetrikus, háromszög- és sávmátrixok (tömör tárolás)", [] {
+        // Minden szerkezetet a sűrű megfelelőjével vetünk össze
+        const int n = 120;
+        auto close = [](Matrix<double> const& a, Matrix<double> const& b, double tol) {
+            for (int i = 0; i < a.rows(); ++i)
+                for (int j = 0; j < a.cols(); ++j)
+                    if (std::abs(a(i, j) - b(i, j)) > tol) return false;
+            return true;
+        };
+        auto close_vec = [](std::vector<double> const& a, std::vector<double> const& b, double tol) {
+            for (std::size_t i = 0; i < a.size(); ++i)
+                if (std::abs(a[i] - b[i]) > tol) return false;
+            return a.size() == b.size();
+        };
+        Matrix<double> A(n), B = Matrix<double>::zeros(n, 3);
+        for (int i = 0; i < n; ++i)
+            for (int j = 0; j < n; ++j) A(i, j) = std::sin(1.0 + i * 0.7 + j * 1.3);
+        for (int i = 0; i < n; ++i)
+            for (int j = 0; j < 3; ++j) B(i, j) = std::cos(0.3 * i + j);
+        std::vector<double> x(n);
+        for (int i = 0; i < n; ++i) x[i] = std::cos(0.1 * i);
+
+        // Szimmetrikus: az alsó háromszögből, fele memória, (i, j) == (j, i)
+        PackedSymmetricMatrix<double> S(A);
+        Matrix<double> Sd = S.to_dense();
+        for (int i = 0; i < n; ++i)
+            for (int j = 0; j <= i; ++j)
+                if (Sd(i, j) != A(i, j) || Sd(j, i) != A(i, j)) throw std::runtime_error("Packed symmetric storage wrong");
+        if (S.memory_bytes() != sizeof(double) * n * (n + 1) / 2) throw std::runtime_error("Packed symmetric size wrong");
+        if (!close_vec(S * x, Sd * x, 1e-12) || !close(S * B, Sd * B, 1e-12))
+            throw std::runtime_error("Packed symmetric product wrong");
+        // Nagyobb mátrixnál sávokra bontva, a szálszámtól függetlenül ugyanaz
+        const int m = 1000;
+        PackedSymmetricMatrix<double> Sb(m);
+        for (int i = 0; i < m; ++i)
+            for (int j = 0; j <= i; ++j) Sb(i, j) = std::sin(0.37 * i + 0.11 * j);
+        std::vector<double> xb(m);
+        for (int i = 0; i < m; ++i) xb[i] = std::cos(0.01 * i);
+        unsigned threads = get_num_threads();
+        set_num_threads(4);
+        std::vector<double> y4 = Sb * xb;
+        set_num_threads(1);
+        std::vector<double> y1 = Sb * xb;
+        set_num_threads(threads);
+        if (y4 != y1 || !close_vec(y1, Sb.to_dense() * xb, 1e-10))
+            throw std::runtime_error("Packed symmetric product (split) wrong");
+        S(0, 5) = 42.0;
+        if (S(5, 0) != 42.0) throw std::runtime_error("Packed symmetric write not mirrored");
+
+        // Háromszög: szorzás és megoldás, mindkét háromszögre
+        for (Triangle t : {Triangle::lower, Triangle::upper}) {
+            Matrix<double> D = A;
+            for (int i = 0; i < n; ++i) D(i, i) += n;
+            TriangularMatrix<double> Tm(D, t);
+            Matrix<double> Td = Tm.to_dense();
+            for (int i = 0; i < n; ++i)
+                for (int j = 0; j < n; ++j)
+                    if (Td(i, j) != ((t == Triangle::lower ? j <= i : j >= i) ? D(i, j) : 0.0))
+                        throw std::runtime_error("Triangular storage wrong");
+            if (!close_vec(Tm * x, Td * x, 1e-12) || !close(Tm * B, Td * B, 1e-12))
+                throw std::runtime_error("Triangular product wrong");
+            if (!close_vec(Td * Tm.solve(x), x, 1e-12) || !close(Td * Tm.solve(B), B, 1e-12))
+                throw std::runtime_error("Triangular solve wrong");
+        }
+        bool thrown = false;
+        try { TriangularMatrix<double>(3, Triangle::lower).at(0, 2) = 1; } catch (std::out_of_range const&) { thrown = true; }
+        if (!thrown) throw std::runtime_error("Write outside the triangle not rejected");
+        thrown = false;
+        try { TriangularMatrix<double>(3, Triangle::upper).solve(std::vector<double>(3, 1.0)); } catch (std::runtime_error const&) { thrown = true; }
+        if (!thrown) throw std::runtime_error("Singular triangular matrix not rejected");
+
+        // Sávmátrix: a sávon kívül nulla; az LU főelemcserével is a sávban marad
+        const int kl = 3, ku = 2;
+        BandMatrix<double> Bm(A, kl, ku);
+        Matrix<double> Bd = Bm.to_dense();
+        for (int i = 0; i < n; ++i)
+            for (int j = 0; j < n; ++j)
+                if (Bd(i, j) != (i - j <= kl && j - i <= ku ? A(i, j) : 0.0)) throw std::runtime_error("Band storage wrong");
+        if (Bm.memory_bytes() != sizeof(double) * n * (kl + ku + 1)) throw std::runtime_error("Band storage size wrong");
+        if (!close_vec(Bm * x, Bd * x, 1e-12) || !close(Bm * B, Bd * B, 1e-12))
+            throw std::runtime_error("Band product wrong");
+        // A főátló kicsi: sorcsere nélkül nem menne
+        for (int i = 0; i < n; ++i) Bm.at(i, i) = 1e-3 * std::sin(i + 0.5);
+        Bd = Bm.to_dense();
+        BandLU<double> blu(Bm);
+        std::vector<double> y = blu.solve(x), yl = LU<double>(Bd).solve(x);
+        if (blu.singular() || !close_vec(y, yl, 1e-8) || !close_vec(Bd * y, x, 1e-10))
+            throw std::runtime_error("Band LU solve wrong");
+        if (!close(Bd * blu.solve(B), B, 1e-10)) throw std::runtime_error("Band LU multiple right-hand sides wrong");
+        Matrix<double> small(5);
+        for (int i = 0; i < 5; ++i)
+            for (int j = std::max(0, i - 1); j <= std::min(4, i + 2); ++j) small(i, j) = 1.0 + i + 2 * j % 3;
+        if (std::abs(BandLU<double>(BandMatrix<double>(small, 1, 2)).det() - small.determinant()) > 1e-10)
+            throw std::runtime_error("Band LU determinant wrong");
+        if (!BandLU<double>(BandMatrix<double>(Matrix<double>(4, 0.0), 1, 1)).singular())
+            throw std::runtime_error("Singular band matrix not reported");
+
+        // Háromátlós: Thomas-algoritmus, egyezik a sávos LU-val
+        TridiagonalMatrix<double> T3(n);
+        for (int i = 0; i < n; ++i) T3.diagonal()[i] = 4.0 + std::sin(i);
+        for (int i = 0; i + 1 < n; ++i) {
+            T3.lower()[i] = -1.0 + 0.1 * std::cos(i);
+            T3.upper()[i] = -1.0;
+        }
+        Matrix<double> T3d = T3.to_dense();
+        std::vector<double> z = T3.solve(x);
+        if (!close_vec(T3 * x, T3d * x, 1e-12) || !close_vec(T3d * z, x, 1e-12) ||
+            !close_vec(z, BandLU<double>(T3.to_band()).solve(x), 1e-12) || !close(T3d * T3.solve(B), B, 1e-12))
+            throw std::runtime_error("Tridiagonal (Thomas) solve wrong");
+        // Nulla főelemnél kivétel, a sávos LU főelemcserével megoldja
+        TridiagonalMatrix<double> P({1.0}, {0.0, 0.0}, {1.0});
+        thrown = false;
+        try { P.solve(std::vector<double>{1, 2}); } catch (std::runtime_error const&) { thrown = true; }
+        std::vector<double> w = BandLU<double>(P.to_band()).solve(std::vector<double>{1, 2});
+        if (!thrown || std::abs(w[0] - 2) > 1e-15 || std::abs(w[1] - 1) > 1e-15)
+            throw std::runtime_error("Tridiagonal zero pivot handling wrong");
+    });
+    run("Strassen–Winograd-szorzás (strassen_multiply, MultiplyAlgorithm)", [] {
+        // Kis levágási határral több szint, páratlan és téglalap méretekkel (lehántás)
+        auto fill = [](int r, int c, double s) {
+            Matrix<double> m(r, c, 0.0);
+            for (int i = 0; i < r; ++i)
+                for (int j = 0; j < c; ++j) m(i, j) = std::sin(s + 0.37 * i + 0.91 * j);
+            return m;
+        };
+        int dims[][3] = {{64, 64, 64}, {100, 77, 129}, {65, 97, 33}, {131, 130, 67}, {16, 200, 40}};
+        for (auto const& d : dims) {
+            Matrix<double> A = fill(d[0], d[2], 0.1), B = fill(d[2], d[1], 0.7);
+            Matrix<double> C = A * B, S = strassen_multiply(A, B, 16);
+            for (int i = 0; i < C.rows(); ++i)
+                for (int j = 0; j < C.cols(); ++j)
+                    if (std::abs(C(i, j) - S(i, j)) > 1e-11) throw std::runtime_error("Strassen product differs from classical");
+            StrassenError<double> e = strassen_error(A, B, 16);
+            if (e.levels != matrix_kernels::strassen_levels(d[0], d[1], d[2], 16) || e.relative > 1e-13)
+                throw std::runtime_error("Strassen error report wrong");
+        }
+        if (strassen_error(fill(131, 67, 0.1), fill(67, 130, 0.7), 16).levels != 2)
+            throw std::runtime_error("Strassen recursion depth wrong");
+
+        // Bekapcsolt módban a Matrix és a nézetek (transzponált is) szorzása is ezt használja
+        Matrix<double> A = fill(90, 70, 0.3), B = fill(90, 50, 0.5);
+        Matrix<double> ref = A.transpose() * B;
+        set_multiply_algorithm(MultiplyAlgorithm::strassen);
+        set_strassen_cutoff(16);
+        bool on = matrix_kernels::use_strassen<double>(70, 50, 90) && !matrix_kernels::use_strassen<int>(70, 50, 90);
+        Matrix<double> const& Ac = A;
+        Matrix<double> viaview = multiply(Ac.view().t(), B.view()), viamatrix = A.transpose() * B;
+        set_multiply_algorithm(MultiplyAlgorithm::classical);
+        set_strassen_cutoff(512);
+        if (!on || matrix_kernels::use_strassen<double>(4096, 4096, 4096))
+            throw std::runtime_error("Strassen mode switch wrong");
+        for (int i = 0; i < ref.rows(); ++i)
+            for (int j = 0; j < ref.cols(); ++j)
+                if (std::abs(viaview(i, j) - ref(i, j)) > 1e-11 || std::abs(viamatrix(i, j) - ref(i, j)) > 1e-11)
+                    throw std::runtime_error("Strassen mode product wrong");
+
+        bool thrown = false;
+        try { set_strassen_cutoff(4); } catch (std::invalid_argument const&) { thrown = true; }
+        if (!thrown) throw std::runtime_error("Too small Strassen cutoff accepted");
+    });
 }
 
 int main() {
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "pool_allocator.h"
+
+/*
+ Munkalopó (work-stealing) szálkészlet a párhuzamos mátrixműveletekhez
+
+ Minden munkásszálnak saját feladatsora van: a saját sor végéről vesz
+ (LIFO, jó cache-lokalitás), üresjáratban a többiek elejéről lop (FIFO).
+ A parallel_for-t hívó szál sem tétlen: amíg a csoportja el nem készül,
+ maga is feladatokat hajt végre, így az egymásba ágyazott hívás sem akad el.
+
+ Szálszám: MATRIX_NUM_THREADS környezeti változó, vagy set_num_threads(),
+ alapértelmezés a hardveres szálak száma. 1 szálnál minden sorosan fut.
+*/
+class ThreadPool {
+    struct TaskGroup {
+        std::atomic<int> pending{0};
+        std::mutex error_mutex;
+        std::exception_ptr error;
+    };
+
+    struct Task {
+        std::function<void()> fn;
+        TaskGroup* group = nullptr;
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Worker>> queues_;   // munkásonként egy sor + egy a külső hívóknak
+    std::vector<std::thread> threads_;
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    std::atomic<int> queued_{0};
+    std::atomic<unsigned> next_queue_{0};
+    bool stop_ = false;
+
+    static int& worker_index() {
+        static thread_local int index = -1;
+        return index;
+    }
+
+    void push(Task task, std::size_t q) {
+        {
+            std::lock_guard<std::mutex> lock(queues_[q]->mutex);
+            queues_[q]->tasks.push_back(std::move(task));
+        }
+        queued_.fetch_add(1);
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        wake_.notify_one();
+    }
+
+    // Először a saját sor végéről, aztán a többiek elejéről próbálunk venni
+    bool try_pop(std::size_t self, Task& out) {
+        {
+            Worker& w = *queues_[self];
+            std::lock_guard<std::mutex> lock(w.mutex);
+            if (!w.tasks.empty()) {
+                out = std::move(w.tasks.back());
+                w.tasks.pop_back();
+                queued_.fetch_sub(1);
+                return true;
+            }
+        }
+        for (std::size_t k = 1; k < queues_.size(); ++k) {
+            Worker& w = *queues_[(self + k) % queues_.size()];
+            std::lock_guard<std::mutex> lock(w.mutex);
+            if (!w.tasks.empty()) {
+                out = std::move(w.tasks.front());
+                w.tasks.pop_front();
+                queued_.fetch_sub(1);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static void run(Task& task) {
+        try {
+            task.fn();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(task.group->error_mutex);
+            if (!task.group->error) task.group->error = std::current_exception();
+        }
+        task.group->pending.fetch_sub(1);
+    }
+
+    void worker_loop(int index) {
+        worker_index() = index;
+        Task task;
+        for (;;) {
+            if (try_pop(index, task)) {
+                run(task);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleep_mutex_);
+            wake_.wait(lock, [this] { return stop_ || queued_.load() > 0; });
+            if (stop_ && queued_.load() == 0) {
+                release_thread_cache();
+                return;
+            }
+        }
+    }
+
+    std::size_t own_queue() const {
+        int w = worker_index();
+        return w >= 0 ? static_cast<std::size_t>(w) : queues_.size() - 1;
+    }
+
+public:
+    explicit ThreadPool(unsigned threads) {
+        threads = std::max(1u, threads);
+        // A hívó szál is dolgozik, ezért threads-1 munkást indítunk
+        for (unsigned i = 0; i < threads; ++i)
+            queues_.push_back(std::make_unique<Worker>());
+        for (unsigned i = 0; i + 1 < threads; ++i)
+            threads_.emplace_back([this, i] { worker_loop(static_cast<int>(i)); });
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (auto& t : threads_) t.join();
+    }
+
+    ThreadPool(ThreadPool const&) = delete;
+    ThreadPool& operator=(ThreadPool const&) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(threads_.size() + 1); }
+
+    /*
+     f(lo, hi) hívása a [begin, end) tartomány legalább grain méretű darabjaira
+     Ha csak egy darab jutna, vagy egyszálú a készlet, helyben, sorosan fut.
+     Az első kivételt a hívó szálon dobjuk tovább, miután minden darab végzett.
+    */
+    template<typename F>
+    void parallel_for(int begin, int end, int grain, F&& f) {
+        int count = end - begin;
+        if (count <= 0) return;
+        grain = std::max(1, grain);
+        int chunks = std::min((count + grain - 1) / grain, static_cast<int>(4 * size()));
+        if (chunks <= 1 || size() == 1) {
+            f(begin, end);
+            return;
+        }
+
+        TaskGroup group;
+        group.pending.store(chunks);
+        std::size_t self = own_queue();
+        for (int c = 0; c < chunks; ++c) {
+            int lo = begin + static_cast<int>(static_cast<long long>(count) * c / chunks);
+            int hi = begin + static_cast<int>(static_cast<long long>(count) * (c + 1) / chunks);
+            // Külső hívónál körbeosztjuk a sorokra, munkásnál a sajátjába tesszük (onnan lopnak)
+            std::size_t q = worker_index() >= 0 ? self : next_queue_.fetch_add(1) % queues_.size();
+            push(Task{[&f, lo, hi] { f(lo, hi); }, &group}, q);
+        }
+
+        Task task;
+        while (group.pending.load() > 0) {
+            if (try_pop(self, task))
+                run(task);
+            else
+                std::this_thread::yield();
+        }
+        if (group.error) std::rethrow_exception(group.error);
+    }
+
+    static ThreadPool& global() { return *global_slot(); }
+
+    static std::unique_ptr<ThreadPool>& global_slot() {
+        static std::unique_ptr<ThreadPool> pool = std::make_unique<ThreadPool>(default_threads());
+        return pool;
+    }
+
+    static unsigned default_threads() {
+        if (const char* env = std::getenv("MATRIX_NUM_THREADS")) {
+            int n = std::atoi(env);
+            if (n > 0) return static_cast<unsigned>(n);
+        }
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+};
+
+/*
+ A globális készlet szálszámának beállítása (nem hívható párhuzamos szakaszon belül)
+ A régi munkásszálak kilépéskor, a hívó szál itt adja vissza a félretett blokkjait.
+*/
+inline void set_num_threads(unsigned n) {
+    ThreadPool::global_slot() = std::make_unique<ThreadPool>(std::max(1u, n));
+    release_thread_cache();
+}
+
+inline unsigned get_num_threads() {
+    return ThreadPool::global().size();
+}
+
+template<typename F>
+void parallel_for(int begin, int end, int grain, F&& f) {
+    ThreadPool::global().parallel_for(begin, end, grain, std::forward<F>(f));
+}
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+#include "cpu_features.h"
+#include "thread_pool.h"
+
+/*
+ Blokkosított, gyorsítótár-független (cache-oblivious) transzponálás
+
+ A naiv dst(j, i) = src(i, j) ciklus az egyik oldalt oszloponként járja be,
+ így nagy n-nél minden írás (vagy olvasás) új gyorsítótár-sort és TLB-lapot
+ érint. Itt a feladatot rekurzívan mindig a hosszabbik oldal mentén felezzük,
+ amíg egy levél (transpose_tile x transpose_tile) el nem fér L1-ben; a levélen
+ belül regiszterben transzponált kis blokkok (double: 4x4, float: 8x8, AVX)
+ mennek, a maradék sorok és oszlopok skalárisan.
+
+ A helyben transzponálás (négyzetes mátrixra) blokkpárokat cserél:
+ az (I, J) és (J, I) blokkot egyszerre olvassuk és transzponálva írjuk vissza,
+ ideiglenes tárolóként csak a veremre tett mikroblokk kell, heapfoglalás nincs.
+*/
+namespace matrix_kernels {
+
+// Levélméret (double-re 2 x 32 x 32 x 8 B = 16 KiB, elfér L1-ben)
+constexpr int transpose_tile = 32;
+
+// Ennél kisebb mátrixot nem osztunk szét szálakra
+constexpr long long transpose_parallel_threshold = 1 << 16;
+
+// Mikroblokk: d(j, i) = s(i, j), size x size, sorhosszak lds és ldd
+template<typename T>
+using transpose_micro_fn = void (*)(const T*, int, T*, int);
+
+#ifdef MATRIX_X86_DISPATCH
+// 4x4 double: párok összefésülése, majd a 128 bites felek cseréje
+__attribute__((target("avx2")))
+inline void transpose_micro_avx(const double* s, int lds, double* d, int ldd) {
+    __m256d r0 = _mm256_loadu_pd(s);
+    __m256d r1 = _mm256_loadu_pd(s + lds);
+    __m256d r2 = _mm256_loadu_pd(s + 2 * lds);
+    __m256d r3 = _mm256_loadu_pd(s + 3 * lds);
+    __m256d t0 = _mm256_unpacklo_pd(r0, r1);  // a0 b0 a2 b2
+    __m256d t1 = _mm256_unpackhi_pd(r0, r1);  // a1 b1 a3 b3
+    __m256d t2 = _mm256_unpacklo_pd(r2, r3);
+    __m256d t3 = _mm256_unpackhi_pd(r2, r3);
+    _mm256_storeu_pd(d, _mm256_permute2f128_pd(t0, t2, 0x20));
+    _mm256_storeu_pd(d + ldd, _mm256_permute2f128_pd(t1, t3, 0x20));
+    _mm256_storeu_pd(d + 2 * ldd, _mm256_permute2f128_pd(t0, t2, 0x31));
+    _mm256_storeu_pd(d + 3 * ldd, _mm256_permute2f128_pd(t1, t3, 0x31));
+}
+
+// 8x8 float: unpack, shuffle, majd a 128 bites felek cseréje
+__attribute__((target("avx2")))
+inline void transpose_micro_avx(const float* s, int lds, float* d, int ldd) {
+    __m256 r[8], t[8], u[8];
+    for (int i = 0; i < 8; ++i) r[i] = _mm256_loadu_ps(s + i * lds);
+    for (int i = 0; i < 8; i += 2) {
+        t[i] = _mm256_unpacklo_ps(r[i], r[i + 1]);
+        t[i + 1] = _mm256_unpackhi_ps(r[i], r[i + 1]);
+    }
+    for (int i = 0; i < 8; i += 4) {
+        u[i] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(1, 0, 1, 0));
+        u[i + 1] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(3, 2, 3, 2));
+        u[i + 2] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(1, 0, 1, 0));
+        u[i + 3] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(3, 2, 3, 2));
+    }
+    for (int i = 0; i < 4; ++i) {
+        _mm256_storeu_ps(d + i * ldd, _mm256_permute2f128_ps(u[i], u[i + 4], 0x20));
+        _mm256_storeu_ps(d + (i + 4) * ldd, _mm256_permute2f128_ps(u[i], u[i + 4], 0x31));
+    }
+}
+#endif
+
+// A mikroblokk mérete T-re (0: nincs SIMD kernel, minden skalárisan fut)
+template<typename T>
+constexpr int transpose_micro_size() {
+#ifdef MATRIX_X86_DISPATCH
+    if constexpr (std::is_same_v<T, double>) return 4;
+    if constexpr (std::is_same_v<T, float>) return 8;
+#endif
+    return 0;
+}
+
+template<typename T>
+transpose_micro_fn<T> select_transpose_micro() {
+#ifdef MATRIX_X86_DISPATCH
+    if constexpr (transpose_micro_size<T>() > 0)
+        if (cpu_has_avx2_fma())
+            return static_cast<transpose_micro_fn<T>>(&transpose_micro_avx);
+#endif
+    return nullptr;
+}
+
+// Levél: rows x cols-os s-ből d-be, teljes mikroblokkok SIMD-del, a szélek skalárisan
+template<typename T>
+void transpose_leaf(int rows, int cols, const T* s, int lds, T* d, int ldd,
+                    transpose_micro_fn<T> micro) {
+    constexpr int mb = transpose_micro_size<T>();
+    int rows_main = 0, cols_main = 0;
+    if (micro) {
+        rows_main = rows / mb * mb;
+        cols_main = cols / mb * mb;
+        for (int i = 0; i < rows_main; i += mb)
+            for (int j = 0; j < cols_main; j += mb)
+                micro(s + i * lds + j, lds, d + j * ldd + i, ldd);
+    }
+    for (int i = 0; i < rows; ++i) {
+        int j0 = i < rows_main ? cols_main : 0;
+        for (int j = j0; j < cols; ++j)
+            d[j * ldd + i] = s[i * lds + j];
+    }
+}
+
+// Rekurzív felezés a hosszabbik oldal mentén, mikroblokk-határra kerekítve
+template<typename T>
+void transpose_recursive(int rows, int cols, const T* s, int lds, T* d, int ldd,
+                         transpose_micro_fn<T> micro) {
+    constexpr int align = transpose_micro_size<T>() > 0 ? transpose_micro_size<T>() : 1;
+    if (rows <= transpose_tile && cols <= transpose_tile) {
+        transpose_leaf(rows, cols, s, lds, d, ldd, micro);
+    } else if (rows >= cols) {
+        int half = std::max(align, rows / 2 / align * align);
+        transpose_recursive(half, cols, s, lds, d, ldd, micro);
+        transpose_recursive(rows - half, cols, s + half * lds, lds, d + half, ldd, micro);
+    } else {
+        int half = std::max(align, cols / 2 / align * align);
+        transpose_recursive(rows, half, s, lds, d, ldd, micro);
+        transpose_recursive(rows, cols - half, s + half, lds, d + half * ldd, ldd, micro);
+    }
+}
+
+/*
+ d = s^T: s rows x cols (sorhossz lds), d cols x rows (sorhossz ldd)
+ Nagy mátrixnál s levélmagas sávjait a szálkészlet osztja szét,
+ a sávokon belül a rekurzió dolgozik.
+*/
+template<typename T>
+void transpose(int rows, int cols, const T* s, int lds, T* d, int ldd) {
+    transpose_micro_fn<T> micro = select_transpose_micro<T>();
+    if (static_cast<long long>(rows) * cols < transpose_parallel_threshold) {
+        transpose_recursive(rows, cols, s, lds, d, ldd, micro);
+        return;
+    }
+    int strips = (rows + transpose_tile - 1) / transpose_tile;
+    parallel_for(0, strips, 1, [&](int b0, int b1) {
+        int r0 = b0 * transpose_tile, r1 = std::min(rows, b1 * transpose_tile);
+        transpose_recursive(r1 - r0, cols, s + r0 * lds, lds, d + r0, ldd, micro);
+    });
+}
+
+/*
+ Helyben transzponálás, n x n (sorhossz lda)
+ Az I. blokksor feldolgozza a J >= I blokkpárokat; a mikroblokk-párokat
+ egy veremre tett mikroblokkon át cseréljük. A mikroblokkba nem férő
+ utolsó (n % mb) oszlop és sor elemenként cserélődik.
+*/
+template<typename T>
+void transpose_inplace(int n, T* a, int lda) {
+    constexpr int mb = transpose_micro_size<T>() > 0 ? transpose_micro_size<T>() : 1;
+    transpose_micro_fn<T> micro = select_transpose_micro<T>();
+    int n_main = micro ? n / mb * mb : 0;
+    int tiles = (n + transpose_tile - 1) / transpose_tile;
+
+    auto tile_row = [&](int ti) {
+        int i0 = ti * transpose_tile, i1 = std::min(n, i0 + transpose_tile);
+        for (int j0 = i0; j0 < n; j0 += transpose_tile) {
+            int j1 = std::min(n, j0 + transpose_tile);
+            if (micro) {
+                alignas(64) T tmp[mb * mb];
+                for (int i = i0; i < std::min(i1, n_main); i += mb)
+                    for (int j = std::max(j0, i); j < std::min(j1, n_main); j += mb) {
+                        T* aij = a + i * lda + j;
+                        T* aji = a + j * lda + i;
+                        micro(aij, lda, tmp, mb);
+                        if (i != j) micro(aji, lda, aij, lda);
+                        for (int r = 0; r < mb; ++r)
+                            std::copy(tmp + r * mb, tmp + (r + 1) * mb, aji + r * lda);
+                    }
+            } else {
+                for (int i = i0; i < i1; ++i)
+                    for (int j = std::max(j0, i + 1); j < j1; ++j)
+                        std::swap(a[i * lda + j], a[j * lda + i]);
+            }
+        }
+    };
+
+    if (static_cast<long long>(n) * n < transpose_parallel_threshold) {
+        for (int ti = 0; ti < tiles; ++ti) tile_row(ti);
+    } else {
+        parallel_for(0, tiles, 1, [&](int t0, int t1) {
+            for (int ti = t0; ti < t1; ++ti) tile_row(ti);
+        });
+    }
+
+    // A mikroblokkokból kimaradt szél: minden (i, j), j >= n_main, i < j
+    if (micro)
+        for (int j = n_main; j < n; ++j)
+            for (int i = 0; i < j; ++i)
+                std::swap(a[i * lda + j], a[j * lda + i]);
+}
+
+} // namespace matrix_kernels
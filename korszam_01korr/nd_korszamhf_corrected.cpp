@@ -1,5 +1,7 @@
 #include <iostream>
 #include <cmath>
+#include "../elso_hf/quadrature.h"
+#include "../elso_hf/romberg.h"
 
 const double correct_int_value_for_p16=1.346387956803450; // Wolframalpha-rol
 
@@ -9,32 +11,16 @@ double func(double x_f) {
 	return func_value;
 }
 
-// Simpson's rule
+// Simpson's rule (see ../elso_hf/simpson.h)
 double integrate(int n, double x0, double x1) {
-    if (n % 2 != 0) {  
-        ++n;
-    }
-
-    double dx = (x1 - x0) / n;
-    double int_value = func(x0) + func(x1);
-
-    for (int i = 1; i < n; i += 2) {
-        int_value += 4 * func(x0 + i * dx);
-    }
-
-    for (int i = 2; i < n - 1; i += 2) {
-        int_value += 2 * func(x0 + i * dx);
-    }
-
-    int_value *= dx / 3.0;
-    return int_value;
+    return integrate([](double x) { return func(x); }, x0, x1, static_cast<long long>(n));
 }
 
 void precision_checker(int n, int s, double x0_input, double x1_input, double d_p) {
     double x=n;
     while (x<s+1) {
-        double integral_value = integrate(n, x0_input, x1_input);
-        double diff_percent = abs(integral_value-correct_int_value_for_p16)/correct_int_value_for_p16;
+        double integral_value = integrate(static_cast<int>(x), x0_input, x1_input);
+        double diff_percent = std::abs(integral_value-correct_int_value_for_p16)/correct_int_value_for_p16;
         if (diff_percent < d_p) {
             std::cout << "n=" << x << " estén OK, kisebb mint " << d_p << " eltérés! (" <<diff_percent << ")"  << std::endl;
         }
@@ -45,11 +31,42 @@ void precision_checker(int n, int s, double x0_input, double x1_input, double d_
             
     }
 }
+// Adaptive quadrature for the same relative tolerance: only as many evaluations as needed
+void adaptive_checker(double x0_input, double x1_input, double d_p) {
+    QuadratureOptions opt;
+    opt.abs_tol = 0.0;
+    opt.rel_tol = d_p;
+    auto report = [](const char* name, QuadratureResult const& r) {
+        double diff_percent = std::abs(r.value-correct_int_value_for_p16)/correct_int_value_for_p16;
+        std::cout << name << r.value << ", becsült hiba " << r.error
+                  << ", valódi relatív eltérés " << diff_percent << ", " << r.evaluations << " kiértékelés"
+                  << (r.converged ? "" : " (NEM érte el a pontosságot)") << std::endl;
+    };
+    report("adaptív Simpson: ", adaptive_simpson(func, x0_input, x1_input, opt));
+    report("G7K15: ", gauss_kronrod(func, x0_input, x1_input, opt));
+}
 
-
+// Convergence study with Romberg: every tolerance continues from the previous
+// level, so the evaluation count is cumulative (each node computed once)
+void romberg_checker(double x0_input, double x1_input) {
+    Romberg r(func, x0_input, x1_input);
+    QuadratureOptions opt;
+    opt.abs_tol = 0.0;
+    for (double d_p = 1e-3; d_p > 1e-14; d_p /= 100) {
+        opt.rel_tol = d_p;
+        QuadratureResult res = r.integrate_to(opt);
+        double diff_percent = std::abs(res.value-correct_int_value_for_p16)/correct_int_value_for_p16;
+        std::cout << "Romberg " << d_p << " pontossággal: " << res.value << ", n=" << res.intervals
+                  << ", valódi relatív eltérés " << diff_percent << ", összesen " << res.evaluations << " kiértékelés"
+                  << (res.converged ? "" : " (NEM érte el a pontosságot)") << std::endl;
+    }
+}
 
 int main() {
 	std::cout.precision(16);
     precision_checker(10, 10000000, -1, 3, 0.001);
+    adaptive_checker(-1, 3, 0.001);
+    adaptive_checker(-1, 3, 1e-12);
+    romberg_checker(-1, 3);
     return 0;
 }
\ No newline at end of file
@@ -1,15 +1,22 @@
 // az #ifndef #define és #endif header guard helyett:
 #pragma once
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <limits>
+#include <type_traits>
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#endif
 
 template<typename T>
 struct Vector2 {
     T x, y;
 
-    Vector2() : x(0), y(0) {}
-    Vector2(T x_, T y_) : x(x_), y(y_) {}
+    constexpr Vector2() : x(0), y(0) {}
+    constexpr Vector2(T x_, T y_) : x(x_), y(y_) {}
 
     // Összeadás értékadó változata
     Vector2<T>& operator+=(const Vector2<T>& v) {
@@ -82,16 +89,62 @@ T sqlength(const Vector2<T>& v) {
     return dot(v, v);
 }
 
+/*
+ Hossz és normalizálás pontossága, hívási helyenként választható:
+   precise: std::sqrt és osztás (kerekítési hibán belül pontos)
+   fast:    reciprok-gyök közelítés (rsqrt, ~12 bit) és egy Newton-lépés,
+            relatív hiba legfeljebb fast_rsqrt_rel_error; osztás nincs
+ A gyors út float és double elemre működik (double-nél a közelítés float-
+ ban készül, így csak kb. 1e-19 < |v| < 1e19 között érvényes), más
+ típusra a pontos út fut.
+*/
+enum class Precision { precise, fast };
+
+// A gyors út relatív hibakorlátja: 1.5 * (1.5 * 2^-12)^2 a Newton-lépés után, plusz kerekítés
+constexpr double fast_rsqrt_rel_error = 4e-7;
+
+namespace vector2_detail {
+
+// 1 / sqrt(s) közelítése, s > 0
+inline float rsqrt_approx(float s) {
+#if defined(__SSE__) || defined(_M_X64)
+    return _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(s)));
+#else
+    return 1.0f / std::sqrt(s);
+#endif
+}
+
+// 1 / sqrt(s) egy Newton-lépéssel: r * (1.5 - 0.5 * s * r^2)
+// s-et a float normál tartományába szorítjuk, így s = 0-ra is véges (nullvektor marad nulla)
+template<typename T>
+T rsqrt_fast(T s) {
+    s = std::min(std::max(s, static_cast<T>(std::numeric_limits<float>::min())),
+                 static_cast<T>(std::numeric_limits<float>::max()));
+    T r = static_cast<T>(rsqrt_approx(static_cast<float>(s)));
+    return r * (T(1.5) - T(0.5) * s * r * r);
+}
+
+} // namespace vector2_detail
+
 // Hossz
 template<typename T>
-T length(const Vector2<T>& v) {
+T length(const Vector2<T>& v, Precision p = Precision::precise) {
+    if constexpr (std::is_floating_point_v<T>)
+        if (p == Precision::fast) {
+            T s = sqlength(v);
+            return s * vector2_detail::rsqrt_fast(s);
+        }
     return std::sqrt(sqlength(v));
 }
 
-// Normalizálás
+// Normalizálás; a nullvektorból nullvektor lesz (NaN helyett)
 template<typename T>
-Vector2<T> normalize(const Vector2<T>& v) {
-    return v / length(v);
+Vector2<T> normalize(const Vector2<T>& v, Precision p = Precision::precise) {
+    if constexpr (std::is_floating_point_v<T>)
+        if (p == Precision::fast)
+            return v * vector2_detail::rsqrt_fast(sqlength(v));
+    T len = length(v);
+    return len > T(0) ? v / len : Vector2<T>();
 }
 
 // Kiíró operátor
@@ -0,0 +1,611 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <initializer_list>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "vector2.h"
+#include "../harmadik-hf/pool_allocator.h"
+#include "../harmadik-hf/simd_kernels.h"
+
+/*
+ Sok Vector2 "tömbök struktúrájaként" (SoA): Vector2Array<T>
+
+ A Vector2<T> tömbje (AoS) x, y, x, y, ... sorrendben tárol, és minden
+ művelet elemenkénti skalár hívás. Itt az x és az y koordináták külön,
+ 64 bájtra igazított tömbben vannak, így egy vektorregiszter W darab
+ pont azonos koordinátáját tölti be egyszerre:
+
+   Vector2Array<double> p(pontok.data(), pontok.size());  // AoS -> SoA
+   p += eltolas;  p *= 2.0;
+   auto d = length(p);  auto b = bounds(p);  auto c = centroid(p);
+   auto u = normalize(p, Precision::fast);                // ~4e-7 relatív hiba
+
+ A Vector2Span<T> másolás nélküli nézet: vagy két külön tömbre (SoA,
+ stride 1), vagy egy Vector2<T> tömbre (AoS, stride 2). Minden szabad
+ függvény nézetet kap, így a meglévő Vector2 tömbökön átalakítás nélkül
+ is hívhatók; AoS nézetnél a kernelek veremre tett blokkokon dolgoznak.
+
+ A vektoros kernelek (dot, length, normalize, összeg, min/max) a
+ simd_kernels.h szintjeit használják (SSE2 / AVX2 / AVX-512, futásidejű
+ választás), a float és double elemre; más típus skalárisan fut. A hossz
+ és a normalizálás pontossága hívásonként választható (Precision, lásd
+ vector2.h): a gyors út reciprok-gyök közelítéssel, osztás nélkül fut.
+*/
+
+// Befoglaló téglalap
+template<typename T>
+struct Vector2Bounds {
+    Vector2<T> min, max;
+};
+
+// Másolás nélküli nézet: i. pont = (x[i * stride], y[i * stride])
+template<typename T>
+class Vector2Span {
+public:
+    using value_type = std::remove_const_t<T>;
+
+private:
+    static_assert(sizeof(Vector2<value_type>) == 2 * sizeof(value_type) &&
+                  std::is_standard_layout_v<Vector2<value_type>>,
+                  "Vector2<T> must be two tightly packed coordinates");
+
+    T* x_ = nullptr;
+    T* y_ = nullptr;
+    std::size_t size_ = 0;
+    std::size_t stride_ = 1;
+
+public:
+    Vector2Span() = default;
+
+    // Két külön koordinátatömb (SoA)
+    Vector2Span(T* x, T* y, std::size_t n) : x_(x), y_(y), size_(n) {}
+
+    // Vector2 tömb (AoS), másolás nélkül
+    template<typename V, typename = std::enable_if_t<
+        std::is_same_v<std::remove_const_t<V>, Vector2<value_type>> &&
+        (std::is_const_v<T> || !std::is_const_v<V>)>>
+    Vector2Span(V* p, std::size_t n)
+        : x_(p ? &p->x : nullptr), y_(p ? &p->y : nullptr), size_(n), stride_(2) {}
+
+    // Írható nézetből csak olvasható
+    template<typename U, typename = std::enable_if_t<std::is_same_v<T, U const>>>
+    Vector2Span(Vector2Span<U> const& o)
+        : x_(o.x_data()), y_(o.y_data()), size_(o.size()), stride_(o.stride()) {}
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    std::size_t stride() const { return stride_; }
+    bool contiguous() const { return stride_ == 1; }
+
+    T* x_data() const { return x_; }
+    T* y_data() const { return y_; }
+
+    Vector2<value_type> operator[](std::size_t i) const {
+        return Vector2<value_type>(x_[i * stride_], y_[i * stride_]);
+    }
+
+    template<typename U = T, typename = std::enable_if_t<!std::is_const_v<U>>>
+    void set(std::size_t i, Vector2<value_type> const& v) const {
+        x_[i * stride_] = v.x;
+        y_[i * stride_] = v.y;
+    }
+};
+
+namespace vector2_kernels {
+
+// AoS nézetnél ennyi pontot bontunk ki egyszerre a veremre
+constexpr std::size_t aos_block = 256;
+
+template<typename T>
+inline void dot_scalar(T const* ax, T const* ay, T const* bx, T const* by, T* out,
+                       std::size_t i0, std::size_t n) {
+    for (std::size_t i = i0; i < n; ++i) out[i] = ax[i] * bx[i] + ay[i] * by[i];
+}
+
+// A hossz reciproka a kért pontossággal; s = 0-ra véges (a nullvektor nulla marad)
+template<typename T>
+inline T inv_length(T s, Precision p) {
+    if constexpr (std::is_floating_point_v<T>)
+        if (p == Precision::fast) return vector2_detail::rsqrt_fast(s);
+    return s > T(0) ? T(1) / static_cast<T>(std::sqrt(s)) : T(0);
+}
+
+template<typename T>
+inline void length_scalar(T const* x, T const* y, T* out, std::size_t i0, std::size_t n, Precision p) {
+    for (std::size_t i = i0; i < n; ++i) {
+        T s = x[i] * x[i] + y[i] * y[i];
+        out[i] = p == Precision::fast ? s * inv_length(s, p) : static_cast<T>(std::sqrt(s));
+    }
+}
+
+template<typename T>
+inline void normalize_scalar(T const* x, T const* y, T* ox, T* oy, std::size_t i0, std::size_t n,
+                             Precision p) {
+    for (std::size_t i = i0; i < n; ++i) {
+        T inv = inv_length(x[i] * x[i] + y[i] * y[i], p);
+        ox[i] = x[i] * inv;
+        oy[i] = y[i] * inv;
+    }
+}
+
+template<typename T>
+inline T sum_scalar(T const* x, std::size_t i0, std::size_t n) {
+    T s{};
+    for (std::size_t i = i0; i < n; ++i) s += x[i];
+    return s;
+}
+
+// mn és mx már tartalmaz kezdőértéket
+template<typename T>
+inline void minmax_scalar(T const* x, std::size_t i0, std::size_t n, T& mn, T& mx) {
+    for (std::size_t i = i0; i < n; ++i) {
+        mn = x[i] < mn ? x[i] : mn;
+        mx = mx < x[i] ? x[i] : mx;
+    }
+}
+
+#ifdef MATRIX_X86_DISPATCH
+
+/*
+ A ciklustörzs minden szinten azonos, csak a target attribútum más
+ (mint simd_kernels.h-ban). Normalizáláskor a két koordináta a hossz
+ reciprokával szorzódik: a pontos úton ez egy gyökvonás és egy osztás,
+ a gyorsan V::rsqrt és egy Newton-lépés (r * (1.5 - 0.5 * s * r^2)),
+ gyök és osztás nélkül. A négyzetes hosszt alulról korlátozzuk (pontos
+ úton a legkisebb pozitív, gyors úton a float normál tartományára), így
+ a nullvektorból NaN helyett nulla lesz. Az összegzés két akkumulátorral
+ fut, hogy az összeadás késleltetése ne korlátozza, a sávokat a végén
+ adjuk össze.
+*/
+#define VECTOR2_DEFINE_LOOPS(SUFFIX, TARGET)                                           \
+    template<typename V, typename T>                                                   \
+    TARGET void dot_##SUFFIX(T const* ax, T const* ay, T const* bx, T const* by,       \
+                             T* out, std::size_t n) {                                  \
+        constexpr std::size_t W = V::width;                                            \
+        std::size_t i = 0;                                                             \
+        for (; i + W <= n; i += W) {                                                   \
+            typename V::reg yy = V::mul(V::load(ay + i), V::load(by + i));             \
+            if constexpr (V::has_fma)                                                  \
+                V::store(out + i, V::fmadd(V::load(ax + i), V::load(bx + i), yy));     \
+            else                                                                       \
+                V::store(out + i, V::add(V::mul(V::load(ax + i), V::load(bx + i)), yy)); \
+        }                                                                              \
+        dot_scalar(ax, ay, bx, by, out, i, n);                                         \
+    }                                                                                  \
+                                                                                       \
+    template<typename V, typename T>                                                   \
+    TARGET typename V::reg rsqrt_newton_##SUFFIX(typename V::reg s) {                  \
+        s = V::min(V::max(s, V::set1(std::numeric_limits<float>::min())),              \
+                   V::set1(std::numeric_limits<float>::max()));                        \
+        typename V::reg r = V::rsqrt(s);                                               \
+        typename V::reg h = V::mul(V::mul(V::set1(T(0.5)), s), V::mul(r, r));          \
+        return V::mul(r, V::sub(V::set1(T(1.5)), h));                                  \
+    }                                                                                  \
+                                                                                       \
+    template<typename V, typename T>                                                   \
+    TARGET void length_##SUFFIX(T const* x, T const* y, T* out, std::size_t n, Precision p) { \
+        constexpr std::size_t W = V::width;                                            \
+        std::size_t i = 0;                                                             \
+        if (p == Precision::fast) {                                                    \
+            for (; i + W <= n; i += W) {                                               \
+                typename V::reg vx = V::load(x + i), vy = V::load(y + i);              \
+                typename V::reg s = V::add(V::mul(vx, vx), V::mul(vy, vy));            \
+                V::store(out + i, V::mul(s, rsqrt_newton_##SUFFIX<V, T>(s)));          \
+            }                                                                          \
+        } else {                                                                       \
+            for (; i + W <= n; i += W) {                                               \
+                typename V::reg vx = V::load(x + i), vy = V::load(y + i);              \
+                V::store(out + i, V::sqrt(V::add(V::mul(vx, vx), V::mul(vy, vy))));    \
+            }                                                                          \
+        }                                                                              \
+        length_scalar(x, y, out, i, n, p);                                             \
+    }                                                                                  \
+                                                                                       \
+    template<typename V, typename T>                                                   \
+    TARGET void normalize_##SUFFIX(T const* x, T const* y, T* ox, T* oy, std::size_t n, \
+                                   Precision p) {                                      \
+        constexpr std::size_t W = V::width;                                            \
+        typename V::reg tiny = V::set1(std::numeric_limits<T>::denorm_min());          \
+        std::size_t i = 0;                                                             \
+        for (; i + W <= n; i += W) {                                                   \
+            typename V::reg vx = V::load(x + i), vy = V::load(y + i);                  \
+            typename V::reg s = V::add(V::mul(vx, vx), V::mul(vy, vy));                \
+            typename V::reg inv = p == Precision::fast                                 \
+                ? rsqrt_newton_##SUFFIX<V, T>(s)                                       \
+                : V::div(V::set1(T{1}), V::sqrt(V::max(s, tiny)));                     \
+            V::store(ox + i, V::mul(vx, inv));                                         \
+            V::store(oy + i, V::mul(vy, inv));                                         \
+        }                                                                              \
+        normalize_scalar(x, y, ox, oy, i, n, p);                                       \
+    }                                                                                  \
+                                                                                       \
+    template<typename V, typename T>                                                   \
+    TARGET T sum_##SUFFIX(T const* x, std::size_t n) {                                 \
+        constexpr std::size_t W = V::width;                                            \
+        typename V::reg s0 = V::set1(T{}), s1 = s0;                                    \
+        std::size_t i = 0;                                                             \
+        for (; i + 2 * W <= n; i += 2 * W) {                                           \
+            s0 = V::add(s0, V::load(x + i));                                           \
+            s1 = V::add(s1, V::load(x + i + W));                                       \
+        }                                                                              \
+        for (; i + W <= n; i += W) s0 = V::add(s0, V::load(x + i));                    \
+        alignas(64) T lanes[W];                                                        \
+        V::store(lanes, V::add(s0, s1));                                               \
+        return sum_scalar(lanes, 0, W) + sum_scalar(x, i, n);                          \
+    }                                                                                  \
+                                                                                       \
+    template<typename V, typename T>                                                   \
+    TARGET void minmax_##SUFFIX(T const* x, std::size_t n, T& mn, T& mx) {             \
+        constexpr std::size_t W = V::width;                                            \
+        typename V::reg vmn = V::set1(mn), vmx = V::set1(mx);                          \
+        std::size_t i = 0;                                                             \
+        for (; i + W <= n; i += W) {                                                   \
+            typename V::reg v = V::load(x + i);                                        \
+            vmn = V::min(vmn, v);                                                      \
+            vmx = V::max(vmx, v);                                                      \
+        }                                                                              \
+        alignas(64) T lo[W], hi[W];                                                    \
+        V::store(lo, vmn);                                                             \
+        V::store(hi, vmx);                                                             \
+        minmax_scalar(lo, 0, W, mn, mx);                                               \
+        minmax_scalar(hi, 0, W, mn, mx);                                               \
+        minmax_scalar(x, i, n, mn, mx);                                                \
+    }
+
+VECTOR2_DEFINE_LOOPS(sse2, MATRIX_TARGET_SSE2)
+VECTOR2_DEFINE_LOOPS(avx2, MATRIX_TARGET_AVX2)
+VECTOR2_DEFINE_LOOPS(avx512, MATRIX_TARGET_AVX512)
+
+#undef VECTOR2_DEFINE_LOOPS
+
+#endif // MATRIX_X86_DISPATCH
+
+template<typename T>
+constexpr bool simd_coordinate_type() {
+    return std::is_same_v<T, float> || std::is_same_v<T, double>;
+}
+
+// Futásidejű választás: NAME(args) a simd_level() szerinti változattal, különben FALLBACK
+#ifdef MATRIX_X86_DISPATCH
+#define VECTOR2_DISPATCH(T, NAME, FALLBACK, ...)                                        \
+    do {                                                                               \
+        if constexpr (simd_coordinate_type<T>()) {                                     \
+            switch (simd_level()) {                                                    \
+            case SimdLevel::avx512: return NAME##_avx512<matrix_kernels::avx512_vec<T>>(__VA_ARGS__); \
+            case SimdLevel::avx2: return NAME##_avx2<matrix_kernels::avx2_vec<T>>(__VA_ARGS__); \
+            case SimdLevel::sse2: return NAME##_sse2<matrix_kernels::sse2_vec<T>>(__VA_ARGS__); \
+            default: break;                                                            \
+            }                                                                          \
+        }                                                                              \
+        return FALLBACK;                                                               \
+    } while (0)
+#else
+#define VECTOR2_DISPATCH(T, NAME, FALLBACK, ...) return FALLBACK
+#endif
+
+template<typename T>
+void dot(T const* ax, T const* ay, T const* bx, T const* by, T* out, std::size_t n) {
+    VECTOR2_DISPATCH(T, dot, dot_scalar(ax, ay, bx, by, out, 0, n), ax, ay, bx, by, out, n);
+}
+
+template<typename T>
+void length(T const* x, T const* y, T* out, std::size_t n, Precision p) {
+    VECTOR2_DISPATCH(T, length, length_scalar(x, y, out, 0, n, p), x, y, out, n, p);
+}
+
+template<typename T>
+void normalize(T const* x, T const* y, T* ox, T* oy, std::size_t n, Precision p) {
+    VECTOR2_DISPATCH(T, normalize, normalize_scalar(x, y, ox, oy, 0, n, p), x, y, ox, oy, n, p);
+}
+
+template<typename T>
+T sum(T const* x, std::size_t n) {
+    VECTOR2_DISPATCH(T, sum, sum_scalar(x, 0, n), x, n);
+}
+
+template<typename T>
+void minmax(T const* x, std::size_t n, T& mn, T& mx) {
+    VECTOR2_DISPATCH(T, minmax, minmax_scalar(x, 0, n, mn, mx), x, n, mn, mx);
+}
+
+#undef VECTOR2_DISPATCH
+
+/*
+ A nézet bejárása folytonos darabokban: f(x, y, eltolás, darabszám)
+ SoA nézetnél egyetlen hívás a saját tömbökkel, AoS nézetnél aos_block
+ méretű darabok, veremre kibontva. Ha write igaz, a (módosított)
+ darab visszakerül a nézetbe.
+*/
+template<bool Write, typename T, typename F>
+void for_each_block(Vector2Span<T> s, F&& f) {
+    using V = std::remove_const_t<T>;
+    if (s.contiguous()) {
+        f(s.x_data(), s.y_data(), std::size_t{0}, s.size());
+        return;
+    }
+    alignas(64) V bx[aos_block];
+    alignas(64) V by[aos_block];
+    T* px = s.x_data();
+    T* py = s.y_data();
+    std::size_t st = s.stride();
+    for (std::size_t i0 = 0; i0 < s.size(); i0 += aos_block) {
+        std::size_t m = std::min(aos_block, s.size() - i0);
+        for (std::size_t k = 0; k < m; ++k) {
+            bx[k] = px[(i0 + k) * st];
+            by[k] = py[(i0 + k) * st];
+        }
+        f(bx, by, i0, m);
+        if constexpr (Write)
+            for (std::size_t k = 0; k < m; ++k) {
+                px[(i0 + k) * st] = bx[k];
+                py[(i0 + k) * st] = by[k];
+            }
+    }
+}
+
+} // namespace vector2_kernels
+
+template<typename T>
+class Vector2Array {
+public:
+    // Pontonkénti skalár eredmények (dot, length) tárolója
+    using scalar_vector = std::vector<T, default_matrix_allocator<T>>;
+
+private:
+    scalar_vector x_, y_;
+
+    void check_size(std::size_t n) const {
+        if (n != size()) throw std::runtime_error("Vector2 array size mismatch");
+    }
+
+public:
+    Vector2Array() = default;
+
+    explicit Vector2Array(std::size_t n, Vector2<T> const& v = Vector2<T>())
+        : x_(n, v.x), y_(n, v.y) {}
+
+    Vector2Array(std::initializer_list<Vector2<T>> list)
+        : Vector2Array(Vector2Span<T const>(list.begin(), list.size())) {}
+
+    // Másolat egy nézetből (pl. AoS -> SoA átalakítás)
+    explicit Vector2Array(Vector2Span<T const> s) : x_(s.size()), y_(s.size()) {
+        vector2_kernels::for_each_block<false>(s, [&](T const* x, T const* y, std::size_t i0, std::size_t m) {
+            std::copy(x, x + m, x_.data() + i0);
+            std::copy(y, y + m, y_.data() + i0);
+        });
+    }
+
+    Vector2Array(Vector2<T> const* p, std::size_t n) : Vector2Array(Vector2Span<T const>(p, n)) {}
+
+    std::size_t size() const { return x_.size(); }
+    bool empty() const { return x_.empty(); }
+
+    void resize(std::size_t n, Vector2<T> const& v = Vector2<T>()) {
+        x_.resize(n, v.x);
+        y_.resize(n, v.y);
+    }
+
+    void push_back(Vector2<T> const& v) {
+        x_.push_back(v.x);
+        y_.push_back(v.y);
+    }
+
+    T* x_data() { return x_.data(); }
+    T* y_data() { return y_.data(); }
+    T const* x_data() const { return x_.data(); }
+    T const* y_data() const { return y_.data(); }
+
+    Vector2<T> operator[](std::size_t i) const { return Vector2<T>(x_[i], y_[i]); }
+
+    void set(std::size_t i, Vector2<T> const& v) {
+        x_[i] = v.x;
+        y_[i] = v.y;
+    }
+
+    Vector2Span<T> span() { return Vector2Span<T>(x_.data(), y_.data(), size()); }
+    Vector2Span<T const> span() const { return Vector2Span<T const>(x_.data(), y_.data(), size()); }
+
+    operator Vector2Span<T const>() const { return span(); }
+
+    // Vissza AoS-ba (out legalább size() elemű)
+    void to_aos(Vector2<T>* out) const {
+        for (std::size_t i = 0; i < size(); ++i) out[i] = Vector2<T>(x_[i], y_[i]);
+    }
+
+    std::vector<Vector2<T>> to_vector() const {
+        std::vector<Vector2<T>> v(size());
+        to_aos(v.data());
+        return v;
+    }
+
+    // Pontonkénti összeadás és kivonás (o lehet AoS nézet is)
+    Vector2Array& operator+=(Vector2Span<T const> o) {
+        check_size(o.size());
+        vector2_kernels::for_each_block<false>(o, [&](T const* x, T const* y, std::size_t i0, std::size_t m) {
+            matrix_kernels::simd_add(x_.data() + i0, x, m);
+            matrix_kernels::simd_add(y_.data() + i0, y, m);
+        });
+        return *this;
+    }
+
+    Vector2Array& operator-=(Vector2Span<T const> o) {
+        check_size(o.size());
+        vector2_kernels::for_each_block<false>(o, [&](T const* x, T const* y, std::size_t i0, std::size_t m) {
+            matrix_kernels::simd_sub(x_.data() + i0, x, m);
+            matrix_kernels::simd_sub(y_.data() + i0, y, m);
+        });
+        return *this;
+    }
+
+    // Eltolás minden pontra ugyanazzal a vektorral
+    Vector2Array& operator+=(Vector2<T> const& v) {
+        matrix_kernels::simd_dispatch([&] {
+            T* __restrict x = x_.data();
+            T* __restrict y = y_.data();
+            for (std::size_t i = 0; i < size(); ++i) {
+                x[i] += v.x;
+                y[i] += v.y;
+            }
+        });
+        return *this;
+    }
+
+    Vector2Array& operator-=(Vector2<T> const& v) { return *this += Vector2<T>(-v.x, -v.y); }
+
+    Vector2Array& operator*=(T const& scalar) {
+        matrix_kernels::simd_scale(x_.data(), scalar, size());
+        matrix_kernels::simd_scale(y_.data(), scalar, size());
+        return *this;
+    }
+
+    Vector2Array& operator/=(T const& scalar) {
+        matrix_kernels::simd_div(x_.data(), scalar, size());
+        matrix_kernels::simd_div(y_.data(), scalar, size());
+        return *this;
+    }
+
+    // Minden pont egységhosszúra (a nullvektorok nullák maradnak, mint normalize-nál)
+    Vector2Array& normalize_inplace(Precision p = Precision::precise) {
+        vector2_kernels::normalize(x_.data(), y_.data(), x_.data(), y_.data(), size(), p);
+        return *this;
+    }
+
+    friend Vector2Array operator+(Vector2Array a, Vector2Span<T const> b) { return a += b; }
+    friend Vector2Array operator-(Vector2Array a, Vector2Span<T const> b) { return a -= b; }
+    friend Vector2Array operator+(Vector2Array a, Vector2<T> const& v) { return a += v; }
+    friend Vector2Array operator-(Vector2Array a, Vector2<T> const& v) { return a -= v; }
+    friend Vector2Array operator*(Vector2Array a, T const& scalar) { return a *= scalar; }
+    friend Vector2Array operator*(T const& scalar, Vector2Array a) { return a *= scalar; }
+    friend Vector2Array operator/(Vector2Array a, T const& scalar) { return a /= scalar; }
+};
+
+/*
+ Pontonkénti és összesítő műveletek nézeteken (SoA és AoS egyaránt);
+ Vector2Array-re a lenti túlterhelések a nézetét adják tovább.
+*/
+
+// Skaláris szorzatok: out[i] = dot(a[i], b[i])
+template<typename T, typename U>
+typename Vector2Array<std::remove_const_t<T>>::scalar_vector dot(Vector2Span<T> a, Vector2Span<U> b) {
+    using V = std::remove_const_t<T>;
+    static_assert(std::is_same_v<V, std::remove_const_t<U>>, "dot: coordinate types differ");
+    if (a.size() != b.size()) throw std::runtime_error("Vector2 array size mismatch");
+    typename Vector2Array<V>::scalar_vector out(a.size());
+    if (a.contiguous() && b.contiguous()) {
+        vector2_kernels::dot<V>(a.x_data(), a.y_data(), b.x_data(), b.y_data(), out.data(), a.size());
+        return out;
+    }
+    // Vegyes elrendezés: b-t egyszer SoA-ba másoljuk, a-t darabonként bontjuk ki
+    Vector2Array<V> bb{Vector2Span<V const>(b)};
+    vector2_kernels::for_each_block<false>(a, [&](V const* x, V const* y, std::size_t i0, std::size_t m) {
+        vector2_kernels::dot<V>(x, y, bb.x_data() + i0, bb.y_data() + i0, out.data() + i0, m);
+    });
+    return out;
+}
+
+// Hossznégyzetek
+template<typename T>
+typename Vector2Array<std::remove_const_t<T>>::scalar_vector sqlength(Vector2Span<T> a) {
+    using V = std::remove_const_t<T>;
+    typename Vector2Array<V>::scalar_vector out(a.size());
+    vector2_kernels::for_each_block<false>(a, [&](V const* x, V const* y, std::size_t i0, std::size_t m) {
+        vector2_kernels::dot<V>(x, y, x, y, out.data() + i0, m);
+    });
+    return out;
+}
+
+// Hosszak
+template<typename T>
+typename Vector2Array<std::remove_const_t<T>>::scalar_vector length(Vector2Span<T> a, Precision p = Precision::precise) {
+    using V = std::remove_const_t<T>;
+    typename Vector2Array<V>::scalar_vector out(a.size());
+    vector2_kernels::for_each_block<false>(a, [&](V const* x, V const* y, std::size_t i0, std::size_t m) {
+        vector2_kernels::length<V>(x, y, out.data() + i0, m, p);
+    });
+    return out;
+}
+
+// Egységvektorok új tömbben
+template<typename T>
+Vector2Array<std::remove_const_t<T>> normalize(Vector2Span<T> a, Precision p = Precision::precise) {
+    using V = std::remove_const_t<T>;
+    Vector2Array<V> out(a.size());
+    vector2_kernels::for_each_block<false>(a, [&](V const* x, V const* y, std::size_t i0, std::size_t m) {
+        vector2_kernels::normalize<V>(x, y, out.x_data() + i0, out.y_data() + i0, m, p);
+    });
+    return out;
+}
+
+// Egységvektorok helyben (pl. közvetlenül egy Vector2 tömbön)
+template<typename T, typename = std::enable_if_t<!std::is_const_v<T>>>
+void normalize_inplace(Vector2Span<T> a, Precision p = Precision::precise) {
+    vector2_kernels::for_each_block<true>(a, [&](T* x, T* y, std::size_t, std::size_t m) {
+        vector2_kernels::normalize<T>(x, y, x, y, m, p);
+    });
+}
+
+// A pontok összege
+template<typename T>
+Vector2<std::remove_const_t<T>> sum(Vector2Span<T> a) {
+    using V = std::remove_const_t<T>;
+    Vector2<V> s;
+    vector2_kernels::for_each_block<false>(a, [&](V const* x, V const* y, std::size_t, std::size_t m) {
+        s.x += vector2_kernels::sum<V>(x, m);
+        s.y += vector2_kernels::sum<V>(y, m);
+    });
+    return s;
+}
+
+// Befoglaló téglalap (üres nézetre kivétel)
+template<typename T>
+Vector2Bounds<std::remove_const_t<T>> bounds(Vector2Span<T> a) {
+    using V = std::remove_const_t<T>;
+    if (a.empty()) throw std::runtime_error("Empty Vector2 array");
+    Vector2Bounds<V> b{a[0], a[0]};
+    vector2_kernels::for_each_block<false>(a, [&](V const* x, V const* y, std::size_t, std::size_t m) {
+        vector2_kernels::minmax<V>(x, m, b.min.x, b.max.x);
+        vector2_kernels::minmax<V>(y, m, b.min.y, b.max.y);
+    });
+    return b;
+}
+
+// Súlypont (üres nézetre kivétel)
+template<typename T>
+Vector2<std::remove_const_t<T>> centroid(Vector2Span<T> a) {
+    using V = std::remove_const_t<T>;
+    if (a.empty()) throw std::runtime_error("Empty Vector2 array");
+    return sum(a) / static_cast<V>(a.size());
+}
+
+template<typename T>
+typename Vector2Array<T>::scalar_vector dot(Vector2Array<T> const& a, Vector2Array<T> const& b) {
+    return dot(a.span(), b.span());
+}
+
+template<typename T>
+typename Vector2Array<T>::scalar_vector sqlength(Vector2Array<T> const& a) { return sqlength(a.span()); }
+
+template<typename T>
+typename Vector2Array<T>::scalar_vector length(Vector2Array<T> const& a, Precision p = Precision::precise) {
+    return length(a.span(), p);
+}
+
+template<typename T>
+Vector2Array<T> normalize(Vector2Array<T> const& a, Precision p = Precision::precise) {
+    return normalize(a.span(), p);
+}
+
+template<typename T>
+Vector2<T> sum(Vector2Array<T> const& a) { return sum(a.span()); }
+
+template<typename T>
+Vector2Bounds<T> bounds(Vector2Array<T> const& a) { return bounds(a.span()); }
+
+template<typename T>
+Vector2<T> centroid(Vector2Array<T> const& a) { return centroid(a.span()); }